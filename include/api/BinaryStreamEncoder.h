@@ -0,0 +1,91 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+#include <vector>
+
+// Qt includes
+#include <QByteArray>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+
+///
+/// Encoder of the binary streaming format for LED colors and preview images, sent as WebSocket binary messages
+/// to subscribers which selected the format "binary" or "binary-delta".
+///
+/// Every message starts with an 8 byte header (multi-byte values in network byte order):
+///
+///   0  uint8   Type: 1 = LED colors, 2 = LED colors delta, 3 = JPEG image
+///   1  uint8   Instance (255 = none)
+///   2  uint16  Sequence number, counted per stream: LED colors and LED colors delta share one counter,
+///              JPEG images have their own. A gap tells the client that a message was dropped.
+///   4  uint32  LED colors: number of LEDs; image: width (upper 16 bits) and height (lower 16 bits)
+///
+/// followed by the payload:
+///
+///   LED colors:       the RGB bytes of all LEDs
+///   LED colors delta: runs of changed LEDs against the previous frame, each as uint16 first LED,
+///                     uint16 number of LEDs and their RGB bytes
+///   JPEG image:       the JPEG file data
+///
+/// A delta encoder sends a complete frame first, after a change of the number of LEDs and periodically,
+/// so that clients can resynchronise.
+///
+class BinaryStreamEncoder
+{
+public:
+	enum MessageType : uint8_t
+	{
+		LED_COLORS = 1,
+		LED_COLORS_DELTA = 2,
+		IMAGE_JPEG = 3
+	};
+
+	static constexpr int HEADER_SIZE = 8;
+	static constexpr uint8_t NO_INSTANCE = 255;
+
+	/// Number of delta-encoded frames between two complete frames
+	static constexpr int KEYFRAME_INTERVAL = 50;
+
+	///
+	/// @param[in] isDeltaEncoding Encode the LED colors as runs of changed LEDs
+	///
+	explicit BinaryStreamEncoder(bool isDeltaEncoding = false);
+
+	///
+	/// @brief Encodes the LED colors, delta-encoded if enabled and smaller than the complete frame
+	/// @param[in] ledColors The LED colors
+	/// @param[in] instance The instance the colors belong to
+	/// @return The message
+	///
+	QByteArray encodeLedColors(const std::vector<ColorRgb>& ledColors, uint8_t instance);
+
+	///
+	/// @brief Encodes a JPEG image
+	/// @param[in] jpegData The JPEG file data
+	/// @param[in] width The width of the image
+	/// @param[in] height The height of the image
+	/// @param[in] instance The instance the image belongs to
+	/// @return The message
+	///
+	QByteArray encodeImage(const QByteArray& jpegData, int width, int height, uint8_t instance);
+
+	///
+	/// @brief Forgets the previous frame, the next LED colors are encoded completely
+	///
+	void reset();
+
+private:
+	static void writeHeader(char* data, MessageType type, uint8_t instance, uint16_t sequence, uint32_t value);
+
+	/// Appends the delta of the LED colors to the message, returns false if larger than a complete frame
+	bool appendDelta(const std::vector<ColorRgb>& ledColors, QByteArray& message) const;
+
+	bool _isDeltaEncoding;
+	std::vector<ColorRgb> _previousLedColors;
+	int _framesSinceKeyframe;
+	/// Sequence of the LED colors messages, complete and delta-encoded ones alike
+	uint16_t _ledSequence;
+	uint16_t _imageSequence;
+};
@@ -229,6 +229,15 @@ private:
 	///
 	void handleLedColorsCommand(const QJsonObject &message, const JsonApiCommand& cmd);
 
+	///
+	/// @brief Apply the stream format requested by a subscription (optional "format" parameter)
+	///
+	/// @param message the incoming message
+	/// @param errorDetails Error details, if the format is not supported
+	/// @return True, if no format was requested or the format was applied
+	///
+	bool applyStreamFormat(const QJsonObject& message, QStringList& errorDetails);
+
 	/// Handle an incoming JSON Logging message
 	///
 	/// @param message the incoming message
@@ -2,6 +2,7 @@
 
 #include "api/JsonApiSubscription.h"
 #include <api/API.h>
+#include <api/BinaryStreamEncoder.h>
 #include <events/EventEnum.h>
 
 // qt incl
@@ -15,6 +16,7 @@
 #include <utils/settings.h>
 #include <hyperion/AuthManager.h>
 #include <hyperion/PriorityMuxer.h>
+#include <hyperion/PreviewEncoder.h>
 
 class Hyperion;
 class ComponentRegister;
@@ -89,6 +91,19 @@ public:
 	///
 	void setSubscriptionsTo(quint8 instanceID);
 
+	///
+	/// @brief Enable the binary streaming formats, to be called by transports able to send binary messages
+	/// @param isSupported True, if binary messages are supported
+	///
+	void setBinaryStreamingSupported(bool isSupported);
+
+	///
+	/// @brief Set the format of the LED color and image streams
+	/// @param format   "json" (default), "binary" or "binary-delta" (see BinaryStreamEncoder)
+	/// @return         True on success, false if the format is unknown or not supported by the transport
+	///
+	bool setStreamFormat(const QString& format);
+
 signals:
 	///
 	/// @brief Emits whenever a new json mesage callback is ready to send
@@ -96,6 +111,12 @@ signals:
 	///
 	void callbackReady(QJsonObject);
 
+	///
+	/// @brief Emits whenever a new binary stream message is ready to send
+	/// @param The binary message
+	///
+	void binaryCallbackReady(QByteArray);
+
 private slots:
 	///
 	/// @brief handle component state changes
@@ -163,10 +184,10 @@ private slots:
 	void handleLedColorUpdate(const std::vector<ColorRgb> &ledColors);
 
 	///
-	/// @brief Is called whenever the current Hyperion instance pushes new image update (if enabled)
-	/// @param image  The current image
+	/// @brief Is called whenever the preview encoder of the current Hyperion instance pushes a new image (if enabled)
+	/// @param image  The encoded current image
 	///
-	void handleImageUpdate(const Image<ColorRgb> &image);
+	void handleImageUpdate(const PreviewImagePtr &image);
 
 	///
 	/// @brief Process and push new log messages from logger (if enabled)
@@ -212,4 +233,13 @@ private:
 
 	/// flag to determine state of log streaming
 	bool _islogMsgStreamingActive;
+
+	/// Can the transport send binary messages?
+	bool _isBinaryStreamingSupported;
+
+	/// Are the LED colors and images streamed as binary messages?
+	bool _isBinaryStreaming;
+
+	/// Encoder of the binary LED color and image messages
+	BinaryStreamEncoder _streamEncoder;
 };
@@ -61,6 +61,11 @@ namespace hyperion
 
 		uint8_t calculateThreshold(double blackborderThreshold) const;
 
+		///
+		/// @return The threshold [0 .. 255] all color channels of a black pixel are below
+		///
+		uint8_t threshold() const { return _blackborderThreshold; }
+
 		///
 		/// default detection mode (3lines 4side detection)
 		template <typename Pixel_T>
@@ -2,6 +2,7 @@
 #define BLACK_BORDER_PROCESSOR_H
 
 #include <memory>
+#include <type_traits>
 
 // QT includes
 #include <QJsonObject>
@@ -13,6 +14,7 @@
 
 // Local Hyperion includes
 #include "BlackBorderDetector.h"
+#include <hyperion/ImageAnalysisCache.h>
 
 class Hyperion;
 
@@ -77,15 +79,18 @@ namespace hyperion
 				return true;
 			}
 
-			if (_detectionMode == "default") {
-				imageBorder = _detector->process(image);
-			} else if (_detectionMode == "classic") {
-				imageBorder = _detector->process_classic(image);
-			} else if (_detectionMode == "osd") {
-				imageBorder = _detector->process_osd(image);
-			} else if (_detectionMode == "letterbox") {
-				imageBorder = _detector->process_letterbox(image);
+			if constexpr (std::is_same<Pixel_T, ColorRgb>::value)
+			{
+				// Instances processing the same frame with the same detector settings share the detection
+				imageBorder = ImageAnalysisCache::getInstance().getBlackBorder(image, _detectionMode, _detector->threshold(), [&]() {
+					return detectBorder(image);
+				});
+			}
+			else
+			{
+				imageBorder = detectBorder(image);
 			}
+
 			// add blur to the border
 			if (imageBorder.horizontalSize > 0)
 			{
@@ -116,6 +121,29 @@ namespace hyperion
 		/// Hyperion instance
 		Hyperion* _hyperion;
 
+		///
+		/// Detects the black border of a single image using the configured detection mode
+		///
+		/// @param image The image to process
+		///
+		/// @return The border detected in the image
+		///
+		template <typename Pixel_T>
+		BlackBorder detectBorder(const Image<Pixel_T> & image) const
+		{
+			BlackBorder imageBorder {false, 0, 0};
+			if (_detectionMode == "default") {
+				imageBorder = _detector->process(image);
+			} else if (_detectionMode == "classic") {
+				imageBorder = _detector->process_classic(image);
+			} else if (_detectionMode == "osd") {
+				imageBorder = _detector->process_osd(image);
+			} else if (_detectionMode == "letterbox") {
+				imageBorder = _detector->process_letterbox(image);
+			}
+			return imageBorder;
+		}
+
 		///
 		/// Updates the current border based on the newly detected border. Returns true if the
 		/// current border has changed.
@@ -15,6 +15,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/VideoMode.h>
 #include <utils/Logger.h>
+#include <utils/FramedReader.h>
 
 #include <flatbuffers/flatbuffers.h>
 
@@ -142,8 +143,8 @@ private:
 	/// Host port
 	uint16_t _port;
 
-	/// buffer for reply
-	QByteArray _receiveBuffer;
+	/// reader of the replies
+	FramedReader _replyReader;
 
 	QTimer _timer;
 	Logger * _log;
@@ -1,8 +1,16 @@
 #ifndef ENCODERTHREAD_H
 #define ENCODERTHREAD_H
 
+// STL includes
+#include <deque>
+#include <map>
+#include <vector>
+
 // Qt includes
 #include <QThread>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
 
 // util includes
 #include <utils/PixelFormat.h>
@@ -18,6 +26,7 @@
 #endif
 
 constexpr int DEFAULT_THREAD_COUNT {1};
+constexpr int DEFAULT_QUEUE_SIZE {2};
 
 /// Encoder thread for USB devices
 class EncoderThread : public QObject
@@ -27,23 +36,39 @@ public:
 	explicit EncoderThread();
 	~EncoderThread() override;
 
-	void setup(
+	///
+	/// @brief Lends a frame buffer to the encoder.
+	/// The frame is processed asynchronously in the encoder's thread. The buffer must stay valid and unchanged
+	/// until frameProcessed() is emitted.
+	///
+	void lend(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
 		VideoMode videoMode, FlipMode flipMode, int pixelDecimation);
 
-	void process();
-
-	bool isBusy() { return _busy; }
-	QAtomicInt _busy = false;
+	Q_INVOKABLE void process();
 
 signals:
 	void newFrame(const Image<ColorRgb>& data);
 
+	///
+	/// @brief Emitted after each frame processed (after newFrame(), if the frame could be decoded).
+	/// A buffer lent via lend() is no longer used.
+	///
+	void frameProcessed();
+
 private:
+	void configure(
+		PixelFormat pixelFormat, int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation);
+
 	PixelFormat _pixelFormat;
+	/// Frame owned by the encoder (transformed MJPEG frame)
 	uint8_t* _localData;
+	/// Frame to be processed, either _localData or a lent buffer
+	uint8_t* _frameData;
 	int	_scalingFactorsCount;
 	int	_width;
 	int	_height;
@@ -92,7 +117,7 @@ public:
 
 	EncoderThread* thread() const { return qobject_cast<EncoderThread*>(_thread); }
 
-	void setup(
+	void lend(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
@@ -100,28 +125,12 @@ public:
 	{
 		auto encThread = qobject_cast<EncoderThread*>(_thread);
 		if (encThread != nullptr)
-			encThread->setup(pixelFormat, sharedData,
+			encThread->lend(pixelFormat, sharedData,
 				size, width, height, lineLength,
 				cropLeft, cropTop, cropBottom, cropRight,
 				videoMode, flipMode, pixelDecimation);
 	}
 
-	bool isBusy()
-	{
-		auto encThread = qobject_cast<EncoderThread*>(_thread);
-		if (encThread != nullptr)
-			return encThread->isBusy();
-
-		return true;
-	}
-
-	void process()
-	{
-		auto encThread = qobject_cast<EncoderThread*>(_thread);
-		if (encThread != nullptr)
-			encThread->process();
-	}
-
 protected:
 	void run() override
 	{
@@ -130,57 +139,110 @@ protected:
 	}
 };
 
+///
+/// @brief Decoding pipeline distributing the frames of a grabber to the encoder threads.
+///
+/// Frames submitted while all encoder threads are busy are queued, if the queue is full the oldest frame is dropped.
+/// As the encoder threads finish in any order, decoded frames are held back until all frames submitted before are done,
+/// i.e. newFrame() is emitted in capture order.
+///
 class EncoderThreadManager : public QObject
 {
     Q_OBJECT
 public:
-	explicit EncoderThreadManager(QObject *parent = nullptr)
-		: QObject(parent)
-		, _threadCount(qMax(QThread::idealThreadCount(), DEFAULT_THREAD_COUNT))
-		, _threads(nullptr)
-	{
-		_threads = new Thread<EncoderThread>*[_threadCount];
-		for (int i = 0; i < _threadCount; i++)
-		{
-			_threads[i] = new Thread<EncoderThread>(new EncoderThread, this);
-			_threads[i]->setObjectName("Encoder " + QString::number(i));
-		}
-	}
-
-	~EncoderThreadManager() override
-	{
-		if (_threads != nullptr)
-		{
-			for(int i = 0; i < _threadCount; i++)
-			{
-				_threads[i]->deleteLater();
-				_threads[i] = nullptr;
-			}
-
-			delete[] _threads;
-			_threads = nullptr;
-		}
-	}
-
-	void start()
-	{
-		if (_threads != nullptr)
-			for (int i = 0; i < _threadCount; i++)
-				connect(_threads[i]->thread(), &EncoderThread::newFrame, this, &EncoderThreadManager::newFrame);
-	}
+	explicit EncoderThreadManager(QObject *parent = nullptr);
+	~EncoderThreadManager() override;
+
+	void start();
+	void stop();
+
+	///
+	/// @brief Hands a frame to the decoding pipeline (thread-safe)
+	///
+	/// @param bufferIndex Index of the grabber's buffer lent to the pipeline. The buffer must stay valid until
+	///                    bufferReleased(bufferIndex) is emitted. If -1, the frame is copied.
+	/// @return False, if the pipeline is stopped and the frame was not taken
+	///
+	bool submit(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation,
+		int bufferIndex = -1);
 
-	void stop()
-	{
-		if (_threads != nullptr)
-			for(int  i = 0; i < _threadCount; i++)
-				disconnect(_threads[i]->thread(), nullptr, nullptr, nullptr);
-	}
+	///
+	/// @brief Blocks until no encoder thread reads a buffer lent via submit() any longer.
+	/// Call it after stop(), before the lent buffers are unmapped. Their bufferReleased() signals are still queued.
+	///
+	void waitForLentBuffers();
 
 	int _threadCount;
 	Thread<EncoderThread>**	_threads;
 
 signals:
 	void newFrame(const Image<ColorRgb>& data);
+
+	///
+	/// @brief Emitted, when a buffer lent via submit() is no longer used
+	///
+	void bufferReleased(int bufferIndex);
+
+private:
+	struct Job
+	{
+		PixelFormat pixelFormat;
+		uint8_t* data;
+		int size;
+		int width;
+		int height;
+		int lineLength;
+		int cropLeft;
+		int cropTop;
+		int cropBottom;
+		int cropRight;
+		VideoMode videoMode;
+		FlipMode flipMode;
+		int pixelDecimation;
+		/// Lent buffer of the grabber or -1
+		int bufferIndex;
+		/// Copy of a frame not lent
+		std::vector<uint8_t> storage;
+		/// Position in capture order, assigned when handed to an encoder thread
+		quint64 sequence;
+		/// The frame was decoded successfully
+		bool decoded;
+		Image<ColorRgb> image;
+	};
+
+	/// Hands the job over to an idle encoder thread (mutex locked)
+	void dispatch(int threadIndex, Job&& job);
+	/// Returns the job's buffer to the grabber or the storage to the free list (mutex locked)
+	void releaseJob(Job& job, QVector<int>& releasedBuffers);
+
+	void frameDecoded(int threadIndex, const Image<ColorRgb>& image);
+	void frameProcessed(int threadIndex);
+	/// Called in the encoder's thread, when it does not read the lent buffer any longer
+	void lentBufferDone(int threadIndex);
+
+	QMutex _mutex;
+	bool _running;
+
+	/// Frames waiting for an idle encoder thread
+	std::deque<Job> _queue;
+	/// Frame processed per encoder thread
+	std::vector<Job> _activeJobs;
+	std::vector<bool> _threadActive;
+	/// Encoder threads reading a lent buffer, counted in _lentBuffersInUse
+	std::vector<bool> _threadReadsLentBuffer;
+	int _lentBuffersInUse;
+	QWaitCondition _lentBuffersDone;
+	/// Frames processed, waiting for earlier frames to be finished
+	std::map<quint64, Job> _finishedJobs;
+	/// Reusable copy buffers
+	std::vector<std::vector<uint8_t>> _freeStorage;
+
+	quint64 _nextSequence;
+	quint64 _nextEmitSequence;
 };
 
 #endif //ENCODERTHREAD_H
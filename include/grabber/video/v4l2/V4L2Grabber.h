@@ -105,19 +105,27 @@ signals:
 private slots:
 	int read_frame();
 
+	///
+	/// @brief Queues a buffer lent to an encoder thread for capturing again
+	/// @param bufferIndex Index of the buffer released
+	///
+	void releaseBuffer(int bufferIndex);
+
 private:
 	bool init();
 	void uninit();
 	bool open_device();
 	void close_device();
 	void init_read(unsigned int buffer_size);
+	/// Number of capture buffers to request, buffers held by the encoder pipeline included
+	unsigned int captureBufferCount() const;
 	void init_mmap();
 	void init_userp(unsigned int buffer_size);
 	void init_device(VideoStandard videoStandard);
 	void uninit_device();
 	void start_capturing();
 	void stop_capturing();
-	bool process_image(const void *p, int size);
+	bool process_image(const void *p, int size, int bufferIndex = -1);
 	int xioctl(int request, void *arg);
 	int xioctl(int fileDescriptor, int request, void *arg);
 
@@ -143,6 +151,8 @@ private:
 	{
 			void   *start;
 			size_t  length;
+			/// The buffer is lent to an encoder thread and not queued for capturing
+			bool    lent;
 	};
 
 private:
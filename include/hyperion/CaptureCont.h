@@ -1,11 +1,16 @@
 #pragma once
 
+#include <atomic>
+
+#include <QSharedPointer>
+
 #include <utils/Logger.h>
 #include <utils/settings.h>
 #include <utils/Components.h>
 #include <utils/Image.h>
 
 class Hyperion;
+class PriorityMuxer;
 class QTimer;
 
 ///
@@ -38,23 +43,38 @@ private slots:
 	void handleSettingsUpdate(settings::type type, const QJsonDocument& config);
 
 	///
-	/// @brief forward screen image
+	/// @brief Post screen image to the priority's mailbox, called in the grabber's thread
 	/// @param image  The image
 	///
 	void handleScreenImage(const QString& name, const Image<ColorRgb>& image);
 
 	///
-	/// @brief forward video (v4l, MF) image
+	/// @brief Post video (v4l, MF) image to the priority's mailbox, called in the grabber's thread
 	/// @param image  The image
 	///
 	void handleVideoImage(const QString& name, const Image<ColorRgb> & image);
 
 	///
-	/// @brief forward audio image
+	/// @brief Post audio image to the priority's mailbox, called in the grabber's thread
 	/// @param image  The image
 	///
 	void handleAudioImage(const QString& name, const Image<ColorRgb>& image);
 
+	///
+	/// @brief Forward the latest posted screen image
+	///
+	void applyScreenImage();
+
+	///
+	/// @brief Forward the latest posted video (v4l, MF) image
+	///
+	void applyVideoImage();
+
+	///
+	/// @brief Forward the latest posted audio image
+	///
+	void applyAudioImage();
+
 	///
 	/// @brief Sets the video source to inactive
 	///
@@ -75,21 +95,24 @@ private:
 	/// Hyperion instance
 	Hyperion* _hyperion;
 
+	/// The instance's muxer, the images are posted to
+	QSharedPointer<PriorityMuxer> _muxer;
+
 	/// Reflect state of screen capture and prio
 	bool _screenCaptureEnabled;
-	int _screenCapturePriority;
+	std::atomic<int> _screenCapturePriority;
 	QString _screenCaptureName;
 	QTimer* _screenCaptureInactiveTimer;
 
 	/// Reflect state of video capture and prio
 	bool _videoCaptureEnabled;
-	int _videoCapturePriority;
+	std::atomic<int> _videoCapturePriority;
 	QString _videoCaptureName;
 	QTimer* _videoInactiveTimer;
 
 	/// Reflect state of audio capture and prio
 	bool _audioCaptureEnabled;
-	int _audioCapturePriority;
+	std::atomic<int> _audioCapturePriority;
 	QString _audioCaptureName;
 	QTimer* _audioCaptureInactiveTimer;
 };
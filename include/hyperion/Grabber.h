@@ -120,6 +120,31 @@ public:
 	///
 	virtual bool isAvailable(bool logError = true)  { return _isAvailable; }
 
+	///
+	/// @brief Counters of the video decoding pipeline, accumulated over all video grabbers
+	///
+	struct DecodingStatistics
+	{
+		/// Frames decoded and emitted
+		quint64 decodedFrames;
+		/// Frames dropped, as all decoders were busy and the queue was full
+		quint64 droppedFrames;
+		/// Frames decoded ahead of an earlier frame and held back to keep the capture order
+		quint64 reorderedFrames;
+	};
+
+	///
+	/// @brief Get the decoding pipeline counters
+	///
+	static DecodingStatistics getDecodingStatistics();
+
+	///
+	/// @brief Add to the decoding pipeline counters (thread-safe)
+	///
+	/// @param[in] statistics The counts to be added
+	///
+	static void addDecodingStatistics(const DecodingStatistics& statistics);
+
 public slots:
 
 	virtual void handleEvent(Event event) {}
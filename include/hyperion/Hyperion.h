@@ -33,6 +33,7 @@
 #include <hyperion/SettingsManager.h>
 #include <hyperion/CaptureCont.h>
 #include <hyperion/BGEffectHandler.h>
+#include <hyperion/PreviewEncoder.h>
 
 #include <leddevice/LedDeviceWrapper.h>
 #include <boblightserver/BoblightServer.h>
@@ -90,6 +91,21 @@ public:
 	unsigned addSmoothingConfig(int settlingTime_ms, double ledUpdateFrequency_hz=25.0, unsigned updateDelay=0);
 	unsigned updateSmoothingConfig(unsigned id, int settlingTime_ms=200, double ledUpdateFrequency_hz=25.0, unsigned updateDelay=0);
 
+	/// gets the output timing statistics of the smoothing (thread-safe)
+	QJsonObject getSmoothingStatistics() const;
+
+	/// gets the statistics of the frame handoff to the LED-device (thread-safe)
+	QJsonObject getLedDeviceStatistics() const;
+
+	/// gets the posted, coalesced and dropped input images per priority (thread-safe)
+	QJsonObject getInputImageStatistics() const;
+
+	/// gets the shared encoder of the preview image, subscribers connect to PreviewEncoder::previewImage
+	PreviewEncoder* getPreviewEncoder() const { return _previewEncoder.get(); }
+
+	/// gets the statistics of the preview image encoding (thread-safe)
+	QJsonObject getPreviewStatistics() const;
+
 	VideoMode getCurrentVideoMode() const;
 
 	///
@@ -150,6 +166,17 @@ public slots:
 	///
 	bool setInputImage(int priority, const Image<ColorRgb>& image, int64_t timeout_ms = PriorityMuxer::ENDLESS, bool clearEffect = true);
 
+	///
+	/// @brief   Post the current image of a priority from any thread (thread-safe)
+	/// 		 The image is placed into the priority's latest-frame mailbox and applied by setInputImage() in the instance thread.
+	/// 		 Images arriving while the instance is busy replace the pending one instead of queuing up.
+	/// @param  priority     The priority to update
+	/// @param  image        The new image
+	/// @param  timeout_ms   The new timeout (defaults to -1 endless)
+	/// @param  clearEffect  Should be true when NOT called from an effect
+	///
+	void postInputImage(int priority, const Image<ColorRgb>& image, int timeout_ms = PriorityMuxer::ENDLESS, bool clearEffect = true);
+
 	///
 	/// Writes a single color to all the leds for the given time and priority
 	/// Registers comp color or provided type against muxer
@@ -508,6 +535,26 @@ private slots:
 	///
 	void handleSourceAvailability(int priority);
 
+	///
+	/// @brief Apply the latest image posted to a priority's mailbox
+	///	@param priority   The priority
+	///
+	void applyPostedImage(int priority);
+
+	///
+	/// @brief Announce a clear to the mailboxes (thread-safe, called in the requesting thread)
+	///	@param priority       The priority channel, -1 for all priorities
+	///	@param forceClearAll  Force the clear
+	///
+	void requestClear(int priority, bool forceClearAll);
+
+	///
+	/// @brief Apply a clear announced by requestClear(), then the images posted after it was requested
+	///	@param priority       The priority channel, -1 for all priorities
+	///	@param forceClearAll  Force the clear
+	///
+	void applyRequestedClear(int priority, bool forceClearAll);
+
 private:
 
 	void updateLedColorAdjustment(int ledCount, const QJsonObject& colors);
@@ -528,8 +575,6 @@ private:
 	/// Image Processor
 	QSharedPointer<ImageProcessor> _imageProcessor;
 
-	std::vector<ColorOrder> _ledStringColorOrder;
-
 	/// The priority muxer
 	QSharedPointer<PriorityMuxer> _muxer;
 
@@ -561,6 +606,9 @@ private:
 	/// Capture control for Daemon native capture
 	QScopedPointer<CaptureCont,QScopedPointerDeleteLater> _captureCont;
 
+	/// Encodes the current image once for all preview subscribers
+	QScopedPointer<PreviewEncoder> _previewEncoder;
+
 	/// buffer for leds (with adjustment)
 	std::vector<ColorRgb> _ledBuffer;
 
@@ -0,0 +1,207 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Qt includes
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QThread>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/Image.h>
+
+// Black border includes
+#include <blackborder/BlackBorderDetector.h>
+
+///
+/// Cache of per-frame analysis results shared by all Hyperion instances.
+///
+/// Instances fed by the same grabber receive the same implicitly shared image. Results depending only on the
+/// frame and a few settings are computed by the first instance and reused by the others: the raw black-border
+/// detection per mode and threshold, the integral image and the mean color of the full frame.
+///
+/// Each instance processes its frames in its own thread and registers it as a consumer. A frame is identified by
+/// its pixel buffer and kept while it is the current frame of at least one consumer; it is dropped as soon as all
+/// of them moved on to a newer frame. Keeping a reference to the image ensures that the buffer can neither be
+/// freed and reused for another frame nor be modified in place meanwhile. With a single consumer there is nothing
+/// to share, the results are computed directly without caching.
+///
+class ImageAnalysisCache
+{
+public:
+	struct Statistics
+	{
+		/// Results reused from the cache
+		uint64_t hits;
+		/// Results computed
+		uint64_t misses;
+	};
+
+	///
+	/// @return The cache shared by all instances
+	///
+	static ImageAnalysisCache& getInstance();
+
+	///
+	/// Registers the calling thread as a consumer, i.e. the thread an instance processes its frames in
+	///
+	void addConsumer();
+
+	///
+	/// Unregisters the calling thread and releases the frame it processed last
+	///
+	void removeConsumer();
+
+	///
+	/// Returns the black border of the frame as detected by the given mode and threshold.
+	/// The detection runs once per frame and detector setting, further calls get the cached result.
+	///
+	/// @param[in] image The frame
+	/// @param[in] mode The detection mode
+	/// @param[in] threshold The black threshold of the detector
+	/// @param[in] detect Function detecting the border, if not cached yet
+	/// @return The detected border (without blur removal or consistency filtering)
+	///
+	template <typename Detect_T>
+	hyperion::BlackBorder getBlackBorder(const Image<ColorRgb>& image, const QString& mode, uint8_t threshold, Detect_T detect)
+	{
+		const std::shared_ptr<Frame> frame = findFrame(image);
+		if (frame == nullptr)
+		{
+			return detect();
+		}
+
+		QMutexLocker locker(&frame->mutex);
+		for (const BorderResult& result : frame->borders)
+		{
+			if (result.threshold == threshold && result.mode == mode)
+			{
+				++_hits;
+				return result.border;
+			}
+		}
+
+		++_misses;
+		const hyperion::BlackBorder border = detect();
+		frame->borders.push_back({mode, threshold, border});
+		return border;
+	}
+
+	///
+	/// Returns the integral image of the frame, built once per frame.
+	///
+	/// @param[in] image The frame
+	/// @param[in] build Function building the integral image and returning it, if not cached yet
+	/// @return The integral image
+	///
+	template <typename Build_T>
+	std::shared_ptr<const std::vector<uint32_t>> getIntegralImage(const Image<ColorRgb>& image, Build_T build)
+	{
+		const std::shared_ptr<Frame> frame = findFrame(image);
+		if (frame == nullptr)
+		{
+			return build();
+		}
+
+		QMutexLocker locker(&frame->mutex);
+		if (frame->integralImage != nullptr)
+		{
+			++_hits;
+			return frame->integralImage;
+		}
+
+		++_misses;
+		frame->integralImage = build();
+		return frame->integralImage;
+	}
+
+	///
+	/// Returns the mean color of the full frame, calculated once per frame.
+	///
+	/// @param[in] image The frame
+	/// @param[in] calculate Function calculating the mean color, if not cached yet
+	/// @return The mean color
+	///
+	template <typename Calculate_T>
+	ColorRgb getMeanColor(const Image<ColorRgb>& image, Calculate_T calculate)
+	{
+		const std::shared_ptr<Frame> frame = findFrame(image);
+		if (frame == nullptr)
+		{
+			return calculate();
+		}
+
+		QMutexLocker locker(&frame->mutex);
+		if (frame->meanColorValid)
+		{
+			++_hits;
+			return frame->meanColor;
+		}
+
+		++_misses;
+		frame->meanColor = calculate();
+		frame->meanColorValid = true;
+		return frame->meanColor;
+	}
+
+	///
+	/// @return The number of reused and computed results since start
+	///
+	Statistics statistics() const;
+
+private:
+	ImageAnalysisCache();
+
+	struct BorderResult
+	{
+		QString mode;
+		uint8_t threshold;
+		hyperion::BlackBorder border;
+	};
+
+	struct Frame
+	{
+		/// Reference to the frame, keeps its pixel buffer alive and unmodified
+		Image<ColorRgb> image;
+		/// Number of consumers currently processing the frame
+		int consumers = 0;
+		/// Guards the results, held while a result is computed so that it is computed only once
+		QMutex mutex;
+		std::vector<BorderResult> borders;
+		std::shared_ptr<const std::vector<uint32_t>> integralImage;
+		bool meanColorValid = false;
+		ColorRgb meanColor;
+	};
+
+	struct Consumer
+	{
+		QThread* thread;
+		/// The frame the consumer processes currently
+		std::shared_ptr<Frame> frame;
+	};
+
+	///
+	/// Returns the entry of the given frame and makes it the calling consumer's current frame.
+	/// The consumer's previous frame is dropped, if no other consumer processes it anymore.
+	///
+	/// @return The entry, null if the results are not shared (single consumer or unregistered thread)
+	///
+	std::shared_ptr<Frame> findFrame(const Image<ColorRgb>& image);
+
+	/// Releases the consumer's current frame (mutex locked)
+	void releaseFrame(Consumer& consumer);
+
+	QMutex _mutex;
+	std::vector<Consumer> _consumers;
+	/// The frames current at one consumer at least
+	std::vector<std::shared_ptr<Frame>> _frames;
+
+	std::atomic<uint64_t> _hits;
+	std::atomic<uint64_t> _misses;
+};
@@ -70,6 +70,12 @@ public:
 	/// @param[in] level  The accuracy level (0-4)
 	void setAccuracyLevel(int level);
 
+	///
+	/// Set the number of threads used to evaluate the LED areas
+	///
+	/// @param[in] threadCount  Number of threads (1 = process on the calling thread)
+	void setProcessingThreads(int threadCount);
+
 	/// Returns the current _userMappingType, this may not be the current applied type!
 	int getUserLedMappingType() const { return _userMappingType; }
 
@@ -290,6 +296,7 @@ private:
 
 	int _accuraryLevel;
 	int _reducedPixelSetFactorFactor;
+	int _processingThreads;
 
 	/// Hyperion instance pointer
 	Hyperion* _hyperion;
@@ -6,20 +6,26 @@
 #include <memory>
 #include <sstream>
 #include <cmath>
+#include <type_traits>
+#include <climits>
+#include <algorithm>
 
 // hyperion-utils includes
 #include <utils/Image.h>
 #include <utils/Logger.h>
 #include <utils/ColorRgbScalar.h>
 #include <utils/ColorSys.h>
+#include <utils/PixelSum.h>
 
 // hyperion includes
 #include <hyperion/LedString.h>
+#include <hyperion/ProcessingPool.h>
+#include <hyperion/ImageAnalysisCache.h>
 
 namespace hyperion
 {
 	///
-	/// The ImageToLedsMap holds a mapping of indices into an image to LEDs. It can be used to
+	/// The ImageToLedsMap holds a mapping of image areas to LEDs. It can be used to
 	/// calculate the average (aka mean) or dominant color per LED for a given region.
 	///
 	class ImageToLedsMap : public QObject
@@ -28,10 +34,14 @@ namespace hyperion
 
 	public:
 
+		/// Maximum deviation per channel (red, green, blue) of the dominant color calculated
+		/// on quantized colors from the most frequent color of an area (see DominantColorHistogram)
+		static constexpr uint8_t DOMINANT_COLOR_TOLERANCE[3] = { 7, 3, 7 };
+
 		///
-		/// Constructs an mapping from the absolute indices in an image to each LED based on the border
-		/// definition given in the list of LEDs. The map holds absolute indices to any given image,
-		/// provided that it is row-oriented.
+		/// Constructs an mapping from the areas in an image to each LED based on the border
+		/// definition given in the list of LEDs. The map holds a row-wise description of each area
+		/// (first pixel, rows, columns and strides), provided that the image is row-oriented.
 		/// The mapping is created purely on size (width and height). The given borders are excluded
 		/// from indexing.
 		///
@@ -78,6 +88,13 @@ namespace hyperion
 		/// @param[in] level  The accuracy level (0-4)
 		void setAccuracyLevel (int level);
 
+		///
+		/// Set the number of threads used to process the LED areas.
+		/// The LEDs are split into chunks of similar pixel counts, which are processed by the shared ProcessingPool.
+		///
+		/// @param[in] threadCount  The number of threads (<= 1 processes all LEDs on the calling thread)
+		void setProcessingThreads(int threadCount);
+
 		///
 		/// Determines the mean color for each LED using the LED area mapping given
 		/// at construction.
@@ -89,7 +106,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getMeanLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getMeanLedColor(image, colors);
 			return colors;
 		}
@@ -104,19 +121,29 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getMeanLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
-			// Iterate each led and compute the mean
 			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			if (_integralImageEnabled)
 			{
-				const ColorRgb color = calcMeanColor(image, *colors);
-				*led = color;
+				// Sum up the image once, then look up each led's area sum
+				const std::shared_ptr<const std::vector<uint32_t>> integralImage = getIntegralImage(image);
+				for (auto area = _meanAreas.begin(); area != _meanAreas.end(); ++area, ++led)
+				{
+					*led = calcMeanColorIntegral(integralImage->data(), *area);
+				}
+				return;
 			}
+
+			// Iterate each led and compute the mean
+			forEachLed([&](size_t idx, int /*chunk*/)
+			{
+				ledColors[idx] = calcMeanColor(image, _meanAreas[idx]);
+			});
 		}
 
 		///
@@ -130,7 +157,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getMeanSqrtLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getMeanSqrtLedColor(image, colors);
 			return colors;
 		}
@@ -145,19 +172,17 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getMeanSqrtLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
 			// Iterate each led and compute the mean
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			forEachLed([&](size_t idx, int /*chunk*/)
 			{
-				const ColorRgb color = calcMeanColorSqrt(image, *colors);
-				*led = color;
-			}
+				ledColors[idx] = calcMeanColorSqrt(image, _colorsAreas[idx]);
+			});
 		}
 
 		///
@@ -170,7 +195,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getUniLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getUniLedColor(image, colors);
 			return colors;
 		}
@@ -184,14 +209,22 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getUniLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
-			// calculate uni color
-			const ColorRgb color = calcMeanColor(image);
+			// calculate uni color, shared by all instances processing the same frame
+			ColorRgb color;
+			if constexpr (std::is_same<Pixel_T, ColorRgb>::value)
+			{
+				color = ImageAnalysisCache::getInstance().getMeanColor(image, [&]() { return calcMeanColor(image); });
+			}
+			else
+			{
+				color = calcMeanColor(image);
+			}
 			//Update all LEDs with same color
 			std::fill(ledColors.begin(),ledColors.end(), color);
 		}
@@ -207,7 +240,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getDominantLedColor(image, colors);
 			return colors;
 		}
@@ -223,19 +256,17 @@ namespace hyperion
 		void getDominantLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
 			// Sanity check for the number of LEDs
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
 			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			forEachLed([&](size_t idx, int chunk)
 			{
-				const ColorRgb color = calculateDominantColor(image, *colors);
-				*led = color;
-			}
+				ledColors[idx] = calculateDominantColor(image, _colorsAreas[idx], _dominantColorHistograms[chunk]);
+			});
 		}
 
 		///
@@ -248,7 +279,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantUniLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getDominantUniLedColor(image, colors);
 			return colors;
 		}
@@ -262,9 +293,9 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getDominantUniLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
@@ -285,7 +316,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantAdvLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getDominantAdvLedColor(image, colors);
 			return colors;
 		}
@@ -301,19 +332,17 @@ namespace hyperion
 		void getDominantAdvLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
 			// Sanity check for the number of LEDs
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
 			// Iterate each led and compute the dominant color
-			auto led = ledColors.begin();
-			for (auto colors = _colorsMap.begin(); colors != _colorsMap.end(); ++colors, ++led)
+			forEachLed([&](size_t idx, int /*chunk*/)
 			{
-				const ColorRgb color = calculateDominantColorAdv(image, *colors);
-				*led = color;
-			}
+				ledColors[idx] = calculateDominantColorAdv(image, _colorsAreas[idx], idx);
+			});
 		}
 
 		///
@@ -326,7 +355,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		std::vector<ColorRgb> getDominantAdvUniLedColor(const Image<Pixel_T> & image) const
 		{
-			std::vector<ColorRgb> colors(_colorsMap.size(), ColorRgb{0,0,0});
+			std::vector<ColorRgb> colors(_colorsAreas.size(), ColorRgb{0,0,0});
 			getDominantAdvUniLedColor(image, colors);
 			return colors;
 		}
@@ -340,9 +369,9 @@ namespace hyperion
 		template <typename Pixel_T>
 		void getDominantAdvUniLedColor(const Image<Pixel_T> & image, std::vector<ColorRgb> & ledColors) const
 		{
-			if(_colorsMap.size() != ledColors.size())
+			if(_colorsAreas.size() != ledColors.size())
 			{
-				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsMap.size(), ledColors.size());
+				Debug(_log, "ImageToLedsMap: colorsMap.size != ledColors.size -> %d != %d", _colorsAreas.size(), ledColors.size());
 				return;
 			}
 
@@ -370,45 +399,264 @@ namespace hyperion
 		/// Number of clusters used during dominant color advanced processing (k-means)
 		int _clusterCount;
 
-		/// The absolute indices into the image for each led
-		std::vector<std::vector<int>> _colorsMap;
+		/// Number of chunks the LEDs are split into for parallel processing
+		int _chunkCount;
+
+		/// Index of the first LED of each chunk (plus the end index)
+		std::vector<size_t> _chunkBoundaries;
+
+		///
+		/// Calls the given function for each LED index, in parallel if multiple chunks are configured.
+		/// Every LED is processed exactly once, so the result does not depend on the number of chunks.
+		///
+		/// @param[in] function The function to be called with the LED index and the chunk it belongs to
+		///
+		template <typename Function_T>
+		void forEachLed(Function_T function) const
+		{
+			if (_chunkCount <= 1)
+			{
+				for (size_t idx = 0; idx < _colorsAreas.size(); ++idx)
+				{
+					function(idx, 0);
+				}
+				return;
+			}
+
+			ProcessingPool::getInstance().run(_chunkCount, [&](int chunk)
+			{
+				for (size_t idx = _chunkBoundaries[chunk]; idx < _chunkBoundaries[chunk + 1]; ++idx)
+				{
+					function(idx, chunk);
+				}
+			});
+		}
+
+		///
+		/// Row oriented description of the (sub-sampled) image area of a LED
+		///
+		struct LedArea
+		{
+			/// Index of the first pixel of the area
+			int offset {0};
+			/// Number of rows to be evaluated
+			int rows {0};
+			/// Number of pixels to be evaluated per row
+			int columns {0};
+			/// Distance between two evaluated rows [pixels]
+			int rowStride {0};
+			/// Distance between two evaluated pixels of a row [pixels]
+			int columnStep {1};
+
+			int pixelCount() const { return rows * columns; }
+		};
+
+		/// The image area for each led
+		std::vector<LedArea> _colorsAreas;
+
+		/// The image area for each led used for the mean color, huge areas are not sub-sampled
+		std::vector<LedArea> _meanAreas;
+
+		/// Calculate the mean colors using an integral image (summed-area table)
+		bool _integralImageEnabled;
+
+		///
+		/// Returns the integral image of the given image. For RGB images it is taken from the analysis cache,
+		/// i.e. built only once per frame for all instances.
+		///
+		/// @param[in] image The image to be evaluated
+		///
+		/// @return The integral image: (width+1) x (height+1) entries of red, green and blue sums.
+		/// The sums wrap around, the difference of four entries is still correct for any area.
+		///
+		template <typename Pixel_T>
+		std::shared_ptr<const std::vector<uint32_t>> getIntegralImage(const Image<Pixel_T> & image) const
+		{
+			auto build = [&]() {
+				// Reuse the own buffer, unless another instance still refers to it as the result of a previous frame
+				if (_integralImage == nullptr || _integralImage.use_count() > 1)
+				{
+					_integralImage = std::make_shared<std::vector<uint32_t>>();
+				}
+				buildIntegralImage(image, *_integralImage);
+				return std::shared_ptr<const std::vector<uint32_t>>(_integralImage);
+			};
+
+			if constexpr (std::is_same<Pixel_T, ColorRgb>::value)
+			{
+				return ImageAnalysisCache::getInstance().getIntegralImage(image, build);
+			}
+			else
+			{
+				return build();
+			}
+		}
+
+		/// The integral image built by this instance, shared via the analysis cache
+		mutable std::shared_ptr<std::vector<uint32_t>> _integralImage;
+
+		///
+		/// Builds the integral image for the given image, i.e. each entry holds the color sums
+		/// of all pixels above and left of it.
+		///
+		/// @param[in] image The image to be evaluated
+		/// @param[out] integralImage The integral image (the buffer may be reused from another image)
+		///
+		template <typename Pixel_T>
+		void buildIntegralImage(const Image<Pixel_T> & image, std::vector<uint32_t> & integralImage) const
+		{
+			const size_t rowStride = static_cast<size_t>(_width + 1) * 3;
+
+			// The first row and column are zero
+			integralImage.resize(rowStride * static_cast<size_t>(_height + 1));
+			std::fill_n(integralImage.begin(), rowStride, 0);
+
+			const Pixel_T* pixel = image.memptr();
+			const uint32_t* previousRow = integralImage.data();
+			for (int y = 0; y < _height; ++y)
+			{
+				uint32_t* row = integralImage.data() + rowStride * static_cast<size_t>(y + 1);
+				row[0] = 0;
+				row[1] = 0;
+				row[2] = 0;
+				uint32_t rowRed   = 0;
+				uint32_t rowGreen = 0;
+				uint32_t rowBlue  = 0;
+				for (size_t idx = 3; idx < rowStride; idx += 3, ++pixel)
+				{
+					rowRed   += pixel->red;
+					rowGreen += pixel->green;
+					rowBlue  += pixel->blue;
+					row[idx]     = previousRow[idx]     + rowRed;
+					row[idx + 1] = previousRow[idx + 1] + rowGreen;
+					row[idx + 2] = previousRow[idx + 2] + rowBlue;
+				}
+				previousRow = row;
+			}
+		}
+
+		///
+		/// Calculates the 'mean color' of an area using the integral image of the current image
+		///
+		/// @param[in] integralImage The integral image of the current image
+		/// @param[in] area The image area to be evaluated (without sub-sampling)
+		///
+		/// @return The mean of the given area's colors (or black when empty)
+		///
+		ColorRgb calcMeanColorIntegral(const uint32_t* integralImage, const LedArea & area) const;
+
+		///
+		/// @param[in] image The image
+		/// @return The area covering the full image
+		///
+		template <typename Pixel_T>
+		static LedArea imageArea(const Image<Pixel_T> & image)
+		{
+			return {0, image.height(), image.width(), image.width(), 1};
+		}
+
+		///
+		/// Calls the given function for every pixel of the image area, row by row
+		///
+		/// @param[in] image The image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in] function The function to be called per pixel
+		///
+		template <typename Pixel_T, typename Function_T>
+		static void forEachPixel(const Image<Pixel_T> & image, const LedArea & area, Function_T function)
+		{
+			const Pixel_T* row = image.memptr() + area.offset;
+			const int rowLength = area.columns * area.columnStep;
+			for (int y = 0; y < area.rows; ++y, row += area.rowStride)
+			{
+				for (int x = 0; x < rowLength; x += area.columnStep)
+				{
+					function(row[x]);
+				}
+			}
+		}
+
+		///
+		/// Accumulates the (squared) sum of each color channel over the given image area.
+		/// Contiguous rows of RGB images are summed up using the vectorized PixelSum kernels.
+		///
+		/// @param[in] image The image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in] squared Sum up the squared channel values
+		/// @param[in,out] sums The red, green and blue sums
+		///
+		template <typename Pixel_T>
+		void sumArea(const Image<Pixel_T> & image, const LedArea & area, bool squared, uint64_t sums[3]) const
+		{
+			const Pixel_T* row = image.memptr() + area.offset;
+
+			if constexpr (std::is_same<Pixel_T, ColorRgb>::value)
+			{
+				if (area.columnStep == 1)
+				{
+					// Rows directly follow each other, e.g. the full image
+					const bool contiguous = (area.rowStride == area.columns);
+					const int runs = contiguous ? 1 : area.rows;
+					const int runLength = contiguous ? area.pixelCount() : area.columns;
+
+					for (int run = 0; run < runs; ++run, row += area.rowStride)
+					{
+						const uint8_t* rgb = reinterpret_cast<const uint8_t*>(row);
+						if (squared)
+						{
+							PixelSum::sumRgbSquared(rgb, runLength, sums);
+						}
+						else
+						{
+							PixelSum::sumRgb(rgb, runLength, sums);
+						}
+					}
+					return;
+				}
+			}
+
+			forEachPixel(image, area, [squared, sums](const Pixel_T& pixel) {
+				if (squared)
+				{
+					sums[0] += pixel.red * pixel.red;
+					sums[1] += pixel.green * pixel.green;
+					sums[2] += pixel.blue * pixel.blue;
+				}
+				else
+				{
+					sums[0] += pixel.red;
+					sums[1] += pixel.green;
+					sums[2] += pixel.blue;
+				}
+			});
+		}
 
 		///
 		/// Calculates the 'mean color' over the given image. This is the mean over each color-channel
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated///
+		/// @param[in] area The image area to be evaluated
 		///
-		/// @return The mean of the given list of colors (or black when empty)
+		/// @return The mean of the given area's colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColor(const Image<Pixel_T> & image, const std::vector<int32_t> & pixels) const
+		ColorRgb calcMeanColor(const Image<Pixel_T> & image, const LedArea & area) const
 		{
-			const auto pixelNum = pixels.size();
+			const uint64_t pixelNum = static_cast<uint64_t>(area.pixelCount());
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
 			}
 
 			// Accumulate the sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const auto& imgData = image.memptr();
-			for (const int pixelOffset : pixels)
-			{
-				const auto& pixel = imgData[pixelOffset];
-				cummRed   += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue  += pixel.blue;
-			}
+			uint64_t cumm[3] {0, 0, 0};
+			sumArea(image, area, false, cumm);
 
 			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(cummRed/pixelNum);
-			const uint8_t avgGreen = uint8_t(cummGreen/pixelNum);
-			const uint8_t avgBlue  = uint8_t(cummBlue/pixelNum);
+			const uint8_t avgRed   = uint8_t(cumm[0]/pixelNum);
+			const uint8_t avgGreen = uint8_t(cumm[1]/pixelNum);
+			const uint8_t avgBlue  = uint8_t(cumm[2]/pixelNum);
 
 			// Return the computed color
 			return {avgRed, avgGreen, avgBlue};
@@ -425,29 +673,7 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calcMeanColor(const Image<Pixel_T> & image) const
 		{
-			// Accumulate the sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const unsigned pixelNum = image.width() * image.height();
-			const auto& imgData = image.memptr();
-
-			for (unsigned idx=0; idx<pixelNum; idx++)
-			{
-				const auto& pixel = imgData[idx];
-				cummRed   += pixel.red;
-				cummGreen += pixel.green;
-				cummBlue  += pixel.blue;
-			}
-
-			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(cummRed/pixelNum);
-			const uint8_t avgGreen = uint8_t(cummGreen/pixelNum);
-			const uint8_t avgBlue  = uint8_t(cummBlue/pixelNum);
-
-			// Return the computed color
-			return {avgRed, avgGreen, avgBlue};
+			return calcMeanColor(image, imageArea(image));
 		}
 
 		///
@@ -455,43 +681,31 @@ namespace hyperion
 		/// (red, green, blue)
 		///
 		/// @param[in] image The image a section from which an average color must be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
 		///
-		/// @return The mean of the given list of colors (or black when empty)
+		/// @return The mean of the given area's colors (or black when empty)
 		///
 		template <typename Pixel_T>
-		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image, const std::vector<int32_t> & pixels) const
+		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image, const LedArea & area) const
 		{
-			const auto pixelNum = pixels.size();
+			const uint64_t pixelNum = static_cast<uint64_t>(area.pixelCount());
 			if (pixelNum == 0)
 			{
 				return ColorRgb::BLACK;
 			}
 
 			// Accumulate the squared sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
-
-			const auto& imgData = image.memptr();
-
-			for (const int colorOffset : pixels)
-			{
-				const auto& pixel = imgData[colorOffset];
-
-				cummRed   += pixel.red * pixel.red;
-				cummGreen += pixel.green * pixel.green;
-				cummBlue  += pixel.blue * pixel.blue;
-			}
+			uint64_t cumm[3] {0, 0, 0};
+			sumArea(image, area, true, cumm);
 
 			// Compute the average of each color channel
 
 			#ifdef WIN32
 				#undef min
 			#endif
-			const uint8_t avgRed = static_cast<uint8_t>(std::min(std::lround(std::sqrt(static_cast<double>(cummRed / pixelNum))), 255L));
-			const uint8_t avgGreen = static_cast<uint8_t>(std::min(std::lround(sqrt(static_cast<double>(cummGreen / pixelNum))), 255L));
-			const uint8_t avgBlue = static_cast<uint8_t>(std::min(std::lround(sqrt(static_cast<double>(cummBlue / pixelNum))), 255L));
+			const uint8_t avgRed = static_cast<uint8_t>(std::min(std::lround(std::sqrt(static_cast<double>(cumm[0] / pixelNum))), 255L));
+			const uint8_t avgGreen = static_cast<uint8_t>(std::min(std::lround(sqrt(static_cast<double>(cumm[1] / pixelNum))), 255L));
+			const uint8_t avgBlue = static_cast<uint8_t>(std::min(std::lround(sqrt(static_cast<double>(cumm[2] / pixelNum))), 255L));
 
 			// Return the computed color
 			return {avgRed, avgGreen, avgBlue};
@@ -508,69 +722,108 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calcMeanColorSqrt(const Image<Pixel_T> & image) const
 		{
-			// Accumulate the squared sum of each separate color channel
-			uint_fast32_t cummRed   = 0;
-			uint_fast32_t cummGreen = 0;
-			uint_fast32_t cummBlue  = 0;
+			return calcMeanColorSqrt(image, imageArea(image));
+		}
 
-			const unsigned pixelNum = image.width() * image.height();
-			const auto& imgData = image.memptr();
+		///
+		/// Histogram of colors quantized to 5-6-5 bits (red, green, blue) used to determine the dominant color.
+		/// The bins are allocated once; after evaluating an area only the bins touched are reset,
+		/// so no memory is allocated per area or frame.
+		///
+		/// The dominant color is the mean of the pixels falling into the most populated bin.
+		/// If the area's most frequent color falls into that bin, the result differs from it by
+		/// at most DOMINANT_COLOR_TOLERANCE per channel.
+		///
+		class DominantColorHistogram
+		{
+		public:
+			template <typename Pixel_T>
+			ColorRgb dominantColor(const Image<Pixel_T> & image, const LedArea & area)
+			{
+				if (_counts.empty())
+				{
+					_counts.resize(BIN_COUNT, 0);
+					_touchedBins.reserve(BIN_COUNT);
+				}
 
-			for (int idx=0; idx<pixelNum; ++idx)
+				// Count the pixels per bin, the first bin reaching the highest count wins
+				uint32_t dominantCount = 0;
+				uint16_t dominantBin = 0;
+				forEachPixel(image, area, [&](const Pixel_T& pixel)
+				{
+					const uint16_t colorBin = bin(pixel);
+					uint32_t& count = _counts[colorBin];
+					if (count == 0)
+					{
+						_touchedBins.push_back(colorBin);
+					}
+					if (++count > dominantCount)
+					{
+						dominantCount = count;
+						dominantBin = colorBin;
+					}
+				});
+
+				for (const uint16_t colorBin : _touchedBins)
+				{
+					_counts[colorBin] = 0;
+				}
+				_touchedBins.clear();
+
+				// Average the pixels of the dominant bin to undo the quantization
+				uint64_t sums[3] {0, 0, 0};
+				forEachPixel(image, area, [&](const Pixel_T& pixel)
+				{
+					if (bin(pixel) == dominantBin)
+					{
+						sums[0] += pixel.red;
+						sums[1] += pixel.green;
+						sums[2] += pixel.blue;
+					}
+				});
+
+				return {
+					static_cast<uint8_t>(sums[0] / dominantCount),
+					static_cast<uint8_t>(sums[1] / dominantCount),
+					static_cast<uint8_t>(sums[2] / dominantCount)
+				};
+			}
+
+		private:
+			static constexpr int BIN_COUNT = 1 << 16;
+
+			template <typename Pixel_T>
+			static uint16_t bin(const Pixel_T& pixel)
 			{
-				const auto& pixel = imgData[idx];
-				cummRed   += pixel.red * pixel.red;
-				cummGreen += pixel.green * pixel.green;
-				cummBlue  += pixel.blue * pixel.blue;
+				return static_cast<uint16_t>(((pixel.red >> 3) << 11) | ((pixel.green >> 2) << 5) | (pixel.blue >> 3));
 			}
 
-			// Compute the average of each color channel
-			const uint8_t avgRed   = uint8_t(std::lround(sqrt(static_cast<double>(cummRed/pixelNum))));
-			const uint8_t avgGreen = uint8_t(std::lround(sqrt(static_cast<double>(cummGreen/pixelNum))));
-			const uint8_t avgBlue  = uint8_t(std::lround(sqrt(static_cast<double>(cummBlue/pixelNum))));
+			/// Number of pixels per bin
+			std::vector<uint32_t> _counts;
+			/// Bins with a count > 0
+			std::vector<uint16_t> _touchedBins;
+		};
 
-			// Return the computed color
-			return {avgRed, avgGreen, avgBlue};
-		}
+		/// Histograms used for dominant color processing, one per processing chunk
+		mutable std::vector<DominantColorHistogram> _dominantColorHistograms;
 
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		/// Calculates the 'dominant color' of an image area
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in] histogram The histogram to be used (exclusively by the calling thread)
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColor(const Image<Pixel_T> & image, const std::vector<int> & pixels) const
+		ColorRgb calculateDominantColor(const Image<Pixel_T> & image, const LedArea & area, DominantColorHistogram & histogram) const
 		{
-			ColorRgb dominantColor {ColorRgb::BLACK};
-
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			if (area.pixelCount() == 0)
 			{
-				const auto& imgData = image.memptr();
-
-				QMap<QRgb,int> colorDistributionMap;
-				int count = 0;
-				for (const int pixelOffset : pixels)
-				{
-					QRgb color = imgData[pixelOffset].rgb();
-					if (colorDistributionMap.contains(color)) {
-						colorDistributionMap[color] = colorDistributionMap[color] + 1;
-					}
-					else  {
-						colorDistributionMap[color] = 1;
-					}
-
-					int colorsFound  =  colorDistributionMap[color];
-					if (colorsFound > count)  {
-						dominantColor.setRgb(color);
-						count = colorsFound;
-					}
-				}
+				return ColorRgb::BLACK;
 			}
-			return dominantColor;
+			return histogram.dominantColor(image, area);
 		}
 
 		///
@@ -583,26 +836,25 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calculateDominantColor(const Image<Pixel_T> & image) const
 		{
-			const unsigned pixelNum = image.width() * image.height();
-
-			std::vector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
-
-			return calculateDominantColor(image, pixels);
+			return calculateDominantColor(image, imageArea(image), _dominantColorHistograms[0]);
 		}
 
-		template <typename Pixel_T>
-		struct ColorCluster {
-
-			ColorCluster():count(0) {}
-			ColorCluster(Pixel_T color):count(0),color(color) {}
-
-			Pixel_T color;
-			Pixel_T newColor;
+		struct ColorCluster
+		{
+			/// Current center of the cluster
+			ColorRgbScalar color;
+			/// Sum of the colors assigned to the cluster
+			int64_t sum[3];
+			/// Number of colors assigned to the cluster
 			int count;
 		};
 
-		const ColorRgb DEFAULT_CLUSTER_COLORS[5] {
+		static constexpr int MAX_CLUSTER_COUNT = 5;
+
+		/// Maximum number of k-means iterations per area and frame
+		static constexpr int KMEANS_MAX_ITERATIONS = 8;
+
+		const ColorRgb DEFAULT_CLUSTER_COLORS[MAX_CLUSTER_COUNT] {
 			{ColorRgb::BLACK},
 			{ColorRgb::GREEN},
 			{ColorRgb::WHITE},
@@ -610,108 +862,122 @@ namespace hyperion
 			{ColorRgb::YELLOW}
 		};
 
+		/// Cluster centers of the last frame per LED (plus one set for the full image), _clusterCount centers each
+		mutable std::vector<ColorRgbScalar> _clusterCenters;
+		/// Per LED (plus the full image), if the cluster centers hold results of a previous frame
+		mutable std::vector<uint8_t> _clusterCentersValid;
+
+		///
+		/// Resets the cluster centers remembered from previous frames, e.g. on cluster count change
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
+		void resetClusterCenters();
+
+		///
+		/// Calculates the 'dominant color' of an image area
 		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
 		///
+		/// The clusters start from the centers of the previous frame (consecutive frames are mostly similar)
+		/// and the number of iterations is limited to KMEANS_MAX_ITERATIONS.
+		///
 		/// @param[in] image The image for which a dominant color is to be computed
-		/// @param[in] pixels The list of pixel indices for the given image to be evaluated
+		/// @param[in] area The image area to be evaluated
+		/// @param[in] centersIdx Index of the cluster centers remembered for the area
 		///
-		/// @return The image area's dominant color or black, if no pixel indices provided
+		/// @return The image area's dominant color or black, if the area is empty
 		///
 		template <typename Pixel_T>
-		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image, const std::vector<int> & pixels) const
+		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image, const LedArea & area, size_t centersIdx) const
 		{
 			ColorRgb dominantColor {ColorRgb::BLACK};
-			const auto pixelNum = pixels.size();
-			if (pixelNum > 0)
+			if (area.pixelCount() > 0)
 			{
-				// initial cluster with different colors
-				std::unique_ptr<ColorCluster<ColorRgbScalar>[]> clusters(new ColorCluster<ColorRgbScalar>[_clusterCount]);
+				ColorRgbScalar* centers = _clusterCenters.data() + centersIdx * static_cast<size_t>(_clusterCount);
+
+				// start with the last frame's clusters or with different colors
+				ColorCluster clusters[MAX_CLUSTER_COUNT];
 				for(int k = 0; k < _clusterCount; ++k)
 				{
-					clusters.get()[k].newColor = DEFAULT_CLUSTER_COLORS[k];
+					clusters[k].color = _clusterCentersValid[centersIdx] ? centers[k] : ColorRgbScalar(DEFAULT_CLUSTER_COLORS[k]);
 				}
 
 				// k-means
-				double min_rgb_euclidean {0};
-				double old_rgb_euclidean {0};
-
-				while(1)
+				for (int iteration = 0; iteration < KMEANS_MAX_ITERATIONS; ++iteration)
 				{
 					for(int k = 0; k < _clusterCount; ++k)
 					{
-						clusters.get()[k].count = 0;
-						clusters.get()[k].color = clusters.get()[k].newColor;
-						clusters.get()[k].newColor.setRgb(ColorRgb::BLACK);
+						clusters[k].count = 0;
+						clusters[k].sum[0] = clusters[k].sum[1] = clusters[k].sum[2] = 0;
 					}
 
-					const auto& imgData = image.memptr();
-					for (const int pixelOffset : pixels)
+					forEachPixel(image, area, [&](const Pixel_T& pixel)
 					{
-						const auto& pixel = imgData[pixelOffset];
-
-						min_rgb_euclidean = 255 * 255 * 255;
-						int clusterIndex = -1;
+						// assign the pixel to the nearest cluster (squared euclidean distance)
+						int minDistance = INT_MAX;
+						int clusterIndex = 0;
 						for(int k = 0; k < _clusterCount; ++k)
 						{
-							double euclid = ColorSys::rgb_euclidean(ColorRgbScalar(pixel), clusters.get()[k].color);
+							const int red   = pixel.red   - clusters[k].color.red;
+							const int green = pixel.green - clusters[k].color.green;
+							const int blue  = pixel.blue  - clusters[k].color.blue;
+							const int distance = red * red + green * green + blue * blue;
 
-							if(  euclid < min_rgb_euclidean ) {
-								min_rgb_euclidean = euclid;
+							if (distance < minDistance) {
+								minDistance = distance;
 								clusterIndex = k;
 							}
 						}
 
-						clusters.get()[clusterIndex].count++;
-						clusters.get()[clusterIndex].newColor += ColorRgbScalar(pixel);
-					}
+						ColorCluster& cluster = clusters[clusterIndex];
+						cluster.count++;
+						cluster.sum[0] += pixel.red;
+						cluster.sum[1] += pixel.green;
+						cluster.sum[2] += pixel.blue;
+					});
 
-					min_rgb_euclidean = 0;
+					// move the clusters to the mean of their colors, empty clusters stay
+					bool moved {false};
 					for(int k = 0; k < _clusterCount; ++k)
 					{
-						if (clusters.get()[k].count > 0)
+						if (clusters[k].count > 0)
 						{
-							// new color
-							clusters.get()[k].newColor /= clusters.get()[k].count;
-							double ecli = ColorSys::rgb_euclidean(clusters.get()[k].newColor, clusters.get()[k].color);
-							if(ecli > min_rgb_euclidean)
-							{
-								min_rgb_euclidean = ecli;
-							}
+							const ColorRgbScalar newColor(static_cast<int>(clusters[k].sum[0] / clusters[k].count),
+														  static_cast<int>(clusters[k].sum[1] / clusters[k].count),
+														  static_cast<int>(clusters[k].sum[2] / clusters[k].count));
+							moved = moved || newColor != clusters[k].color;
+							clusters[k].color = newColor;
 						}
 					}
 
-					if( fabs(min_rgb_euclidean - old_rgb_euclidean) < 1)
+					if (!moved)
 					{
 						break;
 					}
-
-					old_rgb_euclidean = min_rgb_euclidean;
 				}
 
 				int colorsFoundMax = 0;
 				int dominantClusterIdx {0};
 
 				for(int clusterIdx=0; clusterIdx < _clusterCount; ++clusterIdx){
-					int colorsFoundinCluster = clusters.get()[clusterIdx].count;
+					int colorsFoundinCluster = clusters[clusterIdx].count;
 					if (colorsFoundinCluster > colorsFoundMax)  {
 						colorsFoundMax = colorsFoundinCluster;
 						dominantClusterIdx = clusterIdx;
 					}
+					centers[clusterIdx] = clusters[clusterIdx].color;
 				}
+				_clusterCentersValid[centersIdx] = 1;
 
-				dominantColor.red = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.red);
-				dominantColor.green = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.green);
-				dominantColor.blue = static_cast<uint8_t>(clusters.get()[dominantClusterIdx].newColor.blue);
+				dominantColor.red = static_cast<uint8_t>(clusters[dominantClusterIdx].color.red);
+				dominantColor.green = static_cast<uint8_t>(clusters[dominantClusterIdx].color.green);
+				dominantColor.blue = static_cast<uint8_t>(clusters[dominantClusterIdx].color.blue);
 			}
 
 			return dominantColor;
 		}
 
 		///
-		/// Calculates the 'dominant color' of an image area defined by a list of pixel indices
-		/// using a k-means algorithm (https://robocraft.ru/computervision/1063)
+		/// Calculates the 'dominant color' of an image using a k-means algorithm
+		/// (https://robocraft.ru/computervision/1063)
 		///
 		/// @param[in] image The image for which a dominant color is to be computed
 		///
@@ -720,12 +986,8 @@ namespace hyperion
 		template <typename Pixel_T>
 		ColorRgb calculateDominantColorAdv(const Image<Pixel_T> & image) const
 		{
-			const unsigned pixelNum = image.width() * image.height();
-
-			std::vector<int> pixels(pixelNum);
-			std::iota(pixels.begin(), pixels.end(), 0);
-
-			return calculateDominantColorAdv(image, pixels);
+			// the full image's cluster centers are stored after the LEDs' ones
+			return calculateDominantColorAdv(image, imageArea(image), _colorsAreas.size());
 		}
 	};
 
@@ -2,6 +2,7 @@
 #define LINEARCOLORSMOOTHING_H
 
 // STL includes
+#include <atomic>
 #include <vector>
 #include <deque>
 
@@ -9,18 +10,20 @@
 #include <QVector>
 #include <QScopedPointer>
 #include <QSharedPointer>
+#include <QMutex>
+#include <QJsonObject>
 
 // hyperion includes
 #include <leddevice/LedDevice.h>
 #include <utils/Components.h>
+#include <utils/OutputScheduler.h>
+#include <utils/TripleBuffer.h>
 #include <hyperion/PriorityMuxer.h>
+#include <hyperion/SmoothingKernels.h>
 
 // settings
 #include <utils/settings.h>
 
-// The type of float
-#define floatT float // Select double, float or __fp16
-
 class QTimer;
 class Logger;
 class Hyperion;
@@ -71,6 +74,10 @@ enum SmoothingConfigID
 ///           the average color values to the 8-bit RGB resolution of the LED-device. Effectively,
 ///           this performs diffusion of the residual errors across multiple egress frames.
 ///
+/// By default, the smoothing runs on the instance's thread driven by a QTimer. Optionally, it runs on a
+/// dedicated output thread (OutputScheduler) with absolute deadlines, real-time priority and CPU affinity.
+/// The incoming frames are then handed over by a lock-free triple buffer, only the latest frame is taken
+/// per output tick. Configuration changes from the instance's thread are synchronized by _stateMutex.
 ///
 
 class LinearColorSmoothing : public QObject
@@ -129,6 +136,13 @@ public:
 	///
 	bool selectConfig(int cfgID, bool force = false);
 
+	///
+	/// @brief Get the statistics of the output thread (output timing jitter, coalesced input frames)
+	///
+	/// @return The statistics, thread-safe
+	///
+	QJsonObject getOutputStatistics() const;
+
 public slots:
 	///
 	/// @brief Handle settings update from Hyperion Settingsmanager emit or this constructor
@@ -181,6 +195,21 @@ private:
 
 	QString getConfig(int cfgID);
 
+	///
+	/// @brief Starts, restarts or stops the dedicated output thread
+	/// @param enable            Run the smoothing on the output thread instead of the instance's thread
+	/// @param realtimePriority  SCHED_FIFO priority of the thread, 0 for normal scheduling
+	/// @param cpuAffinity       The CPU core to bind the thread to, -1 for no binding
+	///
+	void updateOutputThread(bool enable, int realtimePriority, int cpuAffinity);
+
+	///
+	/// @brief Performs the smoothing on the output thread; takes the latest input frame and updates the LEDs
+	///
+	/// @return The period till the next output tick in microseconds
+	///
+	int64_t outputTick();
+
 	/// Helper to pipe configuration from constructor to start()
 	QJsonObject _smoothConfig;
 
@@ -202,6 +231,25 @@ private:
 	/// The Qt timer object
 	QScopedPointer<QTimer> _timer;
 
+	/// The dedicated output thread
+	QScopedPointer<OutputScheduler> _outputScheduler;
+
+	/// Whether the smoothing runs on the output thread
+	std::atomic<bool> _outputThreadActive;
+
+	/// The real-time priority and CPU affinity of the output thread
+	int _outputThreadPriority;
+	int _outputThreadCpu;
+
+	/// The input frames handed over to the output thread
+	TripleBuffer<std::vector<ColorRgb>> _inputFrames;
+
+	/// The number of input frames replaced by a newer one before the output thread took them
+	std::atomic<uint64_t> _coalescedFrames;
+
+	/// Guards the smoothing state against configuration changes while the output thread runs
+	QMutex _stateMutex;
+
 	/// The timestamp at which the target data should be fully applied
 	int64_t _targetTime;
 
@@ -223,29 +271,50 @@ private:
 	/// The output queue
 	std::deque<std::vector<ColorRgb>> _outputQueue;
 
-	/// A frame of led colors used for temporal smoothing
-	class REMEMBERED_FRAME
+	/// Ring buffer of the led color frames received during the smoothing window.
+	/// The frame buffers are preallocated and reused, the capacity only grows, if more frames arrive within the window.
+	class FrameHistory
 	{
-		public:
-		/// The time this frame was received
-		int64_t time;
+	public:
+		/// Removes all frames (the buffers are kept for reuse)
+		void clear();
+
+		/// Appends a frame at the back (newest)
+		///
+		/// @param time The time the frame was received
+		/// @param colors The led colors
+		void push(int64_t time, const std::vector<ColorRgb> &colors);
 
-		/// The led colors
-		std::vector<ColorRgb> colors;
+		/// Removes the frame at the front (oldest)
+		void pop();
 
-		REMEMBERED_FRAME ( REMEMBERED_FRAME && ) = default;
-		REMEMBERED_FRAME ( const REMEMBERED_FRAME & ) = default;
-		REMEMBERED_FRAME & operator= ( const REMEMBERED_FRAME & ) = default;
+		/// @return The number of frames
+		size_t size() const { return _size; }
 
-		REMEMBERED_FRAME(int64_t time, const std::vector<ColorRgb> colors)
-		: time(time)
-		, colors(colors)
-		{}
+		/// @param index The frame's index; 0 is the oldest
+		/// @return The time the frame was received
+		int64_t time(size_t index) const { return _times[slot(index)]; }
+
+		/// @param index The frame's index; 0 is the oldest
+		/// @return The led colors of the frame
+		const std::vector<ColorRgb> &colors(size_t index) const { return _colors[slot(index)]; }
+
+	private:
+		size_t slot(size_t index) const { return (_head + index) % _times.size(); }
+
+		std::vector<int64_t> _times;
+		std::vector<std::vector<ColorRgb>> _colors;
+		size_t _head = 0;
+		size_t _size = 0;
 	};
 
+	/// The ring buffer of temporarily remembered frames
+	FrameHistory _frameHistory;
 
-	/// The queue of temporarily remembered frames
-	std::deque<REMEMBERED_FRAME> _frameQueue;
+	/// The buffers and kernels for interpolation and dithering. For linear decay they hold the running sums of the
+	/// color components weighted by their display time (in microseconds). The sums cover all frames of the history,
+	/// except the oldest (clipped by the window) and the newest (still shown).
+	SmoothingKernels _kernels;
 
 	/// Flag for pausing
 	bool _pause;
@@ -265,6 +334,9 @@ private:
 	/// The decay power > 0. A value of exactly 1 is linear decay, higher numbers indicate a faster decay rate.
 	double _decay;
 
+	/// Whether linear decay is applied, which allows the incremental calculation of the moving average
+	bool _linearDecay;
+
 	/// Value of 1.0 / settlingTime; inverse of the window size used for weighting of frames.
 	floatT _invWindow;
 
@@ -323,22 +395,23 @@ private:
 	/// Frees the LED frames that were queued for calculating the moving average.
 	void clearRememberedFrames();
 
-	/// (Re-)Initializes the color-component vectors with given number of values.
+	/// Removes the frames from the history, that are no longer visible in the smoothing window.
+	/// The last frame starting before the window is kept, as it is still partially visible.
 	///
-	/// @param ledCount The number of colors.
-	void intitializeComponentVectors(size_t ledCount);
+	/// @param windowStart The start time of the smoothing window
+	void forgetOutdatedFrames(int64_t windowStart);
 
-	/// The number of led component-values that must be held per color; i.e. size of the color vectors reds / greens / blues
-	size_t _ledCount = 0;
-
-	/// The average component colors red, green, blue of the leds
-	std::vector<floatT> meanValues;
-
-	/// The residual component errors of the leds
-	std::vector<floatT> residualErrors;
+	/// Calculates the moving average for linear decay incrementally from the running window sums.
+	///
+	/// @param now The current time (end of the smoothing window)
+	/// @param windowStart The start time of the smoothing window
+	void interpolateLinearDecay(int64_t now, int64_t windowStart);
 
-	/// The accumulated led color values in 64-bit fixed point domain
-	std::vector<uint64_t> tempValues;
+	/// Calculates the moving average by weighting each frame of the history individually.
+	///
+	/// @param now The current time (end of the smoothing window)
+	/// @param windowStart The start time of the smoothing window
+	void interpolateWeightedDecay(int64_t now, int64_t windowStart);
 
 	/// Writes the target frame RGB data to the LED device without any interpolation.
 	void writeDirect();
@@ -346,14 +419,6 @@ private:
 	/// Writes the assembled RGB data to the LED device.
 	void writeFrame();
 
-	/// Assembles a frame of LED colors in order to write RGB data to the LED device.
-	/// Temporal dithering is applied to diffuse the downsampling error for RGB color components.
-	void assembleAndDitherFrame();
-
-	/// Assembles a frame of LED colors in order to write RGB data to the LED device.
-	/// No dithering is applied, RGB color components are just rounded to nearest integer.
-	void assembleFrame();
-
 	/// Prepares a frame of LED colors by interpolating using the current smoothing window
 	void interpolateFrame();
 
@@ -369,13 +434,6 @@ private:
 	/// Performs a linear smoothing effect
 	void performLinear(int64_t now);
 
-	/// Aggregates the RGB components of the LED colors using the given weight and updates weighted accordingly
-	///
-	/// @param colors The LED colors to aggregate.
-	/// @param weighted The target vector, that accumulates the terms.
-	/// @param weight The weight to use.
-	static inline void aggregateComponents(const std::vector<ColorRgb>& colors, std::vector<uint64_t>& weighted, const floatT weight);
-
 	/// Gets the current time in microseconds from high precision system clock.
 	static inline int64_t micros() ;
 
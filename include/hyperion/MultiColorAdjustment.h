@@ -1,6 +1,7 @@
 #pragma once
 
 // STL includes
+#include <atomic>
 #include <vector>
 #include <QStringList>
 #include <QString>
@@ -8,6 +9,7 @@
 // Hyperion includes
 #include <utils/ColorRgb.h>
 #include <hyperion/ColorAdjustment.h>
+#include <hyperion/LedString.h>
 
 ///
 /// The LedColorTransform is responsible for performing color transformation from 'raw' colors
@@ -54,15 +56,92 @@ public:
 	///
 	void applyAdjustment(std::vector<ColorRgb>& ledColors);
 
+	///
+	/// Sets the color order and the blacklisting of the LEDs used by applyOutputStage()
+	///
+	/// @param ledString The LED layout
+	///
+	void setLedString(const LedString& ledString);
+
+	///
+	/// Performs the complete LED output stage in a single pass over the LEDs:
+	/// blacklisting, color adjustment and color order correction.
+	/// LEDs not part of the layout are copied unchanged.
+	///
+	/// @param ledColors The list with raw colors
+	/// @param applyBlacklist True, if blacklisted LEDs are to be switched off
+	/// @param[out] output The colors to be sent to the LED-device (filled up to its current size)
+	///
+	void applyOutputStage(const std::vector<ColorRgb>& ledColors, bool applyBlacklist, std::vector<ColorRgb>& output);
+
+	///
+	/// Marks the color lookup tables as outdated, they are rebuilt with the next adjustment.
+	/// Must be called after a ColorAdjustment was modified.
+	///
+	void adjustmentsUpdated();
+
 private:
+	///
+	/// Precomputed output stage properties of a LED
+	///
+	struct LedDescriptor
+	{
+		/// The LED's ColorAdjustment (nullptr, if none is set)
+		ColorAdjustment* adjustment;
+		/// The lookup table of the LED's ColorAdjustment (nullptr, if none is set)
+		const ColorRgb* lookupTable;
+		/// The backlight threshold of the LED's ColorAdjustment (0, if the backlight is not active)
+		int backlightSum;
+		/// Source component (0 = red, 1 = green, 2 = blue) of the red, green and blue output
+		uint8_t channels[3];
+		/// LED is switched off, if blacklisting is applied
+		bool isBlacklisted;
+	};
+
+	///
+	/// Performs the full color adjustment (except backlight) of a single color
+	///
+	/// @param adjustment The ColorAdjustment to apply
+	/// @param color The raw color
+	///
+	/// @return The adjusted color
+	///
+	static ColorRgb adjustColor(ColorAdjustment& adjustment, ColorRgb color);
+
+	///
+	/// Bakes every ColorAdjustment in use into a 3D lookup table
+	///
+	void updateLookupTables();
+
+	///
+	/// Updates the backlight thresholds of the LED descriptors
+	///
+	void updateBacklight();
+
+	///
+	/// Adjusts the color of a single LED via its lookup table
+	///
+	/// @param led The LED's descriptor (with lookup table)
+	/// @param color The raw color
+	///
+	/// @return The adjusted color
+	///
+	static ColorRgb adjustLed(const LedDescriptor& led, const ColorRgb& color);
+
 	/// List with transform ids
 	QStringList _adjustmentIds;
 
 	/// List with unique ColorTransforms
 	std::vector<ColorAdjustment*> _adjustment;
 
-	/// List with a pointer to the ColorAdjustment for each individual led
-	std::vector<ColorAdjustment*> _ledAdjustments;
+	/// Output stage properties of each individual led
+	std::vector<LedDescriptor> _ledDescriptors;
+
+	/// 3D lookup table for each ColorAdjustment (same order as _adjustment, empty if not in use)
+	std::vector<std::vector<ColorRgb>> _lookupTables;
+
+	/// Flag indicating that the lookup tables match the current ColorAdjustments
+	std::atomic<bool> _lookupTablesValid;
 
 	// logger instance
 	Logger * _log;
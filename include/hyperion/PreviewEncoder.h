@@ -0,0 +1,123 @@
+#pragma once
+
+// STL includes
+#include <atomic>
+#include <cstdint>
+
+// Qt includes
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QMutex>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QScopedPointer>
+#include <QSharedPointer>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/Image.h>
+#include <utils/Logger.h>
+#include <utils/settings.h>
+
+///
+/// A JPEG encoded preview image, shared read-only by all subscribers
+///
+struct PreviewImage
+{
+	/// The JPEG data
+	QByteArray jpeg;
+	/// The JPEG data as data URL, as sent to JSON clients
+	QString dataUrl;
+	int width = 0;
+	int height = 0;
+};
+
+typedef QSharedPointer<const PreviewImage> PreviewImagePtr;
+Q_DECLARE_METATYPE(PreviewImagePtr)
+
+///
+/// Encodes the current image of a Hyperion instance for preview subscribers.
+///
+/// Every frame is encoded once on a dedicated thread, whatever the number of subscribers, and the same immutable
+/// payload is handed to all of them. Frames arriving while the previous one is still being encoded replace the
+/// pending one (latest wins), so a slow encode never queues frames or delays the instance. No encoding takes place
+/// while nobody is connected to previewImage().
+///
+/// The preview is optionally downscaled to a maximum width. JPEG quality and the maximum preview rate are
+/// configured by the "instCapture" settings of the instance.
+///
+class PreviewEncoder : public QObject
+{
+	Q_OBJECT
+
+public:
+	///
+	/// @param[in] config The "instCapture" settings of the instance
+	/// @param[in] log The logger of the instance
+	/// @param[in] parent The Hyperion instance
+	///
+	PreviewEncoder(const QJsonDocument& config, Logger* log, QObject* parent = nullptr);
+	~PreviewEncoder() override;
+
+	///
+	/// @return The number of encoded and coalesced frames and the encoding time (thread-safe)
+	///
+	QJsonObject getStatistics() const;
+
+signals:
+	///
+	/// @brief Emits for every encoded preview, from the encoder's thread
+	/// @param image The encoded preview
+	///
+	void previewImage(const PreviewImagePtr& image);
+
+	///
+	/// @brief Internal: a frame is waiting to be encoded
+	///
+	void imagePending();
+
+public slots:
+	///
+	/// @brief Takes the current image of the instance, to be connected directly to Hyperion::currentImage
+	/// @param image The current image
+	///
+	void handleImage(const Image<ColorRgb>& image);
+
+	///
+	/// @brief Handle settings update from Hyperion Settingsmanager emit
+	/// @param type   settingyType from enum
+	/// @param config configuration object
+	///
+	void handleSettingsUpdate(settings::type type, const QJsonDocument& config);
+
+private:
+	/// Encodes the pending frame (encoder thread)
+	void encodePending();
+
+	Logger* _log;
+
+	QScopedPointer<QThread> _thread;
+	/// Context of the encoder thread, receives imagePending()
+	QScopedPointer<QObject> _worker;
+
+	std::atomic<int> _quality;
+	std::atomic<int> _maxWidth;
+	std::atomic<int> _minInterval_ms;
+
+	/// Rate limitation, used by the instance's thread only
+	QElapsedTimer _intervalTimer;
+
+	/// Guards the pending frame
+	QMutex _pendingMutex;
+	Image<ColorRgb> _pendingImage;
+	bool _isImagePending;
+
+	std::atomic<uint64_t> _encodedFrames;
+	std::atomic<uint64_t> _coalescedFrames;
+	std::atomic<int64_t> _lastEncodeTime_us;
+	std::atomic<int64_t> _maxEncodeTime_us;
+	std::atomic<int> _lastSize;
+};
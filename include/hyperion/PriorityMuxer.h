@@ -6,6 +6,7 @@
 
 // QT includes
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QVector>
 
@@ -55,6 +56,38 @@ public:
 
 	typedef QMap<int, InputInfo> InputsMap;
 
+	///
+	/// A frame posted to the latest-frame mailbox of a priority channel
+	///
+	struct PostedImage
+	{
+		/// The image (implicitly shared, posting does not copy the pixels)
+		Image<ColorRgb> image;
+		/// The timeout to apply with the image
+		int64_t timeout_ms;
+		/// Specific owner description, e.g. the name of the grabber
+		QString owner;
+		/// Clear a running effect on the priority
+		bool clearEffect;
+		/// Keep the order with clears announced by requestClear(), the frames held back are applied by the caller of finishClear()
+		bool isOrderedWithClears = false;
+	};
+
+	///
+	/// The accounting of a priority channel's mailbox
+	///
+	struct MailboxCounters
+	{
+		/// Frames posted to the mailbox
+		uint64_t posted;
+		/// Frames replaced by a newer one before they were taken
+		uint64_t coalesced;
+		/// Frames discarded, as the priority was cleared or the source disabled
+		uint64_t dropped;
+	};
+
+	typedef QMap<int, MailboxCounters> MailboxCountersMap;
+
 	//Foreground and Background priorities
 	const static int FG_PRIORITY;
 	const static int BG_PRIORITY;
@@ -163,9 +196,9 @@ public:
 	///
 	/// @param priority The priority channel
 	///
-	/// @return The information for the specified priority channel
+	/// @return The information for the specified priority channel, valid until the priority channels are changed
 	///
-	InputInfo getInputInfo(int priority) const;
+	const InputInfo& getInputInfo(int priority) const;
 
 	///
 	/// @brief  Register a new input by priority, the priority is not active (timeout -100 isn't muxer recognized) until you start to update the data with setInput()
@@ -196,6 +229,53 @@ public:
 	///
 	bool setInputImage(int priority, const Image<ColorRgb>& image, int64_t timeout_ms = ENDLESS);
 
+	///
+	/// @brief  Post an image as the latest frame of a priority (thread-safe, to be called from any thread)
+	///         Only the newest frame is kept: a frame not yet taken by takeInputImage() is replaced and counted as coalesced.
+	///         A frame ordered with clears and posted after requestClear() is held back, until the clear is done (see finishClear()).
+	/// @param  priority  The priority of the frame
+	/// @param  frame     The frame
+	/// @return           True, if the mailbox was empty and no clear is pending,
+	///                   i.e. the caller has to trigger takeInputImage() in the instance thread
+	///
+	bool postInputImage(int priority, const PostedImage& frame);
+
+	///
+	/// @brief  Take the latest frame posted to a priority (thread-safe)
+	/// @param  priority  The priority
+	/// @param  frame     The frame taken
+	/// @return           True, if a frame was pending and is not held back for a clear
+	///
+	bool takeInputImage(int priority, PostedImage& frame);
+
+	///
+	/// @brief  Discard the frame posted to a priority and count it as dropped (thread-safe)
+	///         A frame held back for a pending clear is kept, it was posted after the clear was requested.
+	/// @param  priority  The priority
+	///
+	void dropInputImage(int priority);
+
+	///
+	/// @brief  Announce a clear, which is applied later in the instance thread (thread-safe, to be called from the requesting thread)
+	///         Frames ordered with clears (see PostedImage) posted before are discarded, the ones posted afterwards
+	///         are held back until finishClear(), so that the order of posted frames and clears is preserved.
+	/// @param  priority  The priority to be cleared, -1 for all priorities
+	///
+	void requestClear(int priority);
+
+	///
+	/// @brief  Complete a clear announced by requestClear(), after it was applied
+	/// @param  priority  The priority cleared, -1 for all priorities
+	/// @return           The priorities with frames held back, which are to be taken now
+	///
+	QList<int> finishClear(int priority);
+
+	///
+	/// @brief  Get the accounting of all mailboxes (thread-safe)
+	/// @return The counters per priority
+	///
+	MailboxCountersMap getMailboxCounters() const;
+
 	///
 	/// @brief Set the given priority to inactive
 	/// @param priority  The priority
@@ -293,4 +373,28 @@ private:
 
 	QScopedPointer<QTimer, QScopedPointerDeleteLater> _timer;
 	QScopedPointer<QTimer, QScopedPointerDeleteLater> _blockTimer;
+
+	struct Mailbox
+	{
+		PostedImage frame {};
+		bool pending = false;
+		/// Clears requested, but not yet applied in the instance thread
+		int clearRequests = 0;
+		MailboxCounters counters {};
+	};
+
+	/// The frame is held back for a clear requested, but not yet applied (mailbox mutex locked)
+	bool isHeldBack(const Mailbox& mailbox) const
+	{
+		return mailbox.frame.isOrderedWithClears && (mailbox.clearRequests > 0 || _clearAllRequests > 0);
+	}
+
+	/// Discards a pending frame, counted as dropped (mailbox mutex locked)
+	static void drop(Mailbox& mailbox);
+
+	/// Latest-frame mailbox per priority, filled from the grabber/server threads
+	mutable QMutex _mailboxMutex;
+	QMap<int, Mailbox> _mailboxes;
+	/// Clears of all priorities requested, but not yet applied
+	int _clearAllRequests;
 };
@@ -0,0 +1,48 @@
+#pragma once
+
+// STL includes
+#include <functional>
+
+// Qt includes
+#include <QThreadPool>
+#include <QMutex>
+
+///
+/// Persistent pool of worker threads shared by all Hyperion instances to process image to LED
+/// mappings in parallel. The workers are created once and kept alive, no thread is created per frame.
+///
+class ProcessingPool
+{
+public:
+	/// Maximum number of chunks a job can be split into
+	static constexpr int MAX_CHUNKS = 16;
+
+	///
+	/// @return The pool shared by all instances
+	///
+	static ProcessingPool& getInstance();
+
+	///
+	/// Ensures the pool can run the given number of chunks in parallel.
+	/// The pool only grows, as instances may request different numbers of threads.
+	///
+	/// @param[in] threadCount Number of threads requested (including the calling thread)
+	/// @return The number of chunks to be used by the requester (limited by MAX_CHUNKS and the CPU cores)
+	///
+	int reserveThreads(int threadCount);
+
+	///
+	/// Runs function(chunk) for every chunk in [0, chunkCount). Chunk 0 is processed by the calling thread,
+	/// the others by the workers. Returns when all chunks are done.
+	///
+	/// @param[in] chunkCount Number of chunks (at most MAX_CHUNKS)
+	/// @param[in] function Function processing a single chunk
+	///
+	void run(int chunkCount, const std::function<void(int)>& function);
+
+private:
+	ProcessingPool();
+
+	QThreadPool _pool;
+	QMutex _mutex;
+};
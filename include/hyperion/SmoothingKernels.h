@@ -0,0 +1,157 @@
+#ifndef SMOOTHINGKERNELS_H
+#define SMOOTHINGKERNELS_H
+
+// STL includes
+#include <cstdint>
+#include <vector>
+
+// hyperion includes
+#include <HyperionConfig.h>
+#include <utils/ColorRgb.h>
+
+// The type of float
+#define floatT float // The SSE2 and NEON code of PlanarSmoothingKernels processes 32-bit floats only
+
+///
+/// Computational kernels of the decay smoothing, operating on the per-LED color component buffers.
+///
+/// The kernels own the buffers (mean values, residual errors of the dithering, the fixed point
+/// accumulator of the weighted decay and the running window sums of the linear decay), so that
+/// the memory layout is private to an implementation. Two implementations with identical results
+/// are provided:
+///
+///  - InterleavedSmoothingKernels: components stored interleaved (RGBRGB...), plain scalar code
+///  - PlanarSmoothingKernels: components stored in separate R, G and B planes, processed with SSE2 or NEON
+///
+/// SmoothingKernels selects the implementation used by LinearColorSmoothing at build time (ENABLE_SMOOTHING_PLANAR).
+///
+class InterleavedSmoothingKernels
+{
+public:
+	/// (Re-)Initializes the mean values, residual errors and the accumulator for the given number of LEDs
+	///
+	/// @param ledCount The number of LEDs
+	void resize(size_t ledCount);
+
+	/// Frees all buffers, including the window sums
+	void clear();
+
+	/// @return The number of LEDs the mean values are held for
+	size_t ledCount() const { return _ledCount; }
+
+	/// Zeros the fixed point accumulator of the weighted decay
+	void resetAccumulator();
+
+	/// Aggregates the RGB components of the LED colors using the given weight into the accumulator
+	///
+	/// @param colors The LED colors to aggregate
+	/// @param weight The weight of the colors
+	void aggregate(const std::vector<ColorRgb>& colors, floatT weight);
+
+	/// Converts the accumulator to the mean values
+	///
+	/// @param inverseWeight The inverse of the total weight aggregated
+	void normalize(floatT inverseWeight);
+
+	/// (Re-)Initializes the window sums of the linear decay with zeros
+	///
+	/// @param ledCount The number of LEDs
+	void resetWindowSums(size_t ledCount);
+
+	/// @return The number of LEDs the window sums are held for
+	size_t windowSumsLedCount() const { return _windowSums.size() / 3; }
+
+	/// Adds the colors weighted by their display time to the window sums
+	///
+	/// @param colors The LED colors
+	/// @param duration The display time in microseconds
+	void addToWindowSums(const std::vector<ColorRgb>& colors, uint64_t duration);
+
+	/// Subtracts the colors weighted by their display time from the window sums
+	///
+	/// @param colors The LED colors
+	/// @param duration The display time in microseconds
+	void subtractFromWindowSums(const std::vector<ColorRgb>& colors, uint64_t duration);
+
+	/// Calculates the mean values from the window sums and the oldest and newest frame, which are not part of the sums
+	///
+	/// @param oldest The colors of the oldest frame
+	/// @param oldestTime The display time of the oldest frame within the window
+	/// @param newest The colors of the newest frame
+	/// @param newestTime The display time of the newest frame
+	/// @param inverseWindow The inverse of the window size
+	void averageWindow(const std::vector<ColorRgb>& oldest, uint64_t oldestTime, const std::vector<ColorRgb>& newest, uint64_t newestTime, floatT inverseWindow);
+
+	/// Rounds the mean values to the nearest integer
+	///
+	/// @param[out] colors The LED colors to update
+	void assemble(std::vector<ColorRgb>& colors);
+
+	/// Rounds the mean values plus the residual errors and keeps the new residual errors (temporal dithering)
+	///
+	/// @param[out] colors The LED colors to update
+	void assembleAndDither(std::vector<ColorRgb>& colors);
+
+private:
+	size_t _ledCount = 0;
+
+	/// The average component colors red, green, blue of the leds
+	std::vector<floatT> _meanValues;
+
+	/// The residual component errors of the leds
+	std::vector<floatT> _residualErrors;
+
+	/// The accumulated led color values in 64-bit fixed point domain
+	std::vector<uint64_t> _accumulator;
+
+	/// Running sums of the color components weighted by their display time (in microseconds)
+	std::vector<uint64_t> _windowSums;
+};
+
+///
+/// Same interface and results as InterleavedSmoothingKernels. The components are held in separate R, G and B planes,
+/// the LED colors are split into the planes when aggregated or added to the window sums and interleaved again when assembled.
+///
+class PlanarSmoothingKernels
+{
+public:
+	void resize(size_t ledCount);
+	void clear();
+	size_t ledCount() const { return _ledCount; }
+
+	void resetAccumulator();
+	void aggregate(const std::vector<ColorRgb>& colors, floatT weight);
+	void normalize(floatT inverseWeight);
+
+	void resetWindowSums(size_t ledCount);
+	size_t windowSumsLedCount() const { return _windowSums.size() / 3; }
+	void addToWindowSums(const std::vector<ColorRgb>& colors, uint64_t duration);
+	void subtractFromWindowSums(const std::vector<ColorRgb>& colors, uint64_t duration);
+	void averageWindow(const std::vector<ColorRgb>& oldest, uint64_t oldestTime, const std::vector<ColorRgb>& newest, uint64_t newestTime, floatT inverseWindow);
+
+	void assemble(std::vector<ColorRgb>& colors);
+	void assembleAndDither(std::vector<ColorRgb>& colors);
+
+private:
+	/// Writes the rounded planes to the LED colors
+	void storeRounded(std::vector<ColorRgb>& colors) const;
+
+	size_t _ledCount = 0;
+
+	/// The buffers hold the planes of red, green and blue components one after another, each of _ledCount values
+	std::vector<floatT> _meanValues;
+	std::vector<floatT> _residualErrors;
+	std::vector<floatT> _rounded;
+	std::vector<uint64_t> _accumulator;
+
+	/// The window sums hold the planes of windowSumsLedCount() values each
+	std::vector<uint64_t> _windowSums;
+};
+
+#ifdef ENABLE_SMOOTHING_PLANAR
+using SmoothingKernels = PlanarSmoothingKernels;
+#else
+using SmoothingKernels = InterleavedSmoothingKernels;
+#endif
+
+#endif // SMOOTHINGKERNELS_H
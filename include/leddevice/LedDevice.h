@@ -14,6 +14,7 @@
 
 // STL includes
 #include <vector>
+#include <atomic>
 #include <map>
 #include <algorithm>
 #include <chrono>
@@ -102,6 +103,17 @@ public:
 	///
 	void setEnableAttempts(int maxEnablAttempts, std::chrono::seconds enableAttemptsTimerInterval);
 
+	///
+	/// @brief Set a device's change detection.
+	///
+	/// With change detection, updates not changing any color channel by more than the threshold are skipped.
+	/// Devices supporting partial updates only write the range of LEDs changed.
+	///
+	/// @param[in] isSkipUnchangedFrames Skip unchanged updates
+	/// @param[in] changeThreshold Maximum difference of a channel's value still considered as unchanged
+	///
+	void setChangeDetection(bool isSkipUnchangedFrames, int changeThreshold);
+
 	/// @brief Enable a device automatically after Hyperion startup or not
 	///
 	/// @param[in] isAutoStart
@@ -154,6 +166,22 @@ public:
 	/// @return A JSON structure holding the authorization key/token
 	virtual QJsonObject addAuthorization(const QJsonObject& /*params*/) { return QJsonObject(); }
 
+	///
+	/// @brief Get statistics of the device's transport, e.g. the datagrams and send times of a network device.
+	///
+	/// Called from outside the device's thread, i.e. implementations must be thread-safe.
+	///
+	/// @return A JSON structure holding the statistics, empty if not provided by the device
+	///
+	virtual QJsonObject getTransportStatistics() const { return QJsonObject(); }
+
+	///
+	/// @brief Get the number of updates skipped by the change detection (thread-safe)
+	///
+	/// @return Number of skipped updates
+	///
+	quint64 getSkippedFrameCount() const { return _skippedFrames; }
+
 	///
 	/// @brief Check, if device is properly initialised
 	///
@@ -208,7 +236,7 @@ public slots:
 	/// @param[in] ledValues The color per LED
 	/// @return Zero on success else negative (i.e. device is not ready)
 	///
-	virtual int updateLeds(std::vector<ColorRgb> ledValues);
+	virtual int updateLeds(const std::vector<ColorRgb>& ledValues);
 
 	///
 	/// @brief Get the currently defined LatchTime.
@@ -483,6 +511,13 @@ protected:
 	/// Timestamp of last write
 	QDateTime _lastWriteTime;
 
+	/// Does the device write the range of changed LEDs only, i.e. _changedLedsBegin to _changedLedsEnd?
+	bool _isPartialWriteSupported;
+
+	/// Range of LEDs changed by the update written, all LEDs (0 to INT_MAX) for complete writes, e.g. rewrites
+	int _changedLedsBegin;
+	int _changedLedsEnd;
+
 protected slots:
 
 	///
@@ -515,6 +550,15 @@ private:
 	/// @brief Stop refresh cycle
 	void stopRefreshTimer();
 
+	///
+	/// @brief Determines the range of LEDs changed against the values written last and updates those
+	///
+	/// @param[in] ledValues The LED values to be written
+	///
+	/// @return True, if any LED changed by more than the change threshold
+	///
+	bool detectChangedLeds(const std::vector<ColorRgb>& ledValues);
+
 	/// Timer that enables a device (used to retry enablement, if enabled failed before)
 	QScopedPointer<QTimer, QScopedPointerDeleteLater>	_enableAttemptsTimer;
 
@@ -530,6 +574,18 @@ private:
 	/// Is device to be enabled during start
 	bool _isAutoStart;
 
+	/// Are updates not changing the LEDs skipped?
+	bool _isSkipUnchangedFrames;
+
+	/// Maximum difference of a channel's value considered as unchanged
+	int _changeThreshold;
+
+	/// LED values as written to the device, reference of the change detection (empty, if unknown)
+	std::vector<ColorRgb> _writtenLedValues;
+
+	/// Number of updates skipped by the change detection
+	std::atomic<quint64> _skippedFrames;
+
 	/// Order of Colors supported by the device
 	/// "RGB", "BGR", "RBG", "BRG", "GBR", "GRB"
 	QString	_colorOrder;
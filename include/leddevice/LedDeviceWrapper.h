@@ -7,6 +7,14 @@
 #include <utils/Components.h>
 
 #include <QScopedPointer>
+#include <QMutex>
+#include <QJsonObject>
+
+// STL includes
+#include <atomic>
+#include <vector>
+
+#include <utils/TripleBuffer.h>
 
 class LedDevice;
 class Hyperion;
@@ -82,7 +90,26 @@ public:
 	///
 	int getLedCount() const;
 
+	///
+	/// @brief Get the statistics of the frame handoff to the LED-device (thread-safe)
+	/// @return Number of published, delivered, coalesced and unchanged (skipped) frames, and the transport statistics of the device, if provided
+	///
+	QJsonObject getStatistics() const;
+
 public slots:
+	///
+	/// @brief Hands the LED colors over to the LED-device's thread (thread-safe)
+	///
+	/// The colors are placed into a triple buffer and the device's thread is woken, unless a wake-up is already
+	/// pending. A frame not yet taken by the device when the next one arrives is replaced (coalesced), i.e.
+	/// the device always writes the latest colors and never works through a queue of stale frames.
+	///
+	/// @param[in] ledValues  The RGB-color per led
+	///
+	/// @return Zero on success else negative
+	///
+	int updateLeds(const std::vector<ColorRgb>& ledValues);
+
 	///
 	/// @brief Handle new component state request
 	/// @param component  The comp from enum
@@ -97,13 +124,9 @@ public slots:
 
 signals:
 	///
-	/// PIPER signal for Hyperion -> LedDevice
-	///
-	/// @param[in] ledValues  The RGB-color per led
-	///
-	/// @return Zero on success else negative
+	/// @brief Wakes the LED-device's thread to take the latest frame (internal, emitted by updateLeds)
 	///
-	int updateLeds(const std::vector<ColorRgb>& ledValues);
+	void frameAvailable();
 
 	///
 	/// @brief Switch the LEDs on.
@@ -150,6 +173,13 @@ private slots:
 	///
 	void onIsOnChanged(bool isOn);
 
+private:
+	///
+	/// @brief Takes the latest frame from the triple buffer and writes it to the LED-device.
+	/// Runs in the LED-device's thread
+	///
+	void deliverFrame();
+
 protected:
 	/// contains all available led device constructors
 	static LedDeviceRegistry _ledDeviceMap;
@@ -168,6 +198,19 @@ private:
 	// 	LED-Device's states
 	bool _isEnabled;
 	bool _isOn;
+
+	/// Frames handed over from the producing thread (instance or smoothing output thread) to the LED-device's thread
+	TripleBuffer<std::vector<ColorRgb>> _ledFrames;
+	/// Serializes producers and guards the device against being exchanged while a frame is handed over
+	QMutex _producerMutex;
+	/// True while frames are accepted, i.e. a device is running
+	bool _acceptFrames;
+	/// True, if the device's thread was woken and has not taken the latest frame yet
+	std::atomic<bool> _deliveryPending;
+
+	std::atomic<uint64_t> _publishedFrames;
+	std::atomic<uint64_t> _deliveredFrames;
+	std::atomic<uint64_t> _coalescedFrames;
 };
 
 #endif // LEDEVICEWRAPPER_H
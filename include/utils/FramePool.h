@@ -0,0 +1,67 @@
+#pragma once
+
+// STL includes
+#include <cstddef>
+#include <cstdint>
+
+///
+/// Size-bucketed pool of image buffers shared by all images of the process.
+///
+/// Images are created and released at the frame rate of every grabber, stream and effect.
+/// Instead of returning a released buffer to the heap, it is kept in a small number of slots per size class
+/// and handed out to the next image of (about) the same size. Sizes are rounded up to four classes per power of two,
+/// so that images of slightly different size can share buffers.
+///
+/// Allocating and releasing is thread-safe and lock-free (a slot is claimed/filled by a single atomic operation).
+/// Buffers smaller than MIN_POOLED_SIZE or larger than MAX_POOLED_SIZE are not pooled.
+///
+class FramePool
+{
+public:
+	/// Smallest buffer size pooled, smaller buffers are cheap to allocate
+	static constexpr size_t MIN_POOLED_SIZE = 4096;
+	/// Largest buffer size pooled (2^27 bytes, e.g. an 8K RGBA image)
+	static constexpr size_t MAX_POOLED_SIZE = static_cast<size_t>(1) << 27;
+	/// Number of buffers kept per size class
+	static constexpr int SLOTS_PER_CLASS = 4;
+	/// Upper limit of memory kept in the pool
+	static constexpr size_t MAX_CACHED_BYTES = static_cast<size_t>(256) << 20;
+
+	struct Statistics
+	{
+		/// Number of allocations served from the pool
+		uint64_t hits;
+		/// Number of allocations served from the heap
+		uint64_t misses;
+		/// Number of released buffers returned to the heap, as the pool was full
+		uint64_t discards;
+		/// Memory currently kept in the pool
+		uint64_t cachedBytes;
+	};
+
+	///
+	/// Allocates an uninitialized buffer
+	///
+	/// @param[in] bytes The size required
+	/// @return The buffer (to be released by release() with the same size)
+	///
+	static void* allocate(size_t bytes);
+
+	///
+	/// Returns a buffer to the pool
+	///
+	/// @param[in] buffer The buffer obtained by allocate() (nullptr is ignored)
+	/// @param[in] bytes The size the buffer was allocated with
+	///
+	static void release(void* buffer, size_t bytes);
+
+	///
+	/// Frees all buffers currently kept in the pool
+	///
+	static void clear();
+
+	///
+	/// @return The pool's hit/miss counters
+	///
+	static Statistics statistics();
+};
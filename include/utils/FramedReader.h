@@ -0,0 +1,92 @@
+#pragma once
+
+// STL includes
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Qt includes
+#include <QIODevice>
+
+///
+/// Reader of length-prefixed messages (32-bit big endian size followed by the message) as used by the
+/// FlatBuffers and Protocol Buffers servers and clients.
+///
+/// The message is read from the device straight into a message buffer, without collecting the stream in an
+/// intermediate buffer. A message arriving in many chunks is completed in place, the buffer grows with the data
+/// received, not with the size announced by the header. It is reused for the following messages and shrunk, if the
+/// recent messages are much smaller. Completed messages are handed out as a contiguous view, valid till the next
+/// call of read().
+///
+class FramedReader
+{
+public:
+	/// Size of the length prefix
+	static constexpr int HEADER_SIZE = 4;
+	/// Default limit of a message, sufficient for raw 4K RGBA images
+	static constexpr uint32_t DEFAULT_MAX_MESSAGE_SIZE = 128 * 1024 * 1024;
+	/// Bytes the buffer grows by at least, if the device does not tell the bytes available
+	static constexpr uint32_t MIN_READ_SIZE = 64 * 1024;
+	/// Number of messages, after which the buffer is shrunk to the largest of them
+	static constexpr int SHRINK_INTERVAL = 64;
+
+	enum class Result
+	{
+		/// A message is complete, available by data() and size()
+		MessageReady,
+		/// All available data is consumed and the message is not yet complete
+		NeedMoreData,
+		/// The header announces a message larger than the limit, the stream cannot be read any further
+		MessageTooLarge
+	};
+
+	///
+	/// @param[in] maxMessageSize Largest message accepted
+	///
+	explicit FramedReader(uint32_t maxMessageSize = DEFAULT_MAX_MESSAGE_SIZE);
+
+	///
+	/// Reads from the device till a message is complete or no more data is available.
+	/// Call it repeatedly until it returns NeedMoreData, as the device may hold several messages.
+	///
+	/// @param[in] device The device to read from, e.g. a TCP socket
+	/// @return The result, see Result
+	///
+	Result read(QIODevice* device);
+
+	///
+	/// @return The message completed by the last read()
+	///
+	const uint8_t* data() const { return _buffer.data(); }
+
+	///
+	/// @return The size of the message completed by the last read(), or the size announced if too large
+	///
+	uint32_t size() const { return _messageSize; }
+
+	///
+	/// Discards a partially read message and releases the buffer, e.g. when the connection is re-established
+	///
+	void reset();
+
+private:
+	const uint32_t _maxMessageSize;
+
+	std::array<uint8_t, HEADER_SIZE> _header;
+	int _headerBytes;
+
+	/// Releases the message buffer
+	void releaseBuffer();
+
+	/// The message buffer, its size is the largest number of bytes received for a message since it was shrunk
+	std::vector<uint8_t> _buffer;
+	uint32_t _messageSize;
+	uint32_t _messageBytes;
+
+	/// Largest message and number of messages since the buffer was last checked for shrinking
+	uint32_t _recentMaxSize;
+	int _recentMessages;
+
+	bool _isMessageComplete;
+	bool _isMessageTooLarge;
+};
@@ -4,7 +4,9 @@
 #include <cstdint>
 #include <cstring>
 #include <algorithm>
+#include <type_traits>
 #include <utils/ColorRgb.h>
+#include <utils/FramePool.h>
 
 // QT includes
 #include <QSharedData>
@@ -18,13 +20,16 @@ typedef SSIZE_T ssize_t;
 template <typename Pixel_T>
 class ImageData : public QSharedData
 {
+	// Pixel buffers are taken from the FramePool uninitialized and released without destruction
+	static_assert(std::is_trivial<Pixel_T>::value, "Pixel type must be trivial");
+
 public:
 	typedef Pixel_T pixel_type;
 
 	ImageData(int width, int height, const Pixel_T background) :
 		_width(width),
 		_height(height),
-		_pixels(new Pixel_T[static_cast<size_t>(width) * static_cast<size_t>(height)])
+		_pixels(allocatePixels(width, height))
 	{
 		std::fill(_pixels, _pixels + width * height, background);
 	}
@@ -33,7 +38,7 @@ public:
 		QSharedData(other),
 		_width(other._width),
 		_height(other._height),
-		_pixels(new Pixel_T[static_cast<size_t>(other._width) * static_cast<size_t>(other._height)])
+		_pixels(allocatePixels(other._width, other._height))
 	{
 		memcpy(_pixels, other._pixels, static_cast<size_t>(other._width) * static_cast<size_t>(other._height) * sizeof(Pixel_T));
 	}
@@ -68,7 +73,7 @@ public:
 
 	~ImageData()
 	{
-		delete[] _pixels;
+		releasePixels(_pixels, _width, _height);
 	}
 
 	inline int width() const
@@ -113,11 +118,11 @@ public:
 			return;
 		}
 
-		// Allocate a new buffer without initializing the content
-		Pixel_T* newPixels = new Pixel_T[static_cast<size_t>(width) * static_cast<size_t>(height)];
+		// Release the old buffer without copying data first, so it can be reused if of the same size class
+		releasePixels(_pixels, _width, _height);
 
-		// Release the old buffer without copying data
-		delete[] _pixels;
+		// Allocate a new buffer without initializing the content
+		Pixel_T* newPixels = allocatePixels(width, height);
 
 		// Update the pointer to the new buffer
 		_pixels = newPixels;
@@ -168,6 +173,21 @@ public:
 	}
 
 private:
+	static size_t bufferSize(int width, int height)
+	{
+		return static_cast<size_t>(width) * static_cast<size_t>(height) * sizeof(Pixel_T);
+	}
+
+	static Pixel_T* allocatePixels(int width, int height)
+	{
+		return static_cast<Pixel_T*>(FramePool::allocate(bufferSize(width, height)));
+	}
+
+	static void releasePixels(Pixel_T* pixels, int width, int height)
+	{
+		FramePool::release(pixels, bufferSize(width, height));
+	}
+
 	inline int toIndex(int x, int y) const
 	{
 		return y * _width + x;
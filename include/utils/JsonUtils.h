@@ -8,6 +8,8 @@
 #include <QStringList>
 #include <utils/Logger.h>
 
+class QJsonSchemaChecker;
+
 namespace JsonUtils {
 	///
 	/// @brief read a JSON file and get the parsed result on success
@@ -80,6 +82,16 @@ namespace JsonUtils {
 	///
 	QPair<bool, QStringList> validate(const QString& file, const QJsonValue& json, const QJsonObject& schema, Logger* log);
 
+	///
+	/// @brief Validate JSON data against a schema checker set up before, e.g. a cached one
+	/// @param[in]   file          The path/name of JSON file context used for log messages
+	/// @param[in]   json          The JSON data
+	/// @param[in]   schemaChecker The schema checker
+	/// @param[in]   log           The logger of the caller to print errors
+	/// @return                    true on success else false, plus validation errors
+	///
+	QPair<bool, QStringList> validate(const QString& file, const QJsonValue& json, QJsonSchemaChecker& schemaChecker, Logger* log);
+
 	///
 	/// @brief Validate JSON data against a schema
 	/// @param[in]      file     The path/name of JSON file context used for log messages
@@ -0,0 +1,100 @@
+#pragma once
+
+// STL includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// Qt includes
+#include <QThread>
+#include <QString>
+
+// Utils includes
+#include <utils/Logger.h>
+
+///
+/// Dedicated thread invoking a tick function at absolute deadlines.
+///
+/// The thread sleeps till the next deadline (clock_nanosleep with TIMER_ABSTIME on Linux), so that its timing
+/// is not affected by the work of any Qt event loop. Deadlines advance by the period returned by the tick,
+/// i.e. there is no drift by the time the tick takes. Optionally, the thread runs with SCHED_FIFO real-time
+/// priority and is bound to a CPU core.
+///
+/// The lateness of every wake-up against its deadline is recorded in a histogram of power-of-two buckets.
+///
+class OutputScheduler : public QThread
+{
+public:
+	/// Number of histogram buckets: [0,1) µs, [1,2) µs, [2,4) µs, ... [2^(n-2), ∞) µs
+	static constexpr int JITTER_BUCKETS = 16;
+
+	struct Statistics
+	{
+		/// Number of ticks performed
+		uint64_t ticks;
+		/// Number of deadlines missed by more than a period (the schedule was restarted)
+		uint64_t missedDeadlines;
+		/// Maximum lateness of a wake-up in microseconds
+		int64_t maxLateness;
+		/// Number of wake-ups per lateness bucket
+		std::array<uint64_t, JITTER_BUCKETS> jitterHistogram;
+	};
+
+	///
+	/// @param[in] name The name of the thread (used for logging)
+	/// @param[in] tick The function called at every deadline, returns the period till the next deadline in microseconds
+	/// @param[in] parent The parent object
+	///
+	OutputScheduler(const QString& name, std::function<int64_t()> tick, QObject* parent = nullptr);
+	~OutputScheduler() override;
+
+	///
+	/// Starts the thread
+	///
+	/// @param[in] realtimePriority SCHED_FIFO priority (1-99), 0 for normal scheduling
+	/// @param[in] cpuAffinity The CPU core to bind the thread to, -1 for no binding
+	///
+	void start(int realtimePriority, int cpuAffinity);
+
+	///
+	/// Stops the thread and waits till the current tick has finished
+	///
+	void stop();
+
+	///
+	/// @return The timing statistics since the last reset
+	///
+	Statistics statistics() const;
+
+	///
+	/// Clears the timing statistics
+	///
+	void resetStatistics();
+
+	///
+	/// @return The upper bound in microseconds of the given histogram bucket, -1 for the last (unbounded) one
+	///
+	static int64_t bucketLimit(int bucket);
+
+protected:
+	void run() override;
+
+private:
+	/// Applies the real-time priority and CPU affinity to the calling thread
+	void applySchedulingPolicy();
+
+	/// Records the lateness of a wake-up
+	void recordLateness(int64_t lateness);
+
+	Logger* _log;
+	std::function<int64_t()> _tick;
+	std::atomic<bool> _stopRequested;
+	int _realtimePriority;
+	int _cpuAffinity;
+
+	std::atomic<uint64_t> _ticks;
+	std::atomic<uint64_t> _missedDeadlines;
+	std::atomic<int64_t> _maxLateness;
+	std::array<std::atomic<uint64_t>, JITTER_BUCKETS> _jitterHistogram;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+// STL includes
+#include <cstdint>
+
+///
+/// Vectorized per channel summation of packed 24-bit RGB pixels.
+///
+/// The kernel used is selected once at runtime (AVX2 or SSE2 on x86, NEON on ARM builds with NEON enabled)
+/// and falls back to a portable scalar implementation if no vector unit is available.
+///
+class PixelSum
+{
+public:
+	enum class Kernel
+	{
+		Scalar,
+		Sse2,
+		Avx2,
+		Neon
+	};
+
+	///
+	/// @return The kernel currently used for summation
+	///
+	static Kernel kernel();
+
+	///
+	/// @param[in] kernel The kernel
+	/// @return Human readable name of the given kernel
+	///
+	static const char* kernelName(Kernel kernel);
+
+	///
+	/// @param[in] kernel The kernel
+	/// @return True, if the kernel is compiled in and supported by the CPU
+	///
+	static bool isSupported(Kernel kernel);
+
+	///
+	/// Overrides the runtime kernel selection, e.g. to compare kernels in benchmarks.
+	/// Not thread-safe, must not be called while sums are calculated.
+	///
+	/// @param[in] kernel The kernel to be used
+	/// @return False, if the kernel is not supported (the current one is kept)
+	///
+	static bool setKernel(Kernel kernel);
+
+	///
+	/// Adds the red, green and blue values of a contiguous run of pixels to the given sums
+	///
+	/// @param[in] rgb         Pointer to the first pixel (3 bytes per pixel, red first)
+	/// @param[in] pixelCount  Number of pixels
+	/// @param[in,out] sums    Accumulated red, green and blue sums
+	///
+	static void sumRgb(const uint8_t* rgb, int pixelCount, uint64_t sums[3]);
+
+	///
+	/// Adds the squared red, green and blue values of a contiguous run of pixels to the given sums
+	///
+	/// @param[in] rgb         Pointer to the first pixel (3 bytes per pixel, red first)
+	/// @param[in] pixelCount  Number of pixels
+	/// @param[in,out] sums    Accumulated squared red, green and blue sums
+	///
+	static void sumRgbSquared(const uint8_t* rgb, int pixelCount, uint64_t sums[3]);
+};
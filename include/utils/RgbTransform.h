@@ -61,6 +61,9 @@ public:
 	/// @param enable en/disable backlight
 	void setBackLightEnabled(bool enable);
 
+	/// @return The sum of the RGB components below which the backlight is applied (0, if the backlight is not active)
+	int getBacklightSumThreshold() const;
+
 	/// @return The current brightness
 	uint8_t getBrightness() const;
 
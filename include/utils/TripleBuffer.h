@@ -0,0 +1,70 @@
+#pragma once
+
+// STL includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+///
+/// Lock-free single-producer/single-consumer triple buffer with latest-value-wins semantics.
+///
+/// The producer fills back() and publishes it, the consumer takes the latest published buffer by consume()
+/// and reads it via front(). Producer and consumer never wait for each other: a buffer published while the
+/// previous one was not consumed yet replaces it (the older frame is coalesced). The buffers are swapped,
+/// never copied, so their capacity is reused.
+///
+template <typename T>
+class TripleBuffer
+{
+public:
+	///
+	/// @return The buffer owned by the producer, to be filled before publish()
+	///
+	T& back() { return _buffers[_back]; }
+
+	///
+	/// Publishes the back buffer to the consumer (producer only)
+	///
+	/// @return True, if the previously published buffer had not been consumed and was coalesced
+	///
+	bool publish()
+	{
+		const uint8_t previous = _middle.exchange(static_cast<uint8_t>(_back | FRESH), std::memory_order_acq_rel);
+		_back = previous & INDEX_MASK;
+		return (previous & FRESH) != 0;
+	}
+
+	///
+	/// Takes the latest published buffer as the front buffer (consumer only)
+	///
+	/// @return True, if a buffer was published since the last call
+	///
+	bool consume()
+	{
+		if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+		{
+			return false;
+		}
+		const uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+		_front = previous & INDEX_MASK;
+		return true;
+	}
+
+	///
+	/// @return The buffer owned by the consumer, as taken by consume()
+	///
+	T& front() { return _buffers[_front]; }
+	const T& front() const { return _buffers[_front]; }
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	static constexpr uint8_t FRESH = 0x4;
+
+	std::array<T, 3> _buffers {};
+
+	/// Index of the buffer exchanged between producer and consumer, flagged FRESH when published
+	std::atomic<uint8_t> _middle { 1 };
+
+	uint8_t _back = 0;
+	uint8_t _front = 2;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+// JSON-Schema includes
+#include <utils/jsonschema/QJsonSchemaChecker.h>
+
+#include <QJsonObject>
+#include <QString>
+
+///
+/// Cache of JSON schemas read from files or resources, e.g. the JSON-RPC schemas validating every API message.
+///
+/// A schema is read, parsed and its $refs resolved once; later requests get the cached schema.
+/// Schema checkers set up for a schema are kept per thread and reused, as a checker holds the state of the
+/// validation running.
+///
+class QJsonSchemaCache
+{
+public:
+	///
+	/// @brief Get a schema with resolved references, read on first use
+	/// @param[in] path The schema file path or resource
+	/// @return The schema
+	/// @throws std::runtime_error, if the schema cannot be read or is invalid
+	///
+	static QJsonObject getSchema(const QString& path);
+
+	///
+	/// @brief Get a schema checker set up for a schema, reused by later calls of the same thread
+	/// @param[in] path The schema file path or resource
+	/// @return The schema checker, valid for the calling thread only
+	/// @throws std::runtime_error, if the schema cannot be read or is invalid
+	///
+	static QJsonSchemaChecker& getChecker(const QString& path);
+};
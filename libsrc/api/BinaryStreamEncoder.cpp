@@ -0,0 +1,143 @@
+#include <api/BinaryStreamEncoder.h>
+
+// STL includes
+#include <algorithm>
+#include <cstring>
+
+// Qt includes
+#include <QtEndian>
+
+namespace {
+
+/// Size of a run's header (first LED, number of LEDs)
+constexpr int RUN_HEADER_SIZE = 4;
+
+/// Unchanged LEDs between two runs, which are sent rather than starting a new run (3 bytes each vs. a run header)
+constexpr size_t MAX_RUN_GAP = 1;
+
+/// Delta-encoded runs address LEDs by 16 bit
+constexpr size_t MAX_DELTA_LEDS = 65535;
+
+} // namespace
+
+BinaryStreamEncoder::BinaryStreamEncoder(bool isDeltaEncoding)
+	: _isDeltaEncoding(isDeltaEncoding)
+	, _framesSinceKeyframe(0)
+	, _ledSequence(0)
+	, _imageSequence(0)
+{
+}
+
+void BinaryStreamEncoder::reset()
+{
+	_previousLedColors.clear();
+	_framesSinceKeyframe = 0;
+}
+
+void BinaryStreamEncoder::writeHeader(char* data, MessageType type, uint8_t instance, uint16_t sequence, uint32_t value)
+{
+	data[0] = static_cast<char>(type);
+	data[1] = static_cast<char>(instance);
+	qToBigEndian<quint16>(sequence, data + 2);
+	qToBigEndian<quint32>(value, data + 4);
+}
+
+QByteArray BinaryStreamEncoder::encodeLedColors(const std::vector<ColorRgb>& ledColors, uint8_t instance)
+{
+	const int frameSize = static_cast<int>(ledColors.size() * sizeof(ColorRgb));
+
+	QByteArray message;
+	bool isDelta = false;
+	if (_isDeltaEncoding
+		&& _previousLedColors.size() == ledColors.size()
+		&& ledColors.size() <= MAX_DELTA_LEDS
+		&& _framesSinceKeyframe < KEYFRAME_INTERVAL)
+	{
+		message.reserve(HEADER_SIZE + frameSize);
+		message.resize(HEADER_SIZE);
+		isDelta = appendDelta(ledColors, message);
+	}
+
+	if (isDelta)
+	{
+		++_framesSinceKeyframe;
+	}
+	else
+	{
+		message.resize(HEADER_SIZE + frameSize);
+		memcpy(message.data() + HEADER_SIZE, ledColors.data(), static_cast<size_t>(frameSize));
+		_framesSinceKeyframe = 0;
+	}
+
+	writeHeader(message.data(), isDelta ? LED_COLORS_DELTA : LED_COLORS, instance, _ledSequence++, static_cast<uint32_t>(ledColors.size()));
+
+	if (_isDeltaEncoding)
+	{
+		_previousLedColors = ledColors;
+	}
+	return message;
+}
+
+bool BinaryStreamEncoder::appendDelta(const std::vector<ColorRgb>& ledColors, QByteArray& message) const
+{
+	const size_t ledCount = ledColors.size();
+	const int maxSize = HEADER_SIZE + static_cast<int>(ledCount * sizeof(ColorRgb));
+
+	size_t led = 0;
+	while (led < ledCount)
+	{
+		// Find the next changed LED
+		while (led < ledCount && ledColors[led] == _previousLedColors[led])
+		{
+			++led;
+		}
+		if (led == ledCount)
+		{
+			break;
+		}
+
+		// Extend the run till more than MAX_RUN_GAP unchanged LEDs follow
+		const size_t first = led;
+		size_t end = led + 1;
+		size_t gap = 0;
+		for (size_t i = end; i < ledCount && gap <= MAX_RUN_GAP; ++i)
+		{
+			if (ledColors[i] == _previousLedColors[i])
+			{
+				++gap;
+			}
+			else
+			{
+				gap = 0;
+				end = i + 1;
+			}
+		}
+
+		const size_t count = end - first;
+		const int runSize = RUN_HEADER_SIZE + static_cast<int>(count * sizeof(ColorRgb));
+		if (message.size() + runSize >= maxSize)
+		{
+			return false;
+		}
+
+		const int offset = message.size();
+		message.resize(offset + runSize);
+		char* run = message.data() + offset;
+		qToBigEndian<quint16>(static_cast<quint16>(first), run);
+		qToBigEndian<quint16>(static_cast<quint16>(count), run + 2);
+		memcpy(run + RUN_HEADER_SIZE, ledColors.data() + first, count * sizeof(ColorRgb));
+
+		led = end;
+	}
+	return true;
+}
+
+QByteArray BinaryStreamEncoder::encodeImage(const QByteArray& jpegData, int width, int height, uint8_t instance)
+{
+	QByteArray message;
+	message.resize(HEADER_SIZE + jpegData.size());
+	const uint32_t size = (static_cast<uint32_t>(std::min(width, 0xFFFF)) << 16) | static_cast<uint32_t>(std::min(height, 0xFFFF));
+	writeHeader(message.data(), IMAGE_JPEG, instance, _imageSequence++, size);
+	memcpy(message.data() + HEADER_SIZE, jpegData.constData(), static_cast<size_t>(jpegData.size()));
+	return message;
+}
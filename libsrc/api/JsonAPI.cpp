@@ -29,6 +29,7 @@
 #include <utils/GlobalSignals.h>
 #include <utils/jsonschema/QJsonFactory.h>
 #include <utils/jsonschema/QJsonSchemaChecker.h>
+#include <utils/jsonschema/QJsonSchemaCache.h>
 #include <utils/ColorSys.h>
 #include <utils/KelvinToRgb.h>
 #include <utils/Process.h>
@@ -177,9 +178,8 @@ void JsonAPI::handleMessage(const QString &messageString, const QString &httpAut
 		tan = message["tan"].toInt();
 	}
 
-	// check basic message
-	QJsonObject schemaJson = QJsonFactory::readSchema(":schema");
-	QPair<bool, QStringList> validationResult = JsonUtils::validate(ident, message, schemaJson, _log);
+	// check basic message, the schemas are read once and their checkers reused
+	QPair<bool, QStringList> validationResult = JsonUtils::validate(ident, message, QJsonSchemaCache::getChecker(":schema"), _log);
 	if (!validationResult.first)
 	{
 		sendErrorReply("Invalid command", validationResult.second, command, tan);
@@ -250,8 +250,7 @@ void JsonAPI::handleMessage(const QString &messageString, const QString &httpAut
 		}
 	}
 
-	schemaJson = QJsonFactory::readSchema(QString(":schema-%1").arg(command));
-	validationResult = JsonUtils::validate(ident, message, schemaJson, _log);
+	validationResult = JsonUtils::validate(ident, message, QJsonSchemaCache::getChecker(QString(":schema-%1").arg(command)), _log);
 	if (!validationResult.first)
 	{
 		sendErrorReply("Invalid params", validationResult.second, cmd);
@@ -705,6 +704,11 @@ void JsonAPI::handleServerInfoCommand(const QJsonObject &message, const JsonApiC
 
 		if (!_noListener && message.contains("subscribe"))
 		{
+			if (!applyStreamFormat(message, errorDetails))
+			{
+				sendErrorReply("Invalid params", errorDetails, cmd);
+				return;
+			}
 			const QJsonArray &subscriptions = message["subscribe"].toArray();
 			QStringList const invaliCommands = _jsonCB->subscribe(subscriptions);
 			if (!invaliCommands.isEmpty())
@@ -729,6 +733,11 @@ void JsonAPI::handleServerInfoCommand(const QJsonObject &message, const JsonApiC
 		QStringList invaliCommands;
 		if (cmd.subCommand == SubCommand::Subscribe)
 		{
+			if (!applyStreamFormat(message, errorDetails))
+			{
+				sendErrorReply("Invalid params", errorDetails, cmd);
+				return;
+			}
 			invaliCommands = _jsonCB->subscribe(subscriptions);
 		}
 		else
@@ -1198,8 +1207,32 @@ void JsonAPI::handleComponentStateCommand(const QJsonObject &message, const Json
 	}
 }
 
-void JsonAPI::handleLedColorsCommand(const QJsonObject& /*message*/, const JsonApiCommand& cmd)
+bool JsonAPI::applyStreamFormat(const QJsonObject& message, QStringList& errorDetails)
 {
+	if (!message.contains("format"))
+	{
+		return true;
+	}
+
+	const QString format = message["format"].toString();
+	if (!_jsonCB->setStreamFormat(format))
+	{
+		errorDetails.append(QString("format - '%1' is not supported by this connection").arg(format));
+		return false;
+	}
+	return true;
+}
+
+void JsonAPI::handleLedColorsCommand(const QJsonObject& message, const JsonApiCommand& cmd)
+{
+	QStringList errorDetails;
+	if ((cmd.subCommand == SubCommand::LedStreamStart || cmd.subCommand == SubCommand::ImageStreamStart)
+		&& !applyStreamFormat(message, errorDetails))
+	{
+		sendErrorReply("Invalid params", errorDetails, cmd);
+		return;
+	}
+
 	switch (cmd.subCommand) {
 	case SubCommand::LedStreamStart:
 		_jsonCB->subscribe( Subscription::LedColorsUpdate);
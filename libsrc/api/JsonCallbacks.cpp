@@ -14,8 +14,6 @@
 
 #include <QDateTime>
 #include <QVariant>
-#include <QImage>
-#include <QBuffer>
 
 using namespace hyperion;
 
@@ -27,6 +25,8 @@ JsonCallbacks::JsonCallbacks(Logger *log, const QString& peerAddress, QObject* p
 	, _componentRegister(nullptr)
 	, _prioMuxer(nullptr)
 	, _islogMsgStreamingActive(false)
+	, _isBinaryStreamingSupported(false)
+	, _isBinaryStreaming(false)
 {
 	qRegisterMetaType<PriorityMuxer::InputsMap>("InputsMap");
 
@@ -114,7 +114,7 @@ bool JsonCallbacks::subscribe(const Subscription::Type cmd)
 	break;
 	case Subscription::ImageUpdate:
 		if (!_hyperion.isNull()) {
-			connect(_hyperion.get(),  &Hyperion::currentImage, this, &JsonCallbacks::handleImageUpdate);
+			connect(_hyperion->getPreviewEncoder(), &PreviewEncoder::previewImage, this, &JsonCallbacks::handleImageUpdate);
 		}
 	break;
 	case Subscription::LedColorsUpdate:
@@ -242,7 +242,7 @@ bool JsonCallbacks::unsubscribe(const Subscription::Type cmd)
 	break;
 	case Subscription::ImageUpdate:
 		if (!_hyperion.isNull()) {
-			disconnect(_hyperion.get(), &Hyperion::currentImage, this, &JsonCallbacks::handleImageUpdate);
+			disconnect(_hyperion->getPreviewEncoder(), &PreviewEncoder::previewImage, this, &JsonCallbacks::handleImageUpdate);
 		}
 	break;
 	case Subscription::LedColorsUpdate:
@@ -323,6 +323,7 @@ void JsonCallbacks::setSubscriptionsTo(quint8 instanceID)
 	resetSubscriptions();
 
 	_instanceID = instanceID;
+	_streamEncoder.reset();
 	// update pointer
 	QSharedPointer<Hyperion> const hyperion =  HyperionIManager::getInstance()->getHyperionInstance(instanceID);
 	if (!hyperion.isNull() && hyperion != _hyperion)
@@ -496,8 +497,43 @@ void JsonCallbacks::handleTokenChange(const QVector<AuthManager::AuthDefinition>
 	doCallback(Subscription::TokenUpdate, arr);
 }
 
+void JsonCallbacks::setBinaryStreamingSupported(bool isSupported)
+{
+	_isBinaryStreamingSupported = isSupported;
+	if (!_isBinaryStreamingSupported)
+	{
+		_isBinaryStreaming = false;
+	}
+}
+
+bool JsonCallbacks::setStreamFormat(const QString& format)
+{
+	if (format == "json")
+	{
+		_isBinaryStreaming = false;
+		return true;
+	}
+
+	if (!_isBinaryStreamingSupported || (format != "binary" && format != "binary-delta"))
+	{
+		return false;
+	}
+
+	_isBinaryStreaming = true;
+	_streamEncoder = BinaryStreamEncoder(format == "binary-delta");
+	Debug(_log, "Streaming LED colors and images as binary messages (%s) to client %s", QSTRING_CSTR(format), QSTRING_CSTR(_peerAddress));
+	return true;
+}
+
 void JsonCallbacks::handleLedColorUpdate(const std::vector<ColorRgb> &ledColors)
 {
+	if (_isBinaryStreaming)
+	{
+		const uint8_t instance = (_instanceID != NO_INSTANCE_ID) ? _instanceID : BinaryStreamEncoder::NO_INSTANCE;
+		emit binaryCallbackReady(_streamEncoder.encodeLedColors(ledColors, instance));
+		return;
+	}
+
 	QJsonObject result;
 	QJsonArray leds;
 
@@ -513,17 +549,18 @@ void JsonCallbacks::handleLedColorUpdate(const std::vector<ColorRgb> &ledColors)
 	doCallback(Subscription::LedColorsUpdate, result);
 }
 
-void JsonCallbacks::handleImageUpdate(const Image<ColorRgb> &image)
+void JsonCallbacks::handleImageUpdate(const PreviewImagePtr &image)
 {
-	int const bytesPerLine = 3 * image.width();
-	QImage const jpgImage(reinterpret_cast<const uchar*>(image.memptr()), image.width(), image.height(), bytesPerLine, QImage::Format_RGB888);
-	QByteArray byteArray;
-	QBuffer buffer(&byteArray);
-	buffer.open(QIODevice::WriteOnly);
-	jpgImage.save(&buffer, "jpg");
+	// The preview is encoded once by the instance and shared by all clients
+	if (_isBinaryStreaming)
+	{
+		const uint8_t instance = (_instanceID != NO_INSTANCE_ID) ? _instanceID : BinaryStreamEncoder::NO_INSTANCE;
+		emit binaryCallbackReady(_streamEncoder.encodeImage(image->jpeg, image->width, image->height, instance));
+		return;
+	}
 
 	QJsonObject result;
-	result["image"] = "data:image/jpg;base64," + QString(byteArray.toBase64());
+	result["image"] = image->dataUrl;
 
 	doCallback(Subscription::ImageUpdate, result);
 }
@@ -6,7 +6,9 @@
 #include <utils/ColorSys.h>
 #include <leddevice/LedDeviceWrapper.h>
 #include <utils/SysInfo.h>
+#include <utils/FramePool.h>
 #include <hyperion/AuthManager.h>
+#include <hyperion/ImageAnalysisCache.h>
 #include <QCoreApplication>
 #include <QApplication>
 #include <QHostInfo>
@@ -14,6 +16,7 @@
 #include <HyperionConfig.h> // Required to determine the cmake options
 
 #include <hyperion/GrabberWrapper.h>
+#include <hyperion/Grabber.h>
 #include <grabber/GrabberConfig.h>
 
 #if defined(ENABLE_EFFECTENGINE)
@@ -48,6 +51,10 @@ QJsonObject JsonInfo::getInfo(const Hyperion* hyperion, Logger* log)
 		info["videomode"] = QString(videoMode2String(hyperion->getCurrentVideoMode()));
 		info["imageToLedMappingType"] = ImageProcessor::mappingTypeToStr(hyperion->getLedMappingType());
 		info["leds"] = hyperion->getSetting(settings::LEDS).array();
+		info["smoothing"] = hyperion->getSmoothingStatistics();
+		info["ledDeviceOutput"] = hyperion->getLedDeviceStatistics();
+		info["inputImages"] = hyperion->getInputImageStatistics();
+		info["previewImages"] = hyperion->getPreviewStatistics();
 	}
 	else
 	{
@@ -55,6 +62,9 @@ QJsonObject JsonInfo::getInfo(const Hyperion* hyperion, Logger* log)
 		info["videomode"] = QString(videoMode2String(VideoMode::VIDEO_2D));
 		info["imageToLedMappingType"] = ImageProcessor::mappingTypeToStr(0);
 		info["leds"] = QJsonArray();
+		info["smoothing"] = QJsonObject();
+		info["ledDeviceOutput"] = QJsonObject();
+		info["inputImages"] = QJsonObject();
 	}
 
 	// BEGIN | The following entries are deprecated but used to ensure backward compatibility with hyperion Classic or up to Hyperion 2.0.16
@@ -350,6 +360,13 @@ QJsonObject JsonInfo::getGrabbers(const Hyperion* hyperion)
 	}
 	videoGrabbers["available"] = getAvailableVideoGrabbers();
 
+	const Grabber::DecodingStatistics decodingStatistics = Grabber::getDecodingStatistics();
+	QJsonObject decoding;
+	decoding["decodedFrames"] = static_cast<qint64>(decodingStatistics.decodedFrames);
+	decoding["droppedFrames"] = static_cast<qint64>(decodingStatistics.droppedFrames);
+	decoding["reorderedFrames"] = static_cast<qint64>(decodingStatistics.reorderedFrames);
+	videoGrabbers["decoding"] = decoding;
+
 	// AUDIO
 	QJsonObject audioGrabbers;
 	if (GrabberWrapper::getInstance() != nullptr)
@@ -630,6 +647,20 @@ QJsonObject JsonInfo::getSystemInfo()
 	QCoreApplication* app = QCoreApplication::instance();
 	hyperionInfo["isGuiMode"] = qobject_cast<QApplication*>(app) != nullptr;
 
+	const FramePool::Statistics framePoolStatistics = FramePool::statistics();
+	QJsonObject framePool;
+	framePool["hits"] = static_cast<qint64>(framePoolStatistics.hits);
+	framePool["misses"] = static_cast<qint64>(framePoolStatistics.misses);
+	framePool["discards"] = static_cast<qint64>(framePoolStatistics.discards);
+	framePool["cachedBytes"] = static_cast<qint64>(framePoolStatistics.cachedBytes);
+	hyperionInfo["framePool"] = framePool;
+
+	const ImageAnalysisCache::Statistics analysisCacheStatistics = ImageAnalysisCache::getInstance().statistics();
+	QJsonObject analysisCache;
+	analysisCache["hits"] = static_cast<qint64>(analysisCacheStatistics.hits);
+	analysisCache["misses"] = static_cast<qint64>(analysisCacheStatistics.misses);
+	hyperionInfo["imageAnalysisCache"] = analysisCache;
+
 	info["hyperion"] = hyperionInfo;
 
 	return info;
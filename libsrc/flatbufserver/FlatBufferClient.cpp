@@ -51,21 +51,13 @@ void FlatBufferClient::readyRead()
 	if (_socket == nullptr) { return; }
 
 	_timeoutTimer->start();
-	_receiveBuffer += _socket->readAll();
 
-	// check if we can read a header
-	while(_receiveBuffer.size() >= 4)
+	// read complete messages straight from the socket, the message is valid till the next read
+	FramedReader::Result result;
+	while ((result = _messageReader.read(_socket)) == FramedReader::Result::MessageReady)
 	{
-		// Directly read message size
-		const uint8_t* raw = reinterpret_cast<const uint8_t*>(_receiveBuffer.constData());
-		uint32_t const messageSize = (raw[0] << 24) | (raw[1] << 16) | (raw[2] << 8) | raw[3];
-
-		// check if we can read a complete message
-		if((uint32_t) _receiveBuffer.size() < messageSize + 4) { return; }
-
-		// extract message without header and remove header + msg from buffer :: QByteArray::remove() does not return the removed data
-		const uint8_t* msgData = reinterpret_cast<const uint8_t*>(_receiveBuffer.constData() + 4);
-		_receiveBuffer.remove(0, messageSize + 4);
+		const uint8_t* msgData = _messageReader.data();
+		uint32_t const messageSize = _messageReader.size();
 
 		flatbuffers::Verifier verifier(msgData, messageSize);
 
@@ -78,6 +70,13 @@ void FlatBufferClient::readyRead()
 		const auto *message = hyperionnet::GetRequest(msgData);
 		handleMessage(message);
 	}
+
+	if (result == FramedReader::Result::MessageTooLarge)
+	{
+		Error(_log, "Message of %u bytes exceeds the limit - drop connection with client \"%s\"", _messageReader.size(), QSTRING_CSTR(QString("%1@%2").arg(_origin, _clientAddress)));
+		sendErrorReply("Message too large");
+		forceClose();
+	}
 }
 
 void FlatBufferClient::noDataReceived()
@@ -7,6 +7,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/Components.h>
 #include "utils/ImageResampler.h"
+#include <utils/FramedReader.h>
 
 // flatbuffer FBS
 #include "hyperion_request_generated.h"
@@ -155,7 +156,7 @@ private:
 	int _timeout;
 	int _priority;
 
-	QByteArray _receiveBuffer;
+	FramedReader _messageReader;
 
 	ImageResampler _imageResampler;
 	Image<ColorRgb> _imageOutputBuffer;
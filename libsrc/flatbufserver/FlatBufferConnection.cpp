@@ -68,6 +68,9 @@ void FlatBufferConnection::onDisconnected()
 
 void FlatBufferConnection::onConnected()
 {
+	// discard a partial reply of a previous connection
+	_replyReader.reset();
+
 	Info(_log, "Connected to target host: %s, port [%u]", QSTRING_CSTR(_host.toString()), _port);
 	if (!isClientRegistered())
 	{
@@ -164,25 +167,12 @@ void FlatBufferConnection::clearAllPriorities()
 
 void FlatBufferConnection::readData()
 {
-	_receiveBuffer += _socket.readAll();
-
-	// check if we can read a header
-	while(_receiveBuffer.size() >= 4)
+	// read complete replies straight from the socket, the reply is valid till the next read
+	FramedReader::Result result;
+	while ((result = _replyReader.read(&_socket)) == FramedReader::Result::MessageReady)
 	{
-		uint32_t messageSize =
-				((_receiveBuffer[0]<<24) & 0xFF000000) |
-				((_receiveBuffer[1]<<16) & 0x00FF0000) |
-				((_receiveBuffer[2]<< 8) & 0x0000FF00) |
-				((_receiveBuffer[3]    ) & 0x000000FF);
-
-		// check if we can read a complete message
-		if((uint32_t) _receiveBuffer.size() < messageSize + 4) return;
-
-		// extract message only and remove header + msg from buffer :: QByteArray::remove() does not return the removed data
-		const QByteArray msg = _receiveBuffer.mid(4, messageSize);
-		_receiveBuffer.remove(0, messageSize + 4);
-		const uint8_t* msgData = reinterpret_cast<const uint8_t*>(msg.constData());
-		flatbuffers::Verifier verifier(msgData, messageSize);
+		const uint8_t* msgData = _replyReader.data();
+		flatbuffers::Verifier verifier(msgData, _replyReader.size());
 
 		if (hyperionnet::VerifyReplyBuffer(verifier))
 		{
@@ -191,6 +181,12 @@ void FlatBufferConnection::readData()
 		}
 		Error(_log, "Unable to parse reply");
 	}
+
+	if (result == FramedReader::Result::MessageTooLarge)
+	{
+		Error(_log, "Reply of %u bytes exceeds the limit - drop connection with host: %s, port [%u]", _replyReader.size(), QSTRING_CSTR(_host.toString()), _port);
+		_socket.close();
+	}
 }
 
 void FlatBufferConnection::setSkipReply(bool skip)
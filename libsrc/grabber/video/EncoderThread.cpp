@@ -1,9 +1,14 @@
 #include "grabber/video/EncoderThread.h"
 
 #include <QDebug>
+#include <QMutexLocker>
+
+// Hyperion includes
+#include <hyperion/Grabber.h>
 
 EncoderThread::EncoderThread()
 	: _localData(nullptr)
+	, _frameData(nullptr)
 	, _scalingFactorsCount(0)
 	, _doTransform(false)
 	,_imageResampler()
@@ -36,11 +41,25 @@ EncoderThread::~EncoderThread()
 	}
 }
 
-void EncoderThread::setup(
+void EncoderThread::lend(
 		PixelFormat pixelFormat, uint8_t* sharedData,
 		int size, int width, int height, int lineLength,
 		int cropLeft, int cropTop, int cropBottom, int cropRight,
 		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
+{
+	configure(pixelFormat, size, width, height, lineLength,
+			  cropLeft, cropTop, cropBottom, cropRight,
+			  videoMode, flipMode, pixelDecimation);
+
+	_frameData = sharedData;
+
+	QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
+}
+
+void EncoderThread::configure(
+		PixelFormat pixelFormat, int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation)
 {
 	_lineLength = lineLength;
 	_pixelFormat = pixelFormat;
@@ -85,33 +104,10 @@ void EncoderThread::setup(
 	_imageResampler.setCropping(_cropLeft, _cropRight, _cropTop, _cropBottom);
 	_imageResampler.setHorizontalPixelDecimation(_pixelDecimation);
 	_imageResampler.setVerticalPixelDecimation(_pixelDecimation);
-
-#ifdef HAVE_TURBO_JPEG
-	if (_localData != nullptr)
-	{
-		tjFree(_localData);
-		_localData = nullptr;
-	}
-	_localData = static_cast<uint8_t*>(tjAlloc(size + 1));
-#else
-	if (_localData != nullptr)
-	{
-		delete[] _localData;
-		_localData = nullptr;
-	}
-
-	_localData = new uint8_t[size];
-#endif
-
-	if (_localData != nullptr)
-	{
-		memcpy(_localData, sharedData, static_cast<size_t>(size));
-	}
 }
 
 void EncoderThread::process()
 {
-	_busy = true;
 	if (_width > 0 && _height > 0)
 	{
 #ifdef HAVE_TURBO_JPEG
@@ -124,7 +120,7 @@ void EncoderThread::process()
 		{
 			Image<ColorRgb> image = Image<ColorRgb>();
 			_imageResampler.processImage(
-				_localData,
+				_frameData,
 				_width,
 				_height,
 				_lineLength,
@@ -139,7 +135,8 @@ void EncoderThread::process()
 			emit newFrame(image);
 		}
 	}
-	_busy = false;
+
+	emit frameProcessed();
 }
 
 #ifdef HAVE_TURBO_JPEG
@@ -156,7 +153,7 @@ void EncoderThread::processImageMjpeg()
 			_xform = new tjtransform();
 		}
 
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("_doTransform - tjDecompressHeader3"))
 			{
@@ -237,7 +234,7 @@ void EncoderThread::processImageMjpeg()
 		unsigned char *dstBuf = nullptr;  /* Dynamically allocate the JPEG buffer */
 		unsigned long dstSize = 0;
 
-		if(tjTransform(_tjInstance, _localData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) < 0 )
+		if(tjTransform(_tjInstance, _frameData, _size, 1, &dstBuf, &dstSize, _xform, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE) < 0 )
 		{
 			if (onError("_doTransform - tjTransform"))
 			{
@@ -245,8 +242,13 @@ void EncoderThread::processImageMjpeg()
 			}
 		}
 
-		tjFree(_localData);
+		// The transformed frame is owned by the encoder, a lent buffer is not needed any longer
+		if (_localData != nullptr)
+		{
+			tjFree(_localData);
+		}
 		_localData = dstBuf;
+		_frameData = _localData;
 		_size = dstSize;
 	}
 	else
@@ -259,7 +261,7 @@ void EncoderThread::processImageMjpeg()
 
 	if (_doTransform)
 	{
-		if (tjDecompressHeader3(_tjInstance, _localData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
+		if (tjDecompressHeader3(_tjInstance, _frameData, _size, &_width, &_height,	&inSubsamp, &inColorspace) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader3"))
 			{
@@ -269,7 +271,7 @@ void EncoderThread::processImageMjpeg()
 	}
 	else
 	{
-		if (tjDecompressHeader2(_tjInstance, _localData, _size, &_width, &_height, &inSubsamp) < 0)
+		if (tjDecompressHeader2(_tjInstance, _frameData, _size, &_width, &_height, &inSubsamp) < 0)
 		{
 			if (onError("get image details - tjDecompressHeader2"))
 			{
@@ -308,7 +310,7 @@ void EncoderThread::processImageMjpeg()
 
 	Image<ColorRgb> srcImage(_width, _height);
 
-	if (tjDecompress2(_tjInstance, _localData , _size,
+	if (tjDecompress2(_tjInstance, _frameData , _size,
 					  reinterpret_cast<unsigned char*>(srcImage.memptr()), _width, 0, _height,
 					  TJPF_RGB, TJFLAG_FASTDCT | TJFLAG_FASTUPSAMPLE)
 		< 0)
@@ -339,3 +341,261 @@ bool EncoderThread::onError(const QString context) const
 return treatAsError;
 }
 #endif
+
+EncoderThreadManager::EncoderThreadManager(QObject *parent)
+	: QObject(parent)
+	, _threadCount(qMax(QThread::idealThreadCount(), DEFAULT_THREAD_COUNT))
+	, _threads(nullptr)
+	, _running(false)
+	, _lentBuffersInUse(0)
+	, _nextSequence(0)
+	, _nextEmitSequence(0)
+{
+	_threads = new Thread<EncoderThread>*[_threadCount];
+	_activeJobs.resize(static_cast<size_t>(_threadCount));
+	_threadActive.assign(static_cast<size_t>(_threadCount), false);
+	_threadReadsLentBuffer.assign(static_cast<size_t>(_threadCount), false);
+
+	for (int i = 0; i < _threadCount; i++)
+	{
+		_threads[i] = new Thread<EncoderThread>(new EncoderThread, this);
+		_threads[i]->setObjectName("Encoder " + QString::number(i));
+
+		// Delivered in the manager's thread, frameProcessed() always after the corresponding newFrame()
+		connect(_threads[i]->thread(), &EncoderThread::newFrame, this, [this, i](const Image<ColorRgb>& image) { frameDecoded(i, image); });
+		connect(_threads[i]->thread(), &EncoderThread::frameProcessed, this, [this, i]() { frameProcessed(i); });
+		// Counted down in the encoder's thread, so that waitForLentBuffers() does not depend on the manager's event loop
+		connect(_threads[i]->thread(), &EncoderThread::frameProcessed, this, [this, i]() { lentBufferDone(i); }, Qt::DirectConnection);
+	}
+}
+
+EncoderThreadManager::~EncoderThreadManager()
+{
+	if (_threads != nullptr)
+	{
+		// Joins the encoder threads, before the jobs they are processing are destroyed
+		for(int i = 0; i < _threadCount; i++)
+		{
+			delete _threads[i];
+			_threads[i] = nullptr;
+		}
+
+		delete[] _threads;
+		_threads = nullptr;
+	}
+}
+
+void EncoderThreadManager::start()
+{
+	QMutexLocker locker(&_mutex);
+
+	// Frames of a previous run still being processed are not emitted
+	_finishedJobs.clear();
+	_nextEmitSequence = _nextSequence;
+	_running = true;
+}
+
+void EncoderThreadManager::stop()
+{
+	QVector<int> releasedBuffers;
+	{
+		QMutexLocker locker(&_mutex);
+		_running = false;
+
+		for (Job& job : _queue)
+		{
+			releaseJob(job, releasedBuffers);
+		}
+		_queue.clear();
+		_finishedJobs.clear();
+	}
+
+	for (int bufferIndex : releasedBuffers)
+	{
+		emit bufferReleased(bufferIndex);
+	}
+}
+
+bool EncoderThreadManager::submit(
+		PixelFormat pixelFormat, uint8_t* sharedData,
+		int size, int width, int height, int lineLength,
+		int cropLeft, int cropTop, int cropBottom, int cropRight,
+		VideoMode videoMode, FlipMode flipMode, int pixelDecimation,
+		int bufferIndex)
+{
+	QVector<int> releasedBuffers;
+	{
+		QMutexLocker locker(&_mutex);
+		if (!_running || _threads == nullptr)
+		{
+			return false;
+		}
+
+		Job job {
+			pixelFormat, sharedData, size, width, height, lineLength,
+			cropLeft, cropTop, cropBottom, cropRight,
+			videoMode, flipMode, pixelDecimation,
+			bufferIndex, {}, 0, false, Image<ColorRgb>()
+		};
+
+		int idleThread = -1;
+		for (int i = 0; i < _threadCount; i++)
+		{
+			if (!_threadActive[static_cast<size_t>(i)])
+			{
+				idleThread = i;
+				break;
+			}
+		}
+
+		// A frame not lent must be copied, as the grabber reuses its buffer
+		if (bufferIndex < 0)
+		{
+			if (!_freeStorage.empty())
+			{
+				job.storage = std::move(_freeStorage.back());
+				_freeStorage.pop_back();
+			}
+			job.storage.assign(sharedData, sharedData + size);
+			job.data = job.storage.data();
+		}
+
+		if (idleThread >= 0 && _queue.empty())
+		{
+			dispatch(idleThread, std::move(job));
+		}
+		else
+		{
+			if (_queue.size() >= static_cast<size_t>(DEFAULT_QUEUE_SIZE))
+			{
+				releaseJob(_queue.front(), releasedBuffers);
+				_queue.pop_front();
+				Grabber::addDecodingStatistics({0, 1, 0});
+			}
+			_queue.push_back(std::move(job));
+		}
+	}
+
+	for (int releasedBuffer : releasedBuffers)
+	{
+		emit bufferReleased(releasedBuffer);
+	}
+	return true;
+}
+
+void EncoderThreadManager::waitForLentBuffers()
+{
+	QMutexLocker locker(&_mutex);
+	while (_lentBuffersInUse > 0)
+	{
+		_lentBuffersDone.wait(&_mutex);
+	}
+}
+
+void EncoderThreadManager::dispatch(int threadIndex, Job&& job)
+{
+	Job& activeJob = _activeJobs[static_cast<size_t>(threadIndex)];
+	activeJob = std::move(job);
+	activeJob.sequence = _nextSequence++;
+	activeJob.decoded = false;
+	_threadActive[static_cast<size_t>(threadIndex)] = true;
+	if (activeJob.bufferIndex >= 0)
+	{
+		_threadReadsLentBuffer[static_cast<size_t>(threadIndex)] = true;
+		++_lentBuffersInUse;
+	}
+
+	_threads[threadIndex]->lend(activeJob.pixelFormat, activeJob.data,
+		activeJob.size, activeJob.width, activeJob.height, activeJob.lineLength,
+		activeJob.cropLeft, activeJob.cropTop, activeJob.cropBottom, activeJob.cropRight,
+		activeJob.videoMode, activeJob.flipMode, activeJob.pixelDecimation);
+}
+
+void EncoderThreadManager::releaseJob(Job& job, QVector<int>& releasedBuffers)
+{
+	if (job.bufferIndex >= 0)
+	{
+		releasedBuffers.append(job.bufferIndex);
+		job.bufferIndex = -1;
+	}
+	else if (job.storage.capacity() > 0)
+	{
+		_freeStorage.push_back(std::move(job.storage));
+		job.storage = std::vector<uint8_t>();
+	}
+	job.data = nullptr;
+}
+
+void EncoderThreadManager::lentBufferDone(int threadIndex)
+{
+	QMutexLocker locker(&_mutex);
+
+	if (_threadReadsLentBuffer[static_cast<size_t>(threadIndex)])
+	{
+		_threadReadsLentBuffer[static_cast<size_t>(threadIndex)] = false;
+		if (--_lentBuffersInUse == 0)
+		{
+			_lentBuffersDone.wakeAll();
+		}
+	}
+}
+
+void EncoderThreadManager::frameDecoded(int threadIndex, const Image<ColorRgb>& image)
+{
+	QMutexLocker locker(&_mutex);
+
+	Job& job = _activeJobs[static_cast<size_t>(threadIndex)];
+	job.image = image;
+	job.decoded = true;
+}
+
+void EncoderThreadManager::frameProcessed(int threadIndex)
+{
+	QVector<int> releasedBuffers;
+	QVector<Image<ColorRgb>> frames;
+	{
+		QMutexLocker locker(&_mutex);
+
+		Job& job = _activeJobs[static_cast<size_t>(threadIndex)];
+		releaseJob(job, releasedBuffers);
+		_threadActive[static_cast<size_t>(threadIndex)] = false;
+
+		if (_running && job.sequence >= _nextEmitSequence)
+		{
+			if (job.sequence != _nextEmitSequence)
+			{
+				// An earlier frame is still being decoded
+				Grabber::addDecodingStatistics({0, 0, 1});
+			}
+			_finishedJobs.emplace(job.sequence, std::move(job));
+		}
+		job = Job();
+
+		// Emit all frames finished in capture order
+		for (auto it = _finishedJobs.begin(); it != _finishedJobs.end() && it->first == _nextEmitSequence; it = _finishedJobs.erase(it))
+		{
+			if (it->second.decoded)
+			{
+				frames.append(it->second.image);
+			}
+			++_nextEmitSequence;
+		}
+
+		if (_running && !_queue.empty())
+		{
+			dispatch(threadIndex, std::move(_queue.front()));
+			_queue.pop_front();
+		}
+	}
+
+	for (int bufferIndex : releasedBuffers)
+	{
+		emit bufferReleased(bufferIndex);
+	}
+
+	Grabber::addDecodingStatistics({static_cast<quint64>(frames.size()), 0, 0});
+	for (const Image<ColorRgb>& frame : frames)
+	{
+		emit newFrame(frame);
+	}
+}
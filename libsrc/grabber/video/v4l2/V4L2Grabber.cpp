@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -22,11 +23,21 @@
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QSet>
+#include <QThread>
+#include <QCoreApplication>
 
 #include "grabber/video/v4l2/V4L2Grabber.h"
 
 #define CLEAR(x) memset(&(x), 0, sizeof(x))
 
+namespace {
+// Capture buffers never lent to the encoder pipeline, so that capturing never stalls
+constexpr unsigned int SPARE_CAPTURE_BUFFERS = 2;
+// Minimum and maximum (VIDEO_MAX_FRAME) number of capture buffers
+constexpr unsigned int MIN_CAPTURE_BUFFERS = 4;
+constexpr unsigned int MAX_CAPTURE_BUFFERS = 32;
+} // namespace
+
 #ifndef V4L2_CAP_META_CAPTURE
 	#define V4L2_CAP_META_CAPTURE 0x00800000 // Specified in kernel header v4.16. Required for backward compatibility.
 #endif
@@ -209,6 +220,7 @@ bool V4L2Grabber::start()
 		if (init() && _streamNotifier != nullptr && !_streamNotifier->isEnabled())
 		{
 			connect(_threadManager, &EncoderThreadManager::newFrame, this, &V4L2Grabber::newThreadFrame);
+			connect(_threadManager, &EncoderThreadManager::bufferReleased, this, &V4L2Grabber::releaseBuffer);
 			_threadManager->start();
 			DebugIf(verbose, _log, "Decoding threads: %u", _threadManager->_threadCount);
 
@@ -232,6 +244,12 @@ void V4L2Grabber::stop()
 	{
 		_initialized = false;
 		_threadManager->stop();
+
+		// Buffers lent to the encoder threads must not be unmapped while being decoded
+		_threadManager->waitForLentBuffers();
+		// Deliver pending buffer releases, before the buffers are reset
+		QCoreApplication::sendPostedEvents(_threadManager, QEvent::MetaCall);
+
 		disconnect(_threadManager, nullptr, nullptr, nullptr);
 		stop_capturing();
 		_streamNotifier->setEnabled(false);
@@ -308,7 +326,7 @@ void V4L2Grabber::init_mmap()
 
 	CLEAR(req);
 
-	req.count = 4;
+	req.count = captureBufferCount();
 	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	req.memory = V4L2_MEMORY_MMAP;
 
@@ -372,7 +390,7 @@ void V4L2Grabber::init_userp(unsigned int buffer_size)
 
 	CLEAR(req);
 
-	req.count  = 4;
+	req.count  = captureBufferCount();
 	req.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	req.memory = V4L2_MEMORY_USERPTR;
 
@@ -390,9 +408,9 @@ void V4L2Grabber::init_userp(unsigned int buffer_size)
 		}
 	}
 
-	_buffers.resize(4);
+	_buffers.resize(req.count);
 
-	for (size_t n_buffers = 0; n_buffers < 4; ++n_buffers)
+	for (size_t n_buffers = 0; n_buffers < req.count; ++n_buffers)
 	{
 		_buffers[n_buffers].length = buffer_size;
 		_buffers[n_buffers].start = malloc(buffer_size);
@@ -961,9 +979,10 @@ int V4L2Grabber::read_frame()
 
 				assert(buf.index < _buffers.size());
 
-				rc = process_image(_buffers[buf.index].start, buf.bytesused);
+				// The mmap'ed buffer is lent to an encoder thread and queued again, when released
+				rc = process_image(_buffers[buf.index].start, buf.bytesused, static_cast<int>(buf.index));
 
-				if (-1 == xioctl(VIDIOC_QBUF, &buf))
+				if (!_buffers[buf.index].lent && -1 == xioctl(VIDIOC_QBUF, &buf))
 				{
 					throw_errno_exception("VIDIOC_QBUF");
 					return 0;
@@ -996,17 +1015,20 @@ int V4L2Grabber::read_frame()
 					}
 				}
 
+				int bufferIndex = -1;
 				for (size_t i = 0; i < _buffers.size(); ++i)
 				{
 					if (buf.m.userptr == (unsigned long)_buffers[i].start && buf.length == _buffers[i].length)
 					{
+						bufferIndex = static_cast<int>(i);
 						break;
 					}
 				}
 
-				rc = process_image((void *)buf.m.userptr, buf.bytesused);
+				// Known buffers are lent to an encoder thread and queued again, when released
+				rc = process_image((void *)buf.m.userptr, buf.bytesused, bufferIndex);
 
-				if (!rc && -1 == xioctl(VIDIOC_QBUF, &buf))
+				if ((bufferIndex < 0 || !_buffers[bufferIndex].lent) && -1 == xioctl(VIDIOC_QBUF, &buf))
 				{
 					throw_errno_exception("VIDIOC_QBUF");
 					return 0;
@@ -1024,7 +1046,7 @@ int V4L2Grabber::read_frame()
 	return rc ? 1 : 0;
 }
 
-bool V4L2Grabber::process_image(const void *p, int size)
+bool V4L2Grabber::process_image(const void *p, int size, int bufferIndex)
 {
 	int processFrameIndex = _currentFrame++, result = false;
 
@@ -1042,21 +1064,73 @@ bool V4L2Grabber::process_image(const void *p, int size)
 	}
 	else if (_threadManager != nullptr)
 	{
-		for (int i = 0; i < _threadManager->_threadCount; i++)
+		if (bufferIndex >= 0)
 		{
-			if (!_threadManager->_threads[i]->isBusy())
+			// Keep the spare buffers queued for capturing, the frame is copied instead
+			const size_t lentBuffers = static_cast<size_t>(std::count_if(_buffers.begin(), _buffers.end(), [](const buffer& b) { return b.lent; }));
+			if (lentBuffers + SPARE_CAPTURE_BUFFERS >= _buffers.size())
 			{
-				_threadManager->_threads[i]->setup(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation);
-				_threadManager->_threads[i]->process();
-				result = true;
-				break;
+				bufferIndex = -1;
+			}
+			else
+			{
+				_buffers[bufferIndex].lent = true;
 			}
 		}
+
+		result = _threadManager->submit(_pixelFormat, (uint8_t*)p, size, _width, _height, _lineLength, _cropLeft, _cropTop, _cropBottom, _cropRight, _videoMode, _flipMode, _pixelDecimation, bufferIndex);
+
+		if (!result && bufferIndex >= 0)
+		{
+			_buffers[bufferIndex].lent = false;
+		}
 	}
 
 	return result;
 }
 
+unsigned int V4L2Grabber::captureBufferCount() const
+{
+	// Every encoder thread and every frame queued for the encoder threads may hold a lent buffer
+	const unsigned int lentBuffers = (_threadManager != nullptr) ? static_cast<unsigned int>(_threadManager->_threadCount + DEFAULT_QUEUE_SIZE) : 0;
+
+	return qBound(MIN_CAPTURE_BUFFERS, lentBuffers + SPARE_CAPTURE_BUFFERS, MAX_CAPTURE_BUFFERS);
+}
+
+void V4L2Grabber::releaseBuffer(int bufferIndex)
+{
+	// Ignore buffers of a stopped capture session
+	if (bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= _buffers.size() || !_buffers[bufferIndex].lent)
+		return;
+
+	_buffers[bufferIndex].lent = false;
+
+	if (!_initialized)
+		return;
+
+	struct v4l2_buffer buf;
+
+	CLEAR(buf);
+	buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buf.index = static_cast<unsigned int>(bufferIndex);
+
+	if (_ioMethod == IO_METHOD_USERPTR)
+	{
+		buf.memory = V4L2_MEMORY_USERPTR;
+		buf.m.userptr = (unsigned long)_buffers[bufferIndex].start;
+		buf.length = _buffers[bufferIndex].length;
+	}
+	else
+	{
+		buf.memory = V4L2_MEMORY_MMAP;
+	}
+
+	if (-1 == xioctl(VIDIOC_QBUF, &buf))
+	{
+		throw_errno_exception("VIDIOC_QBUF");
+	}
+}
+
 void V4L2Grabber::newThreadFrame(Image<ColorRgb> image)
 {
 	if (_standbyActivated)
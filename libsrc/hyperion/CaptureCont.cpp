@@ -23,6 +23,7 @@ constexpr std::chrono::seconds DEFAULT_AUDIO_CAPTURE_INACTIVE_TIMEOUT{1};
 
 CaptureCont::CaptureCont(Hyperion* hyperion)
 	: _hyperion(hyperion)
+	, _muxer(hyperion->getMuxerInstance())
 	, _screenCaptureEnabled(false)
 	, _screenCapturePriority(0)
 	, _screenCaptureInactiveTimer(new QTimer(this))
@@ -60,37 +61,97 @@ CaptureCont::CaptureCont(Hyperion* hyperion)
 
 void CaptureCont::handleVideoImage(const QString& name, const Image<ColorRgb> & image)
 {
-	if(_videoCaptureName != name)
+	if(_muxer->postInputImage(_videoCapturePriority, {image, PriorityMuxer::ENDLESS, name, true}))
 	{
-		_hyperion->registerInput(_videoCapturePriority, hyperion::COMP_V4L, "System", name);
-		_videoCaptureName = name;
+		QMetaObject::invokeMethod(this, "applyVideoImage", Qt::QueuedConnection);
+	}
+}
+
+void CaptureCont::applyVideoImage()
+{
+	if(!_videoCaptureEnabled)
+	{
+		_muxer->dropInputImage(_videoCapturePriority);
+		return;
+	}
+
+	PriorityMuxer::PostedImage frame {};
+	if(!_muxer->takeInputImage(_videoCapturePriority, frame))
+	{
+		return;
+	}
+
+	if(_videoCaptureName != frame.owner)
+	{
+		_hyperion->registerInput(_videoCapturePriority, hyperion::COMP_V4L, "System", frame.owner);
+		_videoCaptureName = frame.owner;
 		emit GlobalSignals::getInstance()->requestSource(hyperion::COMP_V4L, int(_hyperion->getInstanceIndex()), _videoCaptureEnabled);
 	}
 	_videoInactiveTimer->start();
-	_hyperion->setInputImage(_videoCapturePriority, image);
+	_hyperion->setInputImage(_videoCapturePriority, frame.image);
 }
 
 void CaptureCont::handleScreenImage(const QString& name, const Image<ColorRgb>& image)
 {
-	if(_screenCaptureName != name)
+	if(_muxer->postInputImage(_screenCapturePriority, {image, PriorityMuxer::ENDLESS, name, true}))
+	{
+		QMetaObject::invokeMethod(this, "applyScreenImage", Qt::QueuedConnection);
+	}
+}
+
+void CaptureCont::applyScreenImage()
+{
+	if(!_screenCaptureEnabled)
 	{
-		_hyperion->registerInput(_screenCapturePriority, hyperion::COMP_GRABBER, "System", name);
-		_screenCaptureName = name;
+		_muxer->dropInputImage(_screenCapturePriority);
+		return;
+	}
+
+	PriorityMuxer::PostedImage frame {};
+	if(!_muxer->takeInputImage(_screenCapturePriority, frame))
+	{
+		return;
+	}
+
+	if(_screenCaptureName != frame.owner)
+	{
+		_hyperion->registerInput(_screenCapturePriority, hyperion::COMP_GRABBER, "System", frame.owner);
+		_screenCaptureName = frame.owner;
 		emit GlobalSignals::getInstance()->requestSource(hyperion::COMP_GRABBER, int(_hyperion->getInstanceIndex()), _screenCaptureEnabled);
 	}
 	_screenCaptureInactiveTimer->start();
-	_hyperion->setInputImage(_screenCapturePriority, image);
+	_hyperion->setInputImage(_screenCapturePriority, frame.image);
 }
 
 void CaptureCont::handleAudioImage(const QString& name, const Image<ColorRgb>& image)
 {
-	if (_audioCaptureName != name)
+	if (_muxer->postInputImage(_audioCapturePriority, {image, PriorityMuxer::ENDLESS, name, true}))
+	{
+		QMetaObject::invokeMethod(this, "applyAudioImage", Qt::QueuedConnection);
+	}
+}
+
+void CaptureCont::applyAudioImage()
+{
+	if (!_audioCaptureEnabled)
+	{
+		_muxer->dropInputImage(_audioCapturePriority);
+		return;
+	}
+
+	PriorityMuxer::PostedImage frame {};
+	if (!_muxer->takeInputImage(_audioCapturePriority, frame))
+	{
+		return;
+	}
+
+	if (_audioCaptureName != frame.owner)
 	{
-		_hyperion->registerInput(_audioCapturePriority, hyperion::COMP_AUDIO, "System", name);
-		_audioCaptureName = name;
+		_hyperion->registerInput(_audioCapturePriority, hyperion::COMP_AUDIO, "System", frame.owner);
+		_audioCaptureName = frame.owner;
 	}
 	_audioCaptureInactiveTimer->start();
-	_hyperion->setInputImage(_audioCapturePriority, image);
+	_hyperion->setInputImage(_audioCapturePriority, frame.image);
 }
 
 void CaptureCont::setScreenCaptureEnable(bool enable)
@@ -100,8 +161,9 @@ void CaptureCont::setScreenCaptureEnable(bool enable)
 		if(enable)
 		{
 			_hyperion->registerInput(_screenCapturePriority, hyperion::COMP_GRABBER);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, this, &CaptureCont::handleScreenImage);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, _hyperion, &Hyperion::forwardSystemProtoMessage);
+			// Direct, the image is posted to the priority's latest-frame mailbox in the grabber's thread
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, this, &CaptureCont::handleScreenImage, Qt::DirectConnection);
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setSystemImage, _hyperion, &Hyperion::forwardSystemProtoMessage, Qt::DirectConnection);
 		}
 		else
 		{
@@ -123,8 +185,9 @@ void CaptureCont::setVideoCaptureEnable(bool enable)
 		if(enable)
 		{
 			_hyperion->registerInput(_videoCapturePriority, hyperion::COMP_V4L);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, this, &CaptureCont::handleVideoImage);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, _hyperion, &Hyperion::forwardV4lProtoMessage);
+			// Direct, the image is posted to the priority's latest-frame mailbox in the grabber's thread
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, this, &CaptureCont::handleVideoImage, Qt::DirectConnection);
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setV4lImage, _hyperion, &Hyperion::forwardV4lProtoMessage, Qt::DirectConnection);
 		}
 		else
 		{
@@ -146,8 +209,9 @@ void CaptureCont::setAudioCaptureEnable(bool enable)
 		if (enable)
 		{
 			_hyperion->registerInput(_audioCapturePriority, hyperion::COMP_AUDIO);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, this, &CaptureCont::handleAudioImage);
-			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, _hyperion, &Hyperion::forwardAudioProtoMessage);
+			// Direct, the image is posted to the priority's latest-frame mailbox in the grabber's thread
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, this, &CaptureCont::handleAudioImage, Qt::DirectConnection);
+			connect(GlobalSignals::getInstance(), &GlobalSignals::setAudioImage, _hyperion, &Hyperion::forwardAudioProtoMessage, Qt::DirectConnection);
 		}
 		else
 		{
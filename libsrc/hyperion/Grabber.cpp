@@ -1,6 +1,15 @@
 #include <hyperion/Grabber.h>
 #include <hyperion/GrabberWrapper.h>
 
+// STL includes
+#include <atomic>
+
+namespace {
+std::atomic<quint64> decodedFrames {0};
+std::atomic<quint64> droppedFrames {0};
+std::atomic<quint64> reorderedFrames {0};
+} // namespace
+
 Grabber::Grabber(const QString& grabberName, int cropLeft, int cropRight, int cropTop, int cropBottom)
 	: _grabberName(grabberName)
 	, _log(Logger::getInstance(_grabberName.toUpper()))
@@ -25,6 +34,22 @@ Grabber::Grabber(const QString& grabberName, int cropLeft, int cropRight, int cr
 	Grabber::setCropping(cropLeft, cropRight, cropTop, cropBottom);
 }
 
+Grabber::DecodingStatistics Grabber::getDecodingStatistics()
+{
+	return {
+		decodedFrames.load(std::memory_order_relaxed),
+		droppedFrames.load(std::memory_order_relaxed),
+		reorderedFrames.load(std::memory_order_relaxed)
+	};
+}
+
+void Grabber::addDecodingStatistics(const DecodingStatistics& statistics)
+{
+	decodedFrames.fetch_add(statistics.decodedFrames, std::memory_order_relaxed);
+	droppedFrames.fetch_add(statistics.droppedFrames, std::memory_order_relaxed);
+	reorderedFrames.fetch_add(statistics.reorderedFrames, std::memory_order_relaxed);
+}
+
 void Grabber::setEnabled(bool enable)
 {
 	Info(_log,"Capture interface is now %s", enable ? "enabled" : "disabled");
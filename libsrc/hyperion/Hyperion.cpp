@@ -11,6 +11,7 @@
 #include <hyperion/Hyperion.h>
 
 #include <hyperion/ImageProcessor.h>
+#include <hyperion/ImageAnalysisCache.h>
 #include <hyperion/ColorAdjustment.h>
 
 // utils
@@ -72,6 +73,7 @@ Hyperion::Hyperion(quint8 instance, QObject* parent)
 	, _colorOrder("rgb")
 	, _BGEffectHandler(nullptr)
 	, _captureCont(nullptr)
+	, _previewEncoder(nullptr)
 #if defined(ENABLE_BOBLIGHT_SERVER)
 	, _boblightServer(nullptr)
 #endif
@@ -132,7 +134,8 @@ void Hyperion::start()
 
 	_ledDeviceWrapper.reset(new LedDeviceWrapper(this));
 	connect(this, &Hyperion::compStateChangeRequest, _ledDeviceWrapper.get(), &LedDeviceWrapper::handleComponentState);
-	connect(this, &Hyperion::ledDeviceData, _ledDeviceWrapper.get(), &LedDeviceWrapper::updateLeds);
+	// Direct forwarding, as the smoothing may emit ledDeviceData from its output thread; the wrapper hands the frames over to the device's thread
+	connect(this, &Hyperion::ledDeviceData, _ledDeviceWrapper.get(), &LedDeviceWrapper::updateLeds, Qt::DirectConnection);
 
 	_ledDeviceWrapper->createLedDevice(ledDeviceSettings);
 
@@ -157,11 +160,19 @@ void Hyperion::start()
 	// create the Daemon capture interface
 	_captureCont.reset(new CaptureCont(this));
 
+	// encoder of the preview image, encodes on its own thread and only while subscribed
+	_previewEncoder.reset(new PreviewEncoder(getSetting(settings::INSTCAPTURE), _log, this));
+	connect(this, &Hyperion::settingsChanged, _previewEncoder.get(), &PreviewEncoder::handleSettingsUpdate);
+	connect(this, &Hyperion::currentImage, _previewEncoder.get(), &PreviewEncoder::handleImage, Qt::DirectConnection);
+
 	// link global signals with the corresponding slots
 	connect(GlobalSignals::getInstance(), &GlobalSignals::registerGlobalInput, this, &Hyperion::registerInput);
-	connect(GlobalSignals::getInstance(), &GlobalSignals::clearGlobalInput, this, &Hyperion::clear);
+	// Clears are announced to the mailboxes at once, so that images posted afterwards are not cleared with them
+	connect(GlobalSignals::getInstance(), &GlobalSignals::clearGlobalInput, this, &Hyperion::requestClear, Qt::DirectConnection);
+	connect(GlobalSignals::getInstance(), &GlobalSignals::clearGlobalInput, this, &Hyperion::applyRequestedClear);
 	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalColor, this, &Hyperion::setColor);
-	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalImage, this, &Hyperion::setInputImage);
+	// Images are posted directly to the latest-frame mailbox, so that only the newest one is processed when the instance is busy
+	connect(GlobalSignals::getInstance(), &GlobalSignals::setGlobalImage, this, &Hyperion::postInputImage, Qt::DirectConnection);
 
 	// Limit LED data emission, if high rumber of LEDs configured
 	_rawLedDataEmissionInterval = (_ledString.leds().size() > 1000) ? 2 * DEFAULT_MAX_RAW_LED_DATA_EMISSION_INTERVAL : DEFAULT_MAX_RAW_LED_DATA_EMISSION_INTERVAL;
@@ -181,6 +192,9 @@ void Hyperion::start()
 	connect(this, &Hyperion::settingsChanged, _boblightServer.get(), &BoblightServer::handleSettingsUpdate);
 #endif
 
+	// frames are processed in this thread, share their analysis with other instances
+	ImageAnalysisCache::getInstance().addConsumer();
+
 	// instance initiated, enter thread event loop
 	emit started();
 }
@@ -207,6 +221,8 @@ void Hyperion::stop(const QString name)
 	 _deviceSmooth->stop();
 	 _muxer->stop();
 
+	ImageAnalysisCache::getInstance().removeConsumer();
+
 	emit finished(name);
 }
 
@@ -252,6 +268,7 @@ void Hyperion::updateLedColorAdjustment(int ledCount, const QJsonObject& colors)
 {
 	// change in LEDs are also reflected in adjustment
 	_raw2ledAdjustment.reset(hyperion::createLedColorsAdjustment(ledCount, colors));
+	_raw2ledAdjustment->setLedString(_ledString);
 	if (!_raw2ledAdjustment->verifyAdjustments())
 	{
 		Warning(_log, "At least one LED has no color calibration, please add all LEDs from your LED layout to an 'LED index' field!");
@@ -264,12 +281,6 @@ void Hyperion::updateLedLayout(const QJsonArray& ledLayout)
 	_layoutLedCount = static_cast<int>(_ledString.leds().size());
 	_layoutGridSize = hyperion::getLedLayoutGridSize(ledLayout);
 
-	_ledStringColorOrder.clear();
-	for (const Led& led : _ledString.leds())
-	{
-		_ledStringColorOrder.push_back(led.colorOrder);
-	}
-
 	updateLedColorAdjustment(_layoutLedCount, getSetting(settings::COLOR).object());
 
 	if (_imageProcessor.isNull())
@@ -428,6 +439,40 @@ bool Hyperion::setInputImage(int priority, const Image<ColorRgb>& image, int64_t
 	return false;
 }
 
+void Hyperion::postInputImage(int priority, const Image<ColorRgb>& image, int timeout_ms, bool clearEffect)
+{
+	PriorityMuxer::PostedImage frame {image, timeout_ms, QString(), clearEffect, true};
+	if (_muxer->postInputImage(priority, frame))
+	{
+		QMetaObject::invokeMethod(this, "applyPostedImage", Qt::QueuedConnection, Q_ARG(int, priority));
+	}
+}
+
+void Hyperion::applyPostedImage(int priority)
+{
+	PriorityMuxer::PostedImage frame {};
+	if (_muxer->takeInputImage(priority, frame))
+	{
+		setInputImage(priority, frame.image, frame.timeout_ms, frame.clearEffect);
+	}
+}
+
+void Hyperion::requestClear(int priority, bool /*forceClearAll*/)
+{
+	_muxer->requestClear(priority);
+}
+
+void Hyperion::applyRequestedClear(int priority, bool forceClearAll)
+{
+	clear(priority, forceClearAll);
+
+	// Images posted after the clear was requested
+	for (int heldBackPriority : _muxer->finishClear(priority))
+	{
+		applyPostedImage(heldBackPriority);
+	}
+}
+
 bool Hyperion::setInputInactive(int priority)
 {
 	return _muxer->setInputInactive(priority);
@@ -492,6 +537,7 @@ ColorAdjustment * Hyperion::getAdjustment(const QString& identifier) const
 
 void Hyperion::adjustmentsUpdated()
 {
+	_raw2ledAdjustment->adjustmentsUpdated();
 	emit adjustmentChanged();
 	refreshUpdate();
 }
@@ -582,6 +628,36 @@ int Hyperion::getLedMappingType() const
 	return _imageProcessor->getUserLedMappingType();
 }
 
+QJsonObject Hyperion::getSmoothingStatistics() const
+{
+	return _deviceSmooth->getOutputStatistics();
+}
+
+QJsonObject Hyperion::getLedDeviceStatistics() const
+{
+	return _ledDeviceWrapper->getStatistics();
+}
+
+QJsonObject Hyperion::getInputImageStatistics() const
+{
+	QJsonObject statistics;
+	const PriorityMuxer::MailboxCountersMap counters = _muxer->getMailboxCounters();
+	for (auto counterIt = counters.constBegin(); counterIt != counters.constEnd(); ++counterIt)
+	{
+		QJsonObject priorityStatistics;
+		priorityStatistics["posted"] = static_cast<qint64>(counterIt->posted);
+		priorityStatistics["coalesced"] = static_cast<qint64>(counterIt->coalesced);
+		priorityStatistics["dropped"] = static_cast<qint64>(counterIt->dropped);
+		statistics[QString::number(counterIt.key())] = priorityStatistics;
+	}
+	return statistics;
+}
+
+QJsonObject Hyperion::getPreviewStatistics() const
+{
+	return _previewEncoder->getStatistics();
+}
+
 void Hyperion::setVideoMode(VideoMode mode)
 {
 	emit videoMode(mode);
@@ -646,11 +722,14 @@ void Hyperion::update()
 {
 	// Obtain the current priority channel
 	int const priority = _muxer->getCurrentPriority();
-	const PriorityMuxer::InputInfo priorityInfo = _muxer->getInputInfo(priority);
+	// Read in place, the muxer is only changed in this thread and not during the update
+	const PriorityMuxer::InputInfo& priorityInfo = _muxer->getInputInfo(priority);
 
-	std::vector<ColorRgb> ledColors;
+	// LED colors of the image, processed OR ledColors from muxer
+	std::vector<ColorRgb> imageLedColors;
+	const std::vector<ColorRgb>* ledColors = &priorityInfo.ledColors;
+	bool applyBlacklist = false;
 
-	// copy image & process OR copy ledColors from muxer
 	Image<ColorRgb> const image = priorityInfo.image;
 	if (image.width() > 1 || image.height() > 1)
 	{
@@ -662,70 +741,40 @@ void Hyperion::update()
 			_lastImageEmission = elapsedImageEmissionTime;
 			emit currentImage(image);  // Emit the image signal at the controlled rate
 		}
-		ledColors = _imageProcessor->process(image);
+		imageLedColors = _imageProcessor->process(image);
+		ledColors = &imageLedColors;
 	}
 	else
 	{
-		ledColors = priorityInfo.ledColors;
-		if (_ledString.hasBlackListedLeds())
+		applyBlacklist = _ledString.hasBlackListedLeds();
+	}
+
+	// Throttle the emission of rawLedColors(_ledBuffer) signal
+	qint64 elapsedRawLedDataEmissionTime = _rawLedDataTimer.elapsed();
+	if (elapsedRawLedDataEmissionTime - _lastRawLedDataEmission >= _rawLedDataEmissionInterval.count())
+	{
+		_lastRawLedDataEmission = elapsedRawLedDataEmissionTime;
+		if (applyBlacklist)
 		{
+			std::vector<ColorRgb> rawColors = *ledColors;
 			for (unsigned long const id : _ledString.blacklistedLedIds())
 			{
-				if (id > ledColors.size()-1)
+				if (id > rawColors.size()-1)
 				{
 					break;
 				}
-				ledColors.at(id) = ColorRgb::BLACK;
+				rawColors.at(id) = ColorRgb::BLACK;
 			}
+			emit rawLedColors(rawColors);  // Emit the rawLedColors signal at the controlled rate
 		}
-	}
-
-	// Throttle the emission of rawLedColors(_ledBuffer) signal
-	qint64 elapsedRawLedDataEmissionTime = _rawLedDataTimer.elapsed();
-	if (elapsedRawLedDataEmissionTime - _lastRawLedDataEmission >= _rawLedDataEmissionInterval.count())
-	{
-		_lastRawLedDataEmission = elapsedRawLedDataEmissionTime;
-		emit rawLedColors(ledColors);  // Emit the rawLedColors signal at the controlled rate
-	}
-
-	// Start transformations
-	_raw2ledAdjustment->applyAdjustment(ledColors);
-
-	assert(ledColors.size() >= _ledStringColorOrder.size());
-
-	// Only apply color order for LEDs defined by layout
-	for (size_t i=0; i < _ledStringColorOrder.size(); ++i)
-	{
-		ColorRgb& color = ledColors.at(i);
-		// correct the color byte order
-		switch (_ledStringColorOrder.at(i))
+		else
 		{
-		case ColorOrder::ORDER_RGB:
-			// leave as it is
-			break;
-		case ColorOrder::ORDER_BGR:
-			std::swap(color.red, color.blue);
-			break;
-		case ColorOrder::ORDER_RBG:
-			std::swap(color.green, color.blue);
-			break;
-		case ColorOrder::ORDER_GRB:
-			std::swap(color.red, color.green);
-			break;
-		case ColorOrder::ORDER_GBR:
-			std::swap(color.red, color.green);
-			std::swap(color.green, color.blue);
-			break;
-
-		case ColorOrder::ORDER_BRG:
-			std::swap(color.red, color.blue);
-			std::swap(color.green, color.blue);
-			break;
+			emit rawLedColors(*ledColors);  // Emit the rawLedColors signal at the controlled rate
 		}
 	}
 
-	// Copy elements from ledColors to _ledBuffer up to the size of _ledBuffer
-	std::copy_n(ledColors.begin(), std::min(_ledBuffer.size(), ledColors.size()), _ledBuffer.begin());
+	// Blacklisting, transformations and color order in a single pass straight into _ledBuffer
+	_raw2ledAdjustment->applyOutputStage(*ledColors, applyBlacklist, _ledBuffer);
 
 	if (_ledDeviceWrapper->isOn())
 	{
@@ -0,0 +1,108 @@
+#include <hyperion/ImageAnalysisCache.h>
+
+// STL includes
+#include <algorithm>
+
+ImageAnalysisCache& ImageAnalysisCache::getInstance()
+{
+	static ImageAnalysisCache instance;
+	return instance;
+}
+
+ImageAnalysisCache::ImageAnalysisCache()
+	: _hits(0)
+	, _misses(0)
+{
+}
+
+void ImageAnalysisCache::addConsumer()
+{
+	QMutexLocker locker(&_mutex);
+	QThread* const thread = QThread::currentThread();
+	if (std::none_of(_consumers.begin(), _consumers.end(), [thread](const Consumer& consumer) { return consumer.thread == thread; }))
+	{
+		_consumers.push_back({thread, nullptr});
+	}
+}
+
+void ImageAnalysisCache::removeConsumer()
+{
+	QMutexLocker locker(&_mutex);
+	QThread* const thread = QThread::currentThread();
+	auto consumerIt = std::find_if(_consumers.begin(), _consumers.end(), [thread](const Consumer& consumer) { return consumer.thread == thread; });
+	if (consumerIt != _consumers.end())
+	{
+		releaseFrame(*consumerIt);
+		_consumers.erase(consumerIt);
+	}
+}
+
+std::shared_ptr<ImageAnalysisCache::Frame> ImageAnalysisCache::findFrame(const Image<ColorRgb>& image)
+{
+	// Const access only, a non-const one would detach the cached image
+	auto isFrame = [&image](const std::shared_ptr<Frame>& frame) {
+		const Image<ColorRgb>& cachedImage = frame->image;
+		return cachedImage.memptr() == image.memptr()
+			&& cachedImage.width() == image.width()
+			&& cachedImage.height() == image.height();
+	};
+
+	QMutexLocker locker(&_mutex);
+	QThread* const thread = QThread::currentThread();
+	auto consumerIt = std::find_if(_consumers.begin(), _consumers.end(), [thread](const Consumer& consumer) { return consumer.thread == thread; });
+	if (consumerIt == _consumers.end())
+	{
+		return nullptr;
+	}
+
+	Consumer& consumer = *consumerIt;
+	if (consumer.frame != nullptr && isFrame(consumer.frame))
+	{
+		return consumer.frame;
+	}
+
+	// The consumer moved on to another frame
+	releaseFrame(consumer);
+
+	if (_consumers.size() < 2)
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<Frame> frame;
+	auto frameIt = std::find_if(_frames.begin(), _frames.end(), isFrame);
+	if (frameIt != _frames.end())
+	{
+		frame = *frameIt;
+	}
+	else
+	{
+		frame = std::make_shared<Frame>();
+		frame->image = image;
+		_frames.push_back(frame);
+	}
+
+	++frame->consumers;
+	consumer.frame = frame;
+	return frame;
+}
+
+void ImageAnalysisCache::releaseFrame(Consumer& consumer)
+{
+	if (consumer.frame == nullptr)
+	{
+		return;
+	}
+
+	// Superseded at all consumers, the image and results are dropped once the last user is done
+	if (--consumer.frame->consumers == 0)
+	{
+		_frames.erase(std::remove(_frames.begin(), _frames.end(), consumer.frame), _frames.end());
+	}
+	consumer.frame.reset();
+}
+
+ImageAnalysisCache::Statistics ImageAnalysisCache::statistics() const
+{
+	return {_hits.load(), _misses.load()};
+}
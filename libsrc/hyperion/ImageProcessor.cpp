@@ -30,6 +30,7 @@ void ImageProcessor::registerProcessingUnit(
 								_reducedPixelSetFactorFactor,
 								_accuraryLevel
 								));
+		_imageToLedColors->setProcessingThreads(_processingThreads);
 	}
 	else
 	{
@@ -116,6 +117,7 @@ ImageProcessor::ImageProcessor(const LedString& ledString, Hyperion* hyperion)
 	, _hardMappingType(-1)
 	, _accuraryLevel(0)
 	, _reducedPixelSetFactorFactor(1)
+	, _processingThreads(1)
 	, _hyperion(hyperion)
 {
 	QString subComponent = hyperion->property("instance").toString();
@@ -147,6 +149,9 @@ void ImageProcessor::handleSettingsUpdate(settings::type type, const QJsonDocume
 
 		int accuracyLevel = obj["accuracyLevel"].toInt();
 		setAccuracyLevel(accuracyLevel);
+
+		int processingThreads = obj["processingThreads"].toInt(1);
+		setProcessingThreads(processingThreads);
 	}
 }
 
@@ -215,6 +220,17 @@ void ImageProcessor::setAccuracyLevel(int level)
 	}
 }
 
+void ImageProcessor::setProcessingThreads(int threadCount)
+{
+	_processingThreads = threadCount;
+	Debug(_log, "Set processing threads to %d", _processingThreads);
+
+	if (!_imageToLedColors.isNull())
+	{
+		_imageToLedColors->setProcessingThreads(_processingThreads);
+	}
+}
+
 void ImageProcessor::setLedMappingType(int mapType)
 {
 	int currentMappingType = _mappingType;
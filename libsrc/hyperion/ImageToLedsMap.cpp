@@ -18,7 +18,14 @@ ImageToLedsMap::ImageToLedsMap(
 	, _verticalBorder(verticalBorder)
 	, _nextPixelCount(reducedPixelSetFactor)
 	, _clusterCount()
-	, _colorsMap()
+	, _chunkCount(1)
+	, _chunkBoundaries()
+	, _colorsAreas()
+	, _meanAreas()
+	, _integralImageEnabled(false)
+	, _dominantColorHistograms(1)
+	, _clusterCenters()
+	, _clusterCentersValid()
 {
 	_nextPixelCount = reducedPixelSetFactor + 1;
 	setAccuracyLevel(accuracyLevel);
@@ -30,7 +37,8 @@ ImageToLedsMap::ImageToLedsMap(
 	Q_ASSERT(_height < 10000);
 
 	// Reserve enough space in the map for the leds
-	_colorsMap.reserve(leds.size());
+	_colorsAreas.reserve(leds.size());
+	_meanAreas.reserve(leds.size());
 
 	const int xOffset      = _verticalBorder;
 	const int actualWidth  = _width  - 2 * _verticalBorder;
@@ -38,7 +46,7 @@ ImageToLedsMap::ImageToLedsMap(
 	const int actualHeight = _height - 2 * _horizontalBorder;
 
 	size_t	totalCount = 0;
-	size_t	totalCapacity = 0;
+	size_t	totalMeanCount = 0;
 	int     ledCounter = 0;
 
 	for (const Led& led : leds)
@@ -46,7 +54,8 @@ ImageToLedsMap::ImageToLedsMap(
 		// skip leds without area
 		if ((led.maxX_frac-led.minX_frac) < 1e-6 || (led.maxY_frac-led.minY_frac) < 1e-6)
 		{
-			_colorsMap.emplace_back();
+			_colorsAreas.emplace_back();
+			_meanAreas.emplace_back();
 			continue;
 		}
 
@@ -68,7 +77,7 @@ ImageToLedsMap::ImageToLedsMap(
 			maxY_idx++;
 		}
 
-		// Add all the indices in the above defined rectangle to the indices for this led
+		// Limit the above defined rectangle to the image
 		const int maxYLedCount = qMin(maxY_idx, yOffset+actualHeight);
 		const int maxXLedCount = qMin(maxX_idx, xOffset+actualWidth);
 
@@ -87,31 +96,80 @@ ImageToLedsMap::ImageToLedsMap(
 		{
 			skipPixelProcessing = true;
 			_nextPixelCount = 2;
-			Warning(_log, "Mapping LED/light [%d]. The current mapping area contains %d pixels which is huge. Therefore every %d pixels will be skipped. You can enable reduced processing to hide that warning.", ledCounter, totalSize, _nextPixelCount);
+			Warning(_log, "Mapping LED/light [%d]. The current mapping area contains %d pixels which is huge. Therefore every %d pixels will be skipped (except for the mean color). You can enable reduced processing to hide that warning.", ledCounter, totalSize, _nextPixelCount);
 		}
 
-		std::vector<int> ledColors;
-		ledColors.reserve(totalSize);
+		// Describe every "_nextPixelCount" pixel of every "_nextPixelCount" row of the rectangle
+		LedArea area;
+		area.offset = minY_idx * width + minX_idx;
+		area.rows = qMax(0, (maxYLedCount - minY_idx + _nextPixelCount - 1) / _nextPixelCount);
+		area.columns = qMax(0, (maxXLedCount - minX_idx + _nextPixelCount - 1) / _nextPixelCount);
+		area.rowStride = width * _nextPixelCount;
+		area.columnStep = _nextPixelCount;
+		_colorsAreas.push_back(area);
 
-		for (int y = minY_idx; y < maxYLedCount; y += _nextPixelCount)
+		totalCount += static_cast<size_t>(area.pixelCount());
+
+		// The mean color is evaluated on all pixels, if not reduced by the user
+		if (reducedPixelSetFactor > 0)
+		{
+			_meanAreas.push_back(area);
+		}
+		else
 		{
-			for (int x = minX_idx; x < maxXLedCount; x += _nextPixelCount)
-			{
-				ledColors.push_back( y * width + x);
-			}
+			LedArea meanArea;
+			meanArea.offset = area.offset;
+			meanArea.rows = qMax(0, maxYLedCount - minY_idx);
+			meanArea.columns = qMax(0, maxXLedCount - minX_idx);
+			meanArea.rowStride = width;
+			meanArea.columnStep = 1;
+			_meanAreas.push_back(meanArea);
 		}
+		totalMeanCount += static_cast<size_t>(_meanAreas.back().pixelCount());
 
-		// Add the constructed vector to the map
-		_colorsMap.push_back(ledColors);
+		ledCounter++;
+	}
+	resetClusterCenters();
+	_chunkBoundaries = { 0, _colorsAreas.size() };
 
-		totalCount += ledColors.size();
-		totalCapacity += ledColors.capacity();
+	// If the LED areas overlap or cover the whole image, summing up the image once is cheaper than summing up each area.
+	// The integral image's 32-bit sums must not overflow for an area covering the full image.
+	const size_t imageSize = static_cast<size_t>(width) * static_cast<size_t>(height);
+	_integralImageEnabled = reducedPixelSetFactor == 0
+							&& totalMeanCount >= imageSize
+							&& imageSize <= UINT32_MAX / 255;
 
-		ledCounter++;
+	Debug(_log, "Total pixel number is: %d (memory: %d). Reduced pixel set factor: %d, Accuracy level: %d, Image size: %d x %d, LED areas: %d, Summation kernel: %s, Integral image: %s",
+		totalCount, (_colorsAreas.capacity() + _meanAreas.capacity()) * sizeof(LedArea), reducedPixelSetFactor, accuracyLevel, width, height, leds.size(),
+		PixelSum::kernelName(PixelSum::kernel()), _integralImageEnabled ? "enabled" : "disabled");
+
+}
+
+ColorRgb ImageToLedsMap::calcMeanColorIntegral(const uint32_t* integralImage, const LedArea & area) const
+{
+	const uint32_t pixelNum = static_cast<uint32_t>(area.pixelCount());
+	if (pixelNum == 0)
+	{
+		return ColorRgb::BLACK;
+	}
+
+	const size_t rowStride = static_cast<size_t>(_width + 1) * 3;
+	const size_t top = static_cast<size_t>(area.offset / _width);
+	const size_t left = static_cast<size_t>(area.offset % _width) * 3;
+	const size_t right = left + static_cast<size_t>(area.columns) * 3;
+
+	const uint32_t* topRow = integralImage + top * rowStride;
+	const uint32_t* bottomRow = topRow + static_cast<size_t>(area.rows) * rowStride;
+
+	uint8_t avg[3];
+	for (size_t channel = 0; channel < 3; ++channel)
+	{
+		const uint32_t sum = bottomRow[right + channel] - bottomRow[left + channel]
+							 - topRow[right + channel] + topRow[left + channel];
+		avg[channel] = static_cast<uint8_t>(sum / pixelNum);
 	}
-	Debug(_log, "Total index number is: %d (memory: %d). Reduced pixel set factor: %d, Accuracy level: %d, Image size: %d x %d, LED areas: %d",
-		totalCount, totalCapacity, reducedPixelSetFactor, accuracyLevel, width, height, leds.size());
 
+	return {avg[0], avg[1], avg[2]};
 }
 
 int ImageToLedsMap::width() const
@@ -132,7 +190,49 @@ void ImageToLedsMap::setAccuracyLevel (int accuracyLevel)
 		accuracyLevel = 4;
 	}
 	//Set cluster number for dominant color advanced
-	_clusterCount  = accuracyLevel + 1;
+	if (_clusterCount != accuracyLevel + 1)
+	{
+		_clusterCount  = accuracyLevel + 1;
+		resetClusterCenters();
+	}
+}
+
+void ImageToLedsMap::setProcessingThreads(int threadCount)
+{
+	_chunkCount = (threadCount > 1) ? ProcessingPool::getInstance().reserveThreads(threadCount) : 1;
+	_chunkCount = qMax(1, qMin(_chunkCount, static_cast<int>(_colorsAreas.size())));
+
+	// Split the LEDs into consecutive chunks of about the same number of pixels (plus some overhead per LED)
+	size_t totalWeight = 0;
+	for (const LedArea& area : _colorsAreas)
+	{
+		totalWeight += static_cast<size_t>(area.pixelCount()) + 1;
+	}
+
+	_chunkBoundaries.assign(1, 0);
+	size_t weight = 0;
+	for (size_t idx = 0; idx < _colorsAreas.size() && static_cast<int>(_chunkBoundaries.size()) < _chunkCount; ++idx)
+	{
+		weight += static_cast<size_t>(_colorsAreas[idx].pixelCount()) + 1;
+		if (weight * static_cast<size_t>(_chunkCount) >= totalWeight * _chunkBoundaries.size())
+		{
+			_chunkBoundaries.push_back(idx + 1);
+		}
+	}
+	_chunkBoundaries.push_back(_colorsAreas.size());
+	_chunkCount = static_cast<int>(_chunkBoundaries.size()) - 1;
+
+	_dominantColorHistograms.resize(static_cast<size_t>(_chunkCount));
+
+	Debug(_log, "Processing LED areas in %d chunk(s)", _chunkCount);
+}
+
+void ImageToLedsMap::resetClusterCenters()
+{
+	// one set of centers per LED and one for the full image
+	const size_t centerSets = _colorsAreas.size() + 1;
+	_clusterCenters.assign(centerSets * static_cast<size_t>(_clusterCount), ColorRgbScalar(0, 0, 0));
+	_clusterCentersValid.assign(centerSets, 0);
 
 }
 
@@ -1,10 +1,13 @@
 // Qt includes
 #include <QDateTime>
 #include <QTimer>
+#include <QJsonArray>
+#include <QMutexLocker>
 
 #include <hyperion/LinearColorSmoothing.h>
 #include <hyperion/Hyperion.h>
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <thread>
@@ -17,11 +20,6 @@
 #define ALWAYS_INLINE inline
 #endif
 
-/// Clamps the rounded values to the byte-interval of [0, 255].
-ALWAYS_INLINE long clampRounded(const floatT x) {
-	return std::min(255L, std::max(0L, std::lroundf(x)));
-}
-
 // Constants
 namespace {
 
@@ -30,15 +28,6 @@ const bool verbose = false;
 /// The number of microseconds per millisecond = 1000.
 const int64_t MS_PER_MICRO = 1000;
 
-/// The number of bits that are used for shifting the fixed point values
-const int FPShift = (sizeof(uint64_t)*8 - (12 + 9));
-
-/// The number of bits that are reduce the shifting when converting from fixed to floating point. 8 bits = 256 values
-const int SmallShiftBis = sizeof(uint8_t)*8;
-
-/// The number of bits that are used for shifting the fixed point values plus SmallShiftBis
-const int FPShiftSmall = (sizeof(uint64_t)*8 - (12 + 9 + SmallShiftBis));
-
 const char* SETTINGS_KEY_SMOOTHING_TYPE = "type";
 
 const char* SETTINGS_KEY_SETTLING_TIME = "time_ms";
@@ -48,12 +37,18 @@ const char* SETTINGS_KEY_OUTPUT_DELAY = "updateDelay";
 const char* SETTINGS_KEY_DECAY = "decay";
 const char* SETTINGS_KEY_INTERPOLATION_RATE = "interpolationRate";
 const char* SETTINGS_KEY_DITHERING = "dithering";
+const char* SETTINGS_KEY_OUTPUT_THREAD = "outputThread";
+const char* SETTINGS_KEY_OUTPUT_THREAD_PRIORITY = "outputThreadPriority";
+const char* SETTINGS_KEY_OUTPUT_THREAD_CPU = "outputThreadCpu";
 
 const int64_t DEFAULT_SETTLINGTIME = 200;	// in ms
 const int DEFAULT_UPDATEFREQUENCY = 25;		// in Hz
 
 constexpr std::chrono::milliseconds DEFAULT_UPDATEINTERVALL{MS_PER_MICRO/ DEFAULT_UPDATEFREQUENCY};
 const unsigned DEFAULT_OUTPUTDEPLAY = 0;	// in frames
+
+/// Shortest output period of the output thread (maximum update frequency of 2000Hz)
+const int64_t MIN_OUTPUT_PERIOD_MICROS = 500;
 }
 
 using namespace hyperion;
@@ -67,13 +62,18 @@ LinearColorSmoothing::LinearColorSmoothing(const QJsonObject &config, Hyperion *
 	, _updateInterval(DEFAULT_UPDATEINTERVALL.count())
 	, _settlingTime(DEFAULT_SETTLINGTIME)
 	, _timer(nullptr)
+	, _outputScheduler(nullptr)
+	, _outputThreadActive(false)
+	, _outputThreadPriority(0)
+	, _outputThreadCpu(-1)
+	, _coalescedFrames(0)
 	, _outputDelay(DEFAULT_OUTPUTDEPLAY)
 	, _pause(false)
+	, _linearDecay(true)
 	, _currentConfigId(SmoothingConfigID::SYSTEM)
 	, _enabled(false)
 	, _enabledSystemCfg(false)
 	, _smoothingType(SmoothingType::Linear)
-	, tempValues(std::vector<uint64_t>())
 {
 	QString subComponent = hyperion->property("instance").toString();
 	_log= Logger::getInstance("SMOOTHING", subComponent);
@@ -86,6 +86,11 @@ LinearColorSmoothing::LinearColorSmoothing(const QJsonObject &config, Hyperion *
 }
 LinearColorSmoothing::~LinearColorSmoothing()
 {
+	// The output thread accesses members destroyed before the scheduler
+	if (!_outputScheduler.isNull())
+	{
+		_outputScheduler->stop();
+	}
 }
 
 void LinearColorSmoothing::start()
@@ -95,6 +100,8 @@ void LinearColorSmoothing::start()
 	_timer.reset(new QTimer(this));
 	_timer->setTimerType(Qt::PreciseTimer);
 
+	_outputScheduler.reset(new OutputScheduler(_hyperion->property("instance").toString(), [this]() { return outputTick(); }));
+
 	//Start in pause mode, a new priority will activate smoothing (either start-effect or grabber)
 	setPause(true);
 
@@ -111,6 +118,7 @@ void LinearColorSmoothing::stop()
 	Debug(_log, "LinearColorSmoothing stopping...");
 
 	QObject::disconnect(_prioMuxer.get(), &PriorityMuxer::prioritiesChanged, this, &LinearColorSmoothing::handlePriorityUpdate);
+	updateOutputThread(false, _outputThreadPriority, _outputThreadCpu);
 	setEnable(false);
 	_timer->stop();
 
@@ -146,6 +154,10 @@ void LinearColorSmoothing::updateSettings(const QJsonObject &config)
 		_cfgList[SmoothingConfigID::SYSTEM] = cfg;
 		DebugIf(_enabled,_log,"%s", QSTRING_CSTR(getConfig(SmoothingConfigID::SYSTEM)));
 
+		updateOutputThread(config[SETTINGS_KEY_OUTPUT_THREAD].toBool(false),
+						   config[SETTINGS_KEY_OUTPUT_THREAD_PRIORITY].toInt(0),
+						   config[SETTINGS_KEY_OUTPUT_THREAD_CPU].toInt(-1));
+
 		// if current id is 0, we need to apply the settings (forced)
 		if (_currentConfigId == SmoothingConfigID::SYSTEM)
 		{
@@ -186,7 +198,7 @@ int LinearColorSmoothing::write(const std::vector<ColorRgb> &ledValues)
 		_previousValues = ledValues;
 		_previousInterpolationTime = micros();
 
-		if (!_pause)
+		if (!_pause && !_outputThreadActive)
 		{
 			_timer->start(_updateInterval);
 		}
@@ -202,6 +214,15 @@ int LinearColorSmoothing::updateLedValues(const std::vector<ColorRgb> &ledValues
 	{
 		retval = -1;
 	}
+	else if (_outputThreadActive)
+	{
+		// Hand over to the output thread, an unprocessed older frame is replaced
+		_inputFrames.back().assign(ledValues.begin(), ledValues.end());
+		if (_inputFrames.publish())
+		{
+			++_coalescedFrames;
+		}
+	}
 	else
 	{
 		retval = write(ledValues);
@@ -209,22 +230,83 @@ int LinearColorSmoothing::updateLedValues(const std::vector<ColorRgb> &ledValues
 	return retval;
 }
 
-void LinearColorSmoothing::intitializeComponentVectors(const size_t ledCount)
+int64_t LinearColorSmoothing::outputTick()
 {
-	// (Re-)Initialize the color-vectors that store the Mean-Value
-	if (_ledCount != ledCount)
+	QMutexLocker locker(&_stateMutex);
+
+	const int64_t interval = std::max(MS_PER_MICRO * _updateInterval, MIN_OUTPUT_PERIOD_MICROS);
+
+	if (!_enabled)
 	{
-		_ledCount = ledCount;
+		// Drop a frame handed over before smoothing was disabled
+		_inputFrames.consume();
+		return interval;
+	}
 
-		const size_t len = 3 * ledCount;
+	if (_inputFrames.consume())
+	{
+		write(_inputFrames.front());
+	}
 
-		meanValues = std::vector<floatT>(len, 0.0F);
-		residualErrors = std::vector<floatT>(len, 0.0F);
-		tempValues = std::vector<uint64_t>(len, 0L);
+	// Like the timer, which is not started while paused, the target is kept up to date but nothing is output
+	if (!_pause && !_previousValues.empty())
+	{
+		updateLeds();
 	}
 
-	// Zero the temp vector
-	std::fill(tempValues.begin(), tempValues.end(), 0L);
+	return interval;
+}
+
+void LinearColorSmoothing::updateOutputThread(bool enable, int realtimePriority, int cpuAffinity)
+{
+	if (enable == _outputThreadActive && (!enable || (realtimePriority == _outputThreadPriority && cpuAffinity == _outputThreadCpu)))
+	{
+		return;
+	}
+
+	// Hand over between timer and output thread from a clean state
+	_outputScheduler->stop();
+	_outputThreadActive = false;
+	clearQueuedColors();
+
+	_outputThreadPriority = realtimePriority;
+	_outputThreadCpu = cpuAffinity;
+
+	if (enable)
+	{
+		_outputScheduler->resetStatistics();
+		_coalescedFrames = 0;
+		_outputThreadActive = true;
+		_outputScheduler->start(realtimePriority, cpuAffinity);
+		Info(_log, "Smoothing runs on output thread (real-time priority: %d, CPU: %d)", realtimePriority, cpuAffinity);
+	}
+}
+
+QJsonObject LinearColorSmoothing::getOutputStatistics() const
+{
+	QJsonObject statistics;
+	statistics["outputThread"] = _outputThreadActive.load();
+	statistics["coalescedFrames"] = static_cast<qint64>(_coalescedFrames.load());
+
+	if (!_outputScheduler.isNull())
+	{
+		const OutputScheduler::Statistics schedulerStatistics = _outputScheduler->statistics();
+		statistics["ticks"] = static_cast<qint64>(schedulerStatistics.ticks);
+		statistics["missedDeadlines"] = static_cast<qint64>(schedulerStatistics.missedDeadlines);
+		statistics["maxLatenessUs"] = static_cast<qint64>(schedulerStatistics.maxLateness);
+
+		QJsonArray histogram;
+		for (int bucket = 0; bucket < OutputScheduler::JITTER_BUCKETS; ++bucket)
+		{
+			QJsonObject entry;
+			entry["upToUs"] = static_cast<qint64>(OutputScheduler::bucketLimit(bucket));
+			entry["count"] = static_cast<qint64>(schedulerStatistics.jitterHistogram[static_cast<size_t>(bucket)]);
+			histogram.append(entry);
+		}
+		statistics["jitterHistogram"] = histogram;
+	}
+
+	return statistics;
 }
 
 void LinearColorSmoothing::writeDirect()
@@ -251,96 +333,56 @@ ALWAYS_INLINE int64_t LinearColorSmoothing::micros()
 	return (std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch())).count();
 }
 
-void LinearColorSmoothing::assembleAndDitherFrame()
+void LinearColorSmoothing::interpolateFrame()
 {
-	if (meanValues.empty())
-	{
-		return;
-	}
+	const int64_t now = micros();
 
-	// The number of LEDs present in each frame
+	// The number of leds present in each frame
 	const size_t N = _targetValues.size();
 
-	for (size_t i = 0; i < N; ++i)
-	{
-		// Add residuals for error diffusion (temporal dithering)
-		const floatT fr = meanValues[3 * i + 0] + residualErrors[3 * i + 0];
-		const floatT fg = meanValues[3 * i + 1] + residualErrors[3 * i + 1];
-		const floatT fb = meanValues[3 * i + 2] + residualErrors[3 * i + 2];
+	_kernels.resize(N);
 
-		// Convert to to 8-bit value
-		const long ir = clampRounded(fr);
-		const long ig = clampRounded(fg);
-		const long ib = clampRounded(fb);
+	/// Time where the current window has started
+	const int64_t windowStart = now - (MS_PER_MICRO * _settlingTime);
 
-		// Update the colors
-		ColorRgb &prev = _previousValues[i];
-		prev.red = static_cast<uint8_t>(ir);
-		prev.green = static_cast<uint8_t>(ig);
-		prev.blue = static_cast<uint8_t>(ib);
+	forgetOutdatedFrames(windowStart);
 
-		// Determine the component errors
-		residualErrors[3 * i + 0] = fr - ir;
-		residualErrors[3 * i + 1] = fg - ig;
-		residualErrors[3 * i + 2] = fb - ib;
+	if (_linearDecay)
+	{
+		interpolateLinearDecay(now, windowStart);
 	}
-}
-
-void LinearColorSmoothing::assembleFrame()
-{
-	if (meanValues.empty())
+	else
 	{
-		return;
+		interpolateWeightedDecay(now, windowStart);
 	}
 
-	// The number of LEDs present in each frame
-	const size_t N = _targetValues.size();
+	_previousInterpolationTime = now;
+}
 
-	for (size_t i = 0; i < N; ++i)
+void LinearColorSmoothing::interpolateLinearDecay(const int64_t now, const int64_t windowStart)
+{
+	const size_t frames = _frameHistory.size();
+	if (frames == 0)
 	{
-		// Convert to to 8-bit value
-		const long ir = clampRounded(meanValues[3 * i + 0]);
-		const long ig = clampRounded(meanValues[3 * i + 1]);
-		const long ib = clampRounded(meanValues[3 * i + 2]);
-
-		// Update the colors
-		ColorRgb &prev = _previousValues[i];
-		prev.red = static_cast<uint8_t>(ir);
-		prev.green = static_cast<uint8_t>(ig);
-		prev.blue = static_cast<uint8_t>(ib);
+		return;
 	}
-}
-
-ALWAYS_INLINE void LinearColorSmoothing::aggregateComponents(const std::vector<ColorRgb>& colors, std::vector<uint64_t>& weighted, const floatT weight) {
-	// Determine the integer-scale by converting the weight to fixed point
-	const uint64_t scale = (static_cast<uint64_t>(1L)<<FPShift) * static_cast<double>(weight);
-
-	const size_t N = colors.size();
 
-	for (size_t i = 0; i < N; ++i)
-	{
-		const ColorRgb &color = colors[i];
+	// The oldest frame is shown from its start (clipped to the window) till the next frame started
+	const std::vector<ColorRgb> &oldest = _frameHistory.colors(0);
+	const int64_t oldestEnd = (frames > 1) ? _frameHistory.time(1) : now;
+	const uint64_t oldestTime = static_cast<uint64_t>(std::max(int64_t(0), oldestEnd - std::max(windowStart, _frameHistory.time(0))));
 
-		// Scale the colors
-		const uint64_t red = scale * color.red;
-		const uint64_t green = scale * color.green;
-		const uint64_t blue = scale * color.blue;
+	// The newest frame is shown till now
+	const std::vector<ColorRgb> &newest = _frameHistory.colors(frames - 1);
+	const uint64_t newestTime = (frames > 1) ? static_cast<uint64_t>(std::max(int64_t(0), now - _frameHistory.time(frames - 1))) : 0;
 
-		// Accumulate in the vector
-		weighted[3 * i + 0] += red;
-		weighted[3 * i + 1] += green;
-		weighted[3 * i + 2] += blue;
-	}
+	// Weight of one microsecond relative to the window; the weights of all frames sum up to 1 for a fully covered window
+	_kernels.averageWindow(oldest, oldestTime, newest, newestTime, _invWindow);
 }
 
-void LinearColorSmoothing::interpolateFrame()
+void LinearColorSmoothing::interpolateWeightedDecay(const int64_t now, const int64_t windowStart)
 {
-	const int64_t now = micros();
-
-	// The number of leds present in each frame
-	const size_t N = _targetValues.size();
-
-	intitializeComponentVectors(N);
+	_kernels.resetAccumulator();
 
 	/// Time where the frame has been shown
 	int64_t frameStart;
@@ -348,25 +390,22 @@ void LinearColorSmoothing::interpolateFrame()
 	/// Time where the frame display would have ended
 	int64_t frameEnd = now;
 
-	/// Time where the current window has started
-	const int64_t windowStart = now - (MS_PER_MICRO * _settlingTime);
-
 	/// The total weight of the frames that were included in our window; sum of the individual weights
 	floatT fs = 0.0F;
 
 	// To calculate the mean component we iterate over all relevant frames;
 	// from the most recent to the oldest frame that still clips our moving-average window given by time (now)
-	for (auto it = _frameQueue.rbegin(); it != _frameQueue.rend() && frameEnd > windowStart; ++it)
+	for (size_t index = _frameHistory.size(); index > 0 && frameEnd > windowStart; --index)
 	{
 		// Starting time of a frame in the window is clipped to the window start
-		frameStart = std::max(windowStart, it->time);
+		frameStart = std::max(windowStart, _frameHistory.time(index - 1));
 
 		// Weight the current frame relative to the overall window based on start and end times
 		const floatT weight = _weightFrame(frameStart, frameEnd, windowStart);
 		fs += weight;
 
 		// Aggregate the RGB components of this frame's LED colors using the individual weighting
-		aggregateComponents(it->colors, tempValues, weight);
+		_kernels.aggregate(_frameHistory.colors(index - 1), weight);
 
 		// The previous (earlier) frame display has ended when the current frame stared to show,
 		// so we can use this as the frame-end time for next iteration
@@ -374,15 +413,10 @@ void LinearColorSmoothing::interpolateFrame()
 	}
 
 	/// The inverse scaling factor for the color components, clamped to (0, 1.0]; 1.0 for fs < 1, 1 : fs otherwise
-	const floatT inv_fs = ((fs < 1.0F) ? 1.0F : 1.0F / fs) / (1 << SmallShiftBis);
+	const floatT inv_fs = (fs < 1.0F) ? 1.0F : 1.0F / fs;
 
 	// Normalize the mean component values for the window (fs)
-	for (size_t i = 0; i < 3 * N; ++i)
-	{
-		meanValues[i] = (tempValues[i] >> FPShiftSmall) * inv_fs;
-	}
-
-	_previousInterpolationTime = now;
+	_kernels.normalize(inv_fs);
 }
 
 void LinearColorSmoothing::performDecay(const int64_t now) {
@@ -406,7 +440,7 @@ void LinearColorSmoothing::performDecay(const int64_t now) {
 
 		// Assemble the frame now when no dithering is applied
 		if(!_dithering) {
-			assembleFrame();
+			_kernels.assemble(_previousValues);
 		}
 	}
 
@@ -415,7 +449,7 @@ void LinearColorSmoothing::performDecay(const int64_t now) {
 	{
 		// Dither the frame to diffuse rounding errors
 		if(_dithering) {
-			assembleAndDitherFrame();
+			_kernels.assembleAndDither(_previousValues);
 		}
 
 		writeFrame();
@@ -425,7 +459,7 @@ void LinearColorSmoothing::performDecay(const int64_t now) {
 	// Check for sleep when no operation is pending.
 	// As our QTimer is not capable of sub 1ms timing but instead performs spinning -
 	// we have to do µsec-sleep to free CPU time; otherwise the thread would consume 100% CPU time.
-	if(_updateInterval <= 0 && !(interpolatePending || writePending)) {
+	if(_updateInterval <= 0 && !_outputThreadActive && !(interpolatePending || writePending)) {
 		const int64_t nextActionExpected = std::min(interpolationTarget, writeTarget);
 		const int64_t microsTillNextAction = nextActionExpected - now;
 		const int64_t SLEEP_MAX_MICROS = 1000L; // We want to use usleep for up to 1ms
@@ -499,40 +533,88 @@ void LinearColorSmoothing::updateLeds()
 	}
 }
 
-void LinearColorSmoothing::rememberFrame(const std::vector<ColorRgb> &ledColors)
+void LinearColorSmoothing::FrameHistory::clear()
 {
-	const int64_t now = micros();
+	_head = 0;
+	_size = 0;
+}
 
-	// Maintain the queue by removing outdated frames
-	const int64_t windowStart = now - (MS_PER_MICRO * _settlingTime);
+void LinearColorSmoothing::FrameHistory::push(int64_t time, const std::vector<ColorRgb> &colors)
+{
+	if (_size == _times.size())
+	{
+		// Grow the ring, the frames are unrolled to start at the first slot
+		const size_t capacity = std::max(static_cast<size_t>(8), 2 * _times.size());
+		std::rotate(_times.begin(), _times.begin() + static_cast<std::ptrdiff_t>(_head), _times.end());
+		std::rotate(_colors.begin(), _colors.begin() + static_cast<std::ptrdiff_t>(_head), _colors.end());
+		_times.resize(capacity);
+		_colors.resize(capacity);
+		_head = 0;
+	}
+
+	const size_t index = slot(_size);
+	_times[index] = time;
+	// Reuses the slot's buffer, as long as the number of leds does not grow
+	_colors[index].assign(colors.begin(), colors.end());
+	++_size;
+}
+
+void LinearColorSmoothing::FrameHistory::pop()
+{
+	if (_size > 0)
+	{
+		_head = slot(1);
+		--_size;
+	}
+}
+
+void LinearColorSmoothing::forgetOutdatedFrames(const int64_t windowStart)
+{
+	// As the frames are ordered chronologically, the front frame is outdated when the next one started before the window
+	while (_frameHistory.size() > 1 && _frameHistory.time(1) < windowStart)
+	{
+		_frameHistory.pop();
+
+		// The new oldest frame is clipped by the window, so it is no longer part of the window sums
+		if (_frameHistory.size() > 1)
+		{
+			const uint64_t duration = static_cast<uint64_t>(_frameHistory.time(1) - _frameHistory.time(0));
+			_kernels.subtractFromWindowSums(_frameHistory.colors(0), duration);
+		}
+	}
+}
 
-	int p = -1; // Start with -1 instead of 0, so we keep the last frame at least partially clipping the window
+void LinearColorSmoothing::rememberFrame(const std::vector<ColorRgb> &ledColors)
+{
+	const int64_t now = micros();
 
-	// As the frames are ordered chronologically we scan from the front (oldest) till we find the first fresh frame
-	for (auto it = _frameQueue.begin(); it != _frameQueue.end() && it->time < windowStart; ++it)
+	// A change of the number of leds invalidates the history
+	if (_kernels.windowSumsLedCount() != ledColors.size())
 	{
-		++p;
+		_frameHistory.clear();
+		_kernels.resetWindowSums(ledColors.size());
 	}
 
-	if (p > 0)
+	// Maintain the queue by removing outdated frames
+	forgetOutdatedFrames(now - (MS_PER_MICRO * _settlingTime));
+
+	// The current newest frame ends now; unless it is the oldest one, its display time is added to the window sums
+	const size_t frames = _frameHistory.size();
+	if (frames > 1)
 	{
-		_frameQueue.erase(_frameQueue.begin(), _frameQueue.begin() + p);
+		const uint64_t duration = static_cast<uint64_t>(std::max(int64_t(0), now - _frameHistory.time(frames - 1)));
+		_kernels.addToWindowSums(_frameHistory.colors(frames - 1), duration);
 	}
 
 	// Append the latest frame at back of the queue
-	const REMEMBERED_FRAME frame = REMEMBERED_FRAME(now, ledColors);
-	_frameQueue.push_back(frame);
+	_frameHistory.push(now, ledColors);
 }
 
 
 void LinearColorSmoothing::clearRememberedFrames()
 {
-	_frameQueue.clear();
-
-	_ledCount = 0;
-	meanValues.clear();
-	residualErrors.clear();
-	tempValues.clear();
+	_frameHistory.clear();
+	_kernels.clear();
 }
 
 void LinearColorSmoothing::queueColors(const std::vector<ColorRgb> &ledColors)
@@ -569,11 +651,16 @@ void LinearColorSmoothing::queueColors(const std::vector<ColorRgb> &ledColors)
 
 void LinearColorSmoothing::clearQueuedColors()
 {
+	QMutexLocker locker(&_stateMutex);
+
 	_timer->stop();
 	_previousValues.clear();
 
 	_targetValues.clear();
 
+	// Drop a frame handed over but not yet taken by the output thread. It only consumes under the same mutex.
+	_inputFrames.consume();
+
 	clearRememberedFrames();
 }
 
@@ -589,7 +676,11 @@ void LinearColorSmoothing::setEnable(bool enable)
 {
 	if ( _enabled != enable)
 	{
-		_enabled = enable;
+		{
+			// Read by the output thread
+			QMutexLocker locker(&_stateMutex);
+			_enabled = enable;
+		}
 		if (!_enabled)
 		{
 			clearQueuedColors();
@@ -601,6 +692,7 @@ void LinearColorSmoothing::setEnable(bool enable)
 
 void LinearColorSmoothing::setPause(bool pause)
 {
+	QMutexLocker locker(&_stateMutex);
 	_pause = pause;
 }
 
@@ -653,44 +745,49 @@ bool LinearColorSmoothing::selectConfig(int cfgID, bool force)
 
 	if (cfgID < _cfgList.count() )
 	{
-		_smoothingType = _cfgList[cfgID]._type;
-		_settlingTime = _cfgList[cfgID]._settlingTime;
-		_outputDelay = _cfgList[cfgID]._outputDelay;
-		_pause = _cfgList[cfgID]._pause;
-		_outputIntervalMicros = int64_t(1000000.0 / _updateInterval); // 1s = 1e6 µs
-		_interpolationRate = _cfgList[cfgID]._interpolationRate;
-		_interpolationIntervalMicros = int64_t(1000000.0 / _interpolationRate);
-		_dithering = _cfgList[cfgID]._dithering;
-		_decay = _cfgList[cfgID]._decay;
-		_invWindow = 1.0F / (MS_PER_MICRO * _settlingTime);
-
-		// Set _weightFrame based on the given decay
-		const float decay = _decay;
-		const floatT inv_window = _invWindow;
-
-		// For decay != 1 use power-based approach for calculating the moving average values
-		if(std::abs(decay - 1.0F) > std::numeric_limits<float>::epsilon()) {
-			// Exponential Decay
-			_weightFrame = [inv_window,decay](const int64_t fs, const int64_t fe, const int64_t ws) {
-				const floatT s = (fs - ws) * inv_window;
-				const floatT t = (fe - ws) * inv_window;
-
-				return (decay + 1) * (std::pow(t, decay) - std::pow(s, decay));
-			};
-		} else {
-			// For decay == 1 use linear interpolation of the moving average values
-			// Linear Decay
-			_weightFrame = [inv_window](const int64_t fs, const int64_t fe, const int64_t /*ws*/) {
-				// Linear weighting = (end - start) * scale
-				return static_cast<floatT>((fe - fs) * inv_window);
-			};
-		}
+		{
+			QMutexLocker locker(&_stateMutex);
+
+			_smoothingType = _cfgList[cfgID]._type;
+			_settlingTime = _cfgList[cfgID]._settlingTime;
+			_outputDelay = _cfgList[cfgID]._outputDelay;
+			_pause = _cfgList[cfgID]._pause;
+			_outputIntervalMicros = int64_t(1000000.0 / _updateInterval); // 1s = 1e6 µs
+			_interpolationRate = _cfgList[cfgID]._interpolationRate;
+			_interpolationIntervalMicros = int64_t(1000000.0 / _interpolationRate);
+			_dithering = _cfgList[cfgID]._dithering;
+			_decay = _cfgList[cfgID]._decay;
+			_invWindow = 1.0F / (MS_PER_MICRO * _settlingTime);
+			_linearDecay = std::abs(_decay - 1.0) <= std::numeric_limits<float>::epsilon();
+
+			// Set _weightFrame based on the given decay
+			const float decay = _decay;
+			const floatT inv_window = _invWindow;
+
+			// For decay != 1 use power-based approach for calculating the moving average values
+			if(std::abs(decay - 1.0F) > std::numeric_limits<float>::epsilon()) {
+				// Exponential Decay
+				_weightFrame = [inv_window,decay](const int64_t fs, const int64_t fe, const int64_t ws) {
+					const floatT s = (fs - ws) * inv_window;
+					const floatT t = (fe - ws) * inv_window;
+
+					return (decay + 1) * (std::pow(t, decay) - std::pow(s, decay));
+				};
+			} else {
+				// For decay == 1 use linear interpolation of the moving average values
+				// Linear Decay
+				_weightFrame = [inv_window](const int64_t fs, const int64_t fe, const int64_t /*ws*/) {
+					// Linear weighting = (end - start) * scale
+					return static_cast<floatT>((fe - fs) * inv_window);
+				};
+			}
 
-		_renderedStatTime = micros();
-		_renderedCounter = 0;
-		_renderedStatCounter = 0;
-		_interpolationCounter = 0;
-		_interpolationStatCounter = 0;
+			_renderedStatTime = micros();
+			_renderedCounter = 0;
+			_renderedStatCounter = 0;
+			_interpolationCounter = 0;
+			_interpolationStatCounter = 0;
+		}
 
 		//Enable smoothing for effects with smoothing
 		if (cfgID >= SmoothingConfigID::EFFECT_DYNAMIC)
@@ -707,10 +804,11 @@ bool LinearColorSmoothing::selectConfig(int cfgID, bool force)
 
 		if (_cfgList[cfgID]._updateInterval != _updateInterval)
 		{
+			QMutexLocker locker(&_stateMutex);
 
 			_timer->stop();
 			_updateInterval = _cfgList[cfgID]._updateInterval;
-			if (this->enabled())
+			if (this->enabled() && !_outputThreadActive)
 			{
 				if (!_pause && !_targetValues.empty())
 				{
@@ -1,12 +1,118 @@
 #include <algorithm>
+#include <array>
 
 // Hyperion includes
 
 #include <utils/Logger.h>
 #include <hyperion/MultiColorAdjustment.h>
 
+namespace {
+
+// Number of nodes per color channel of the lookup tables (33^3 nodes, ~105 KiB per adjustment)
+constexpr int LUT_GRID_SIZE = 33;
+constexpr int LUT_INTERVALS = LUT_GRID_SIZE - 1;
+
+// Colors interpolated to less than this above the backlight threshold are calculated exactly,
+// as the (colored) backlight amplifies small deviations near black
+constexpr int LUT_BACKLIGHT_MARGIN = 16;
+
+// Fixed point precision of the interpolation weights
+constexpr int LUT_WEIGHT_SHIFT = 8;
+constexpr int LUT_WEIGHT_ONE = 1 << LUT_WEIGHT_SHIFT;
+
+/// Position of an 8-bit channel value in the grid
+struct GridPosition
+{
+	/// Index of the node at or below the value
+	int node;
+	/// Weight of the next node (0..LUT_WEIGHT_ONE)
+	int weight;
+};
+
+/// @return The 8-bit channel value of a grid node (nodes are evenly spread over 0..255)
+uint8_t gridValue(int node)
+{
+	return static_cast<uint8_t>((node * UINT8_MAX + LUT_INTERVALS / 2) / LUT_INTERVALS);
+}
+
+const std::array<GridPosition, 256>& gridPositions()
+{
+	static const std::array<GridPosition, 256> positions = [] {
+		std::array<GridPosition, 256> result {};
+		int node = 0;
+		for (int value = 0; value <= UINT8_MAX; ++value)
+		{
+			while (node < LUT_INTERVALS - 1 && gridValue(node + 1) <= value)
+			{
+				++node;
+			}
+			const int low = gridValue(node);
+			const int high = gridValue(node + 1);
+			result[static_cast<size_t>(value)] = { node, ((value - low) * LUT_WEIGHT_ONE + (high - low) / 2) / (high - low) };
+		}
+		return result;
+	}();
+	return positions;
+}
+
+///
+/// Looks up a color by tetrahedral interpolation of the surrounding grid nodes
+///
+/// @param table The lookup table
+/// @param color The raw color
+///
+/// @return The adjusted color
+///
+ColorRgb lookup(const ColorRgb* table, const ColorRgb& color)
+{
+	constexpr size_t stepRed = 1;
+	constexpr size_t stepGreen = LUT_GRID_SIZE;
+	constexpr size_t stepBlue = static_cast<size_t>(LUT_GRID_SIZE) * LUT_GRID_SIZE;
+
+	const std::array<GridPosition, 256>& positions = gridPositions();
+	const GridPosition& red = positions[color.red];
+	const GridPosition& green = positions[color.green];
+	const GridPosition& blue = positions[color.blue];
+
+	const ColorRgb* cell = table + static_cast<size_t>(red.node) * stepRed + static_cast<size_t>(green.node) * stepGreen + static_cast<size_t>(blue.node) * stepBlue;
+
+	// The cube is split into six tetrahedra along its diagonal, the color's tetrahedron
+	// follows the channels in order of decreasing weight
+	const int wr = red.weight;
+	const int wg = green.weight;
+	const int wb = blue.weight;
+	size_t first, second;
+	int w0, w1, w2, w3;
+	if (wr >= wg)
+	{
+		if (wg >= wb)      { first = stepRed;  second = stepRed + stepGreen;  w0 = LUT_WEIGHT_ONE - wr; w1 = wr - wg; w2 = wg - wb; w3 = wb; }
+		else if (wr >= wb) { first = stepRed;  second = stepRed + stepBlue;   w0 = LUT_WEIGHT_ONE - wr; w1 = wr - wb; w2 = wb - wg; w3 = wg; }
+		else               { first = stepBlue; second = stepBlue + stepRed;   w0 = LUT_WEIGHT_ONE - wb; w1 = wb - wr; w2 = wr - wg; w3 = wg; }
+	}
+	else
+	{
+		if (wb >= wg)      { first = stepBlue;  second = stepBlue + stepGreen; w0 = LUT_WEIGHT_ONE - wb; w1 = wb - wg; w2 = wg - wr; w3 = wr; }
+		else if (wb >= wr) { first = stepGreen; second = stepGreen + stepBlue; w0 = LUT_WEIGHT_ONE - wg; w1 = wg - wb; w2 = wb - wr; w3 = wr; }
+		else               { first = stepGreen; second = stepGreen + stepRed;  w0 = LUT_WEIGHT_ONE - wg; w1 = wg - wr; w2 = wr - wb; w3 = wb; }
+	}
+
+	const ColorRgb& c0 = cell[0];
+	const ColorRgb& c1 = cell[first];
+	const ColorRgb& c2 = cell[second];
+	const ColorRgb& c3 = cell[stepRed + stepGreen + stepBlue];
+
+	constexpr int rounding = LUT_WEIGHT_ONE / 2;
+	return ColorRgb(
+		static_cast<uint8_t>((c0.red   * w0 + c1.red   * w1 + c2.red   * w2 + c3.red   * w3 + rounding) >> LUT_WEIGHT_SHIFT),
+		static_cast<uint8_t>((c0.green * w0 + c1.green * w1 + c2.green * w2 + c3.green * w3 + rounding) >> LUT_WEIGHT_SHIFT),
+		static_cast<uint8_t>((c0.blue  * w0 + c1.blue  * w1 + c2.blue  * w2 + c3.blue  * w3 + rounding) >> LUT_WEIGHT_SHIFT));
+}
+
+} // namespace
+
 MultiColorAdjustment::MultiColorAdjustment(int ledCnt)
-	: _ledAdjustments(static_cast<size_t>(ledCnt), nullptr)
+	: _ledDescriptors(static_cast<size_t>(ledCnt), LedDescriptor{nullptr, nullptr, 0, {0, 1, 2}, false})
+	, _lookupTablesValid(false)
 	, _log(Logger::getInstance("ADJUSTMENT"))
 {
 }
@@ -24,6 +130,7 @@ void MultiColorAdjustment::addAdjustment(ColorAdjustment * adjustment)
 {
 	_adjustmentIds.push_back(adjustment->_id);
 	_adjustment.push_back(adjustment);
+	_lookupTablesValid = false;
 }
 
 void MultiColorAdjustment::setAdjustmentForLed(const QString& adjutmentId, int startLed, int endLed)
@@ -35,26 +142,27 @@ void MultiColorAdjustment::setAdjustmentForLed(const QString& adjutmentId, int s
 		return;
 	}
 	// catch wrong values
-	if(endLed > static_cast<int>(_ledAdjustments.size()-1))
+	if(endLed > static_cast<int>(_ledDescriptors.size()-1))
 	{
 		Warning(_log,"The color calibration 'LED index' field has LEDs specified which aren't part of your led layout");
-		endLed = static_cast<int>(_ledAdjustments.size()-1);
+		endLed = static_cast<int>(_ledDescriptors.size()-1);
 	}
 
 	// Get the identified adjustment (don't care if is nullptr)
 	ColorAdjustment * adjustment = getAdjustment(adjutmentId);
 	for (size_t iLed=static_cast<size_t>(startLed); iLed<=static_cast<size_t>(endLed); ++iLed)
 	{
-		_ledAdjustments[iLed] = adjustment;
+		_ledDescriptors[iLed].adjustment = adjustment;
 	}
+	_lookupTablesValid = false;
 }
 
 bool MultiColorAdjustment::verifyAdjustments() const
 {
 	bool isAdjustmentDefined = true;
-	for (unsigned iLed=0; iLed<_ledAdjustments.size(); ++iLed)
+	for (unsigned iLed=0; iLed<_ledDescriptors.size(); ++iLed)
 	{
-		const ColorAdjustment * adjustment = _ledAdjustments[iLed];
+		const ColorAdjustment * adjustment = _ledDescriptors[iLed].adjustment;
 
 		if (adjustment == nullptr)
 		{
@@ -90,73 +198,228 @@ void MultiColorAdjustment::setBacklightEnabled(bool enable)
 	{
 		adjustment->_rgbTransform.setBackLightEnabled(enable);
 	}
+	updateBacklight();
+}
+
+void MultiColorAdjustment::updateBacklight()
+{
+	for (LedDescriptor& led : _ledDescriptors)
+	{
+		led.backlightSum = (led.adjustment != nullptr) ? led.adjustment->_rgbTransform.getBacklightSumThreshold() : 0;
+	}
+}
+
+ColorRgb MultiColorAdjustment::adjustColor(ColorAdjustment& adjustment, ColorRgb color)
+{
+	uint8_t ored   = color.red;
+	uint8_t ogreen = color.green;
+	uint8_t oblue  = color.blue;
+	uint8_t B_RGB = 0;
+	uint8_t B_CMY = 0;
+	uint8_t B_W = 0;
+
+	if (!adjustment._okhsvTransform.isIdentity())
+	{
+		adjustment._okhsvTransform.transform(ored, ogreen, oblue);
+	}
+
+	adjustment._rgbTransform.applyGamma(ored,ogreen,oblue);
+	adjustment._rgbTransform.getBrightnessComponents(B_RGB, B_CMY, B_W);
+
+	uint32_t nr_ng = static_cast<uint32_t>((UINT8_MAX - ored) * (UINT8_MAX - ogreen));
+	uint32_t r_ng  = static_cast<uint32_t>(ored * (UINT8_MAX - ogreen));
+	uint32_t nr_g  = static_cast<uint32_t>((UINT8_MAX - ored) * ogreen);
+	uint32_t r_g   = static_cast<uint32_t>(ored * ogreen);
+
+	uint8_t black   = static_cast<uint8_t>(nr_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t red     = static_cast<uint8_t>(r_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t green   = static_cast<uint8_t>(nr_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t blue    = static_cast<uint8_t>(nr_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t cyan    = static_cast<uint8_t>(nr_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t magenta = static_cast<uint8_t>(r_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t yellow  = static_cast<uint8_t>(r_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
+	uint8_t white   = static_cast<uint8_t>(r_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
+
+	uint8_t OR, OG, OB;  // Original Colors
+	uint8_t RR, RG, RB;  // Red Adjustments
+	uint8_t GR, GG, GB;  // Green Adjustments
+	uint8_t BR, BG, BB;  // Blue Adjustments
+	uint8_t CR, CG, CB;  // Cyan Adjustments
+	uint8_t MR, MG, MB;  // Magenta Adjustments
+	uint8_t YR, YG, YB;  // Yellow Adjustments
+	uint8_t WR, WG, WB;  // White Adjustments
+
+	adjustment._rgbBlackAdjustment.apply  (black  , UINT8_MAX, OR, OG, OB);
+	adjustment._rgbRedAdjustment.apply    (red    , B_RGB, RR, RG, RB);
+	adjustment._rgbGreenAdjustment.apply  (green  , B_RGB, GR, GG, GB);
+	adjustment._rgbBlueAdjustment.apply   (blue   , B_RGB, BR, BG, BB);
+	adjustment._rgbCyanAdjustment.apply   (cyan   , B_CMY, CR, CG, CB);
+	adjustment._rgbMagentaAdjustment.apply(magenta, B_CMY, MR, MG, MB);
+	adjustment._rgbYellowAdjustment.apply (yellow , B_CMY, YR, YG, YB);
+	adjustment._rgbWhiteAdjustment.apply  (white  , B_W  , WR, WG, WB);
+
+	color.red   = OR + RR + GR + BR + CR + MR + YR + WR;
+	color.green = OG + RG + GG + BG + CG + MG + YG + WG;
+	color.blue  = OB + RB + GB + BB + CB + MB + YB + WB;
+
+	adjustment._rgbTransform.applyTemperature(color);
+
+	return color;
+}
+
+void MultiColorAdjustment::adjustmentsUpdated()
+{
+	_lookupTablesValid = false;
+}
+
+void MultiColorAdjustment::updateLookupTables()
+{
+	_lookupTables.resize(_adjustment.size());
+	for (LedDescriptor& led : _ledDescriptors)
+	{
+		led.lookupTable = nullptr;
+	}
+
+	for (size_t index = 0; index < _adjustment.size(); ++index)
+	{
+		ColorAdjustment* adjustment = _adjustment[index];
+		std::vector<ColorRgb>& table = _lookupTables[index];
+
+		// Only adjustments assigned to LEDs are baked
+		if (std::none_of(_ledDescriptors.begin(), _ledDescriptors.end(), [adjustment](const LedDescriptor& led) { return led.adjustment == adjustment; }))
+		{
+			table.clear();
+			table.shrink_to_fit();
+			continue;
+		}
+
+		table.resize(static_cast<size_t>(LUT_GRID_SIZE) * LUT_GRID_SIZE * LUT_GRID_SIZE);
+		size_t node = 0;
+		for (int blue = 0; blue < LUT_GRID_SIZE; ++blue)
+		{
+			for (int green = 0; green < LUT_GRID_SIZE; ++green)
+			{
+				for (int red = 0; red < LUT_GRID_SIZE; ++red)
+				{
+					table[node++] = adjustColor(*adjustment, ColorRgb(gridValue(red), gridValue(green), gridValue(blue)));
+				}
+			}
+		}
+
+		for (LedDescriptor& led : _ledDescriptors)
+		{
+			if (led.adjustment == adjustment)
+			{
+				led.lookupTable = table.data();
+			}
+		}
+	}
+
+	updateBacklight();
+
+	Debug(_log, "Color lookup tables updated");
+}
+
+ColorRgb MultiColorAdjustment::adjustLed(const LedDescriptor& led, const ColorRgb& color)
+{
+	ColorRgb adjusted = lookup(led.lookupTable, color);
+
+	// Backlight is not part of the table, as it is switched at runtime and not continuous
+	if (led.backlightSum > 0)
+	{
+		if (adjusted.red + adjusted.green + adjusted.blue < led.backlightSum + LUT_BACKLIGHT_MARGIN)
+		{
+			adjusted = adjustColor(*led.adjustment, color);
+		}
+		led.adjustment->_rgbTransform.applyBacklight(adjusted.red, adjusted.green, adjusted.green);
+	}
+	return adjusted;
 }
 
 void MultiColorAdjustment::applyAdjustment(std::vector<ColorRgb>& ledColors)
 {
-	const size_t itCnt = qMin(_ledAdjustments.size(), ledColors.size());
+	// Adjustments changed in between are caught by the next update
+	if (!_lookupTablesValid.exchange(true))
+	{
+		updateLookupTables();
+	}
+
+	const size_t itCnt = qMin(_ledDescriptors.size(), ledColors.size());
 	for (size_t i=0; i<itCnt; ++i)
 	{
-		ColorAdjustment* adjustment = _ledAdjustments[i];
-		if (adjustment == nullptr)
+		const LedDescriptor& led = _ledDescriptors[i];
+		if (led.lookupTable == nullptr)
 		{
 			// No transform set for this LED (do nothing)
 			continue;
 		}
-		ColorRgb& color = ledColors[i];
+		ledColors[i] = adjustLed(led, ledColors[i]);
+	}
+}
+
+void MultiColorAdjustment::setLedString(const LedString& ledString)
+{
+	const std::vector<Led>& leds = ledString.leds();
+	const size_t ledCnt = qMin(leds.size(), _ledDescriptors.size());
+	for (size_t i=0; i<ledCnt; ++i)
+	{
+		LedDescriptor& led = _ledDescriptors[i];
+		switch (leds[i].colorOrder)
+		{
+		case ColorOrder::ORDER_BGR:
+			led.channels[0] = 2; led.channels[1] = 1; led.channels[2] = 0;
+			break;
+		case ColorOrder::ORDER_RBG:
+			led.channels[0] = 0; led.channels[1] = 2; led.channels[2] = 1;
+			break;
+		case ColorOrder::ORDER_GRB:
+			led.channels[0] = 1; led.channels[1] = 0; led.channels[2] = 2;
+			break;
+		case ColorOrder::ORDER_GBR:
+			led.channels[0] = 1; led.channels[1] = 2; led.channels[2] = 0;
+			break;
+		case ColorOrder::ORDER_BRG:
+			led.channels[0] = 2; led.channels[1] = 0; led.channels[2] = 1;
+			break;
+		case ColorOrder::ORDER_RGB:
+		default:
+			led.channels[0] = 0; led.channels[1] = 1; led.channels[2] = 2;
+			break;
+		}
+		led.isBlacklisted = leds[i].isBlacklisted;
+	}
+}
+
+void MultiColorAdjustment::applyOutputStage(const std::vector<ColorRgb>& ledColors, bool applyBlacklist, std::vector<ColorRgb>& output)
+{
+	// Adjustments changed in between are caught by the next update
+	if (!_lookupTablesValid.exchange(true))
+	{
+		updateLookupTables();
+	}
 
-		uint8_t ored   = color.red;
-		uint8_t ogreen = color.green;
-		uint8_t oblue  = color.blue;
-		uint8_t B_RGB = 0;
-		uint8_t B_CMY = 0;
-		uint8_t B_W = 0;
+	const size_t outputCnt = qMin(output.size(), ledColors.size());
+	const size_t ledCnt = qMin(_ledDescriptors.size(), outputCnt);
+	const ColorRgb* input = ledColors.data();
+	ColorRgb* out = output.data();
 
-		if (!adjustment->_okhsvTransform.isIdentity())
+	for (size_t i=0; i<ledCnt; ++i)
+	{
+		const LedDescriptor& led = _ledDescriptors[i];
+
+		ColorRgb color = (applyBlacklist && led.isBlacklisted) ? ColorRgb::BLACK : input[i];
+		if (led.lookupTable != nullptr)
 		{
-			adjustment->_okhsvTransform.transform(ored, ogreen, oblue);
+			color = adjustLed(led, color);
 		}
 
-		adjustment->_rgbTransform.applyGamma(ored,ogreen,oblue);
-		adjustment->_rgbTransform.getBrightnessComponents(B_RGB, B_CMY, B_W);
-
-		uint32_t nr_ng = static_cast<uint32_t>((UINT8_MAX - ored) * (UINT8_MAX - ogreen));
-		uint32_t r_ng  = static_cast<uint32_t>(ored * (UINT8_MAX - ogreen));
-		uint32_t nr_g  = static_cast<uint32_t>((UINT8_MAX - ored) * ogreen);
-		uint32_t r_g   = static_cast<uint32_t>(ored * ogreen);
-
-		uint8_t black   = static_cast<uint8_t>(nr_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t red     = static_cast<uint8_t>(r_ng * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t green   = static_cast<uint8_t>(nr_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t blue    = static_cast<uint8_t>(nr_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t cyan    = static_cast<uint8_t>(nr_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t magenta = static_cast<uint8_t>(r_ng * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t yellow  = static_cast<uint8_t>(r_g * (UINT8_MAX - oblue) / DOUBLE_UINT8_MAX_SQUARED);
-		uint8_t white   = static_cast<uint8_t>(r_g * (oblue) / DOUBLE_UINT8_MAX_SQUARED);
-
-		uint8_t OR, OG, OB;  // Original Colors
-		uint8_t RR, RG, RB;  // Red Adjustments
-		uint8_t GR, GG, GB;  // Green Adjustments
-		uint8_t BR, BG, BB;  // Blue Adjustments
-		uint8_t CR, CG, CB;  // Cyan Adjustments
-		uint8_t MR, MG, MB;  // Magenta Adjustments
-		uint8_t YR, YG, YB;  // Yellow Adjustments
-		uint8_t WR, WG, WB;  // White Adjustments
-
-		adjustment->_rgbBlackAdjustment.apply  (black  , UINT8_MAX, OR, OG, OB);
-		adjustment->_rgbRedAdjustment.apply    (red    , B_RGB, RR, RG, RB);
-		adjustment->_rgbGreenAdjustment.apply  (green  , B_RGB, GR, GG, GB);
-		adjustment->_rgbBlueAdjustment.apply   (blue   , B_RGB, BR, BG, BB);
-		adjustment->_rgbCyanAdjustment.apply   (cyan   , B_CMY, CR, CG, CB);
-		adjustment->_rgbMagentaAdjustment.apply(magenta, B_CMY, MR, MG, MB);
-		adjustment->_rgbYellowAdjustment.apply (yellow , B_CMY, YR, YG, YB);
-		adjustment->_rgbWhiteAdjustment.apply  (white  , B_W  , WR, WG, WB);
-
-		color.red   = OR + RR + GR + BR + CR + MR + YR + WR;
-		color.green = OG + RG + GG + BG + CG + MG + YG + WG;
-		color.blue  = OB + RB + GB + BB + CB + MB + YB + WB;
-
-		adjustment->_rgbTransform.applyTemperature(color);
-		adjustment->_rgbTransform.applyBacklight(color.red, color.green, color.green);
+		// correct the color byte order
+		const uint8_t components[3] = { color.red, color.green, color.blue };
+		out[i].red   = components[led.channels[0]];
+		out[i].green = components[led.channels[1]];
+		out[i].blue  = components[led.channels[2]];
 	}
+
+	// LEDs not defined by the layout
+	std::copy(input + ledCnt, input + outputCnt, out + ledCnt);
 }
@@ -0,0 +1,157 @@
+#include <hyperion/PreviewEncoder.h>
+
+// STL includes
+#include <algorithm>
+
+// Qt includes
+#include <QBuffer>
+#include <QImage>
+#include <QMetaMethod>
+
+namespace {
+
+const int DEFAULT_QUALITY = 75;
+const int DEFAULT_MAX_WIDTH = 0;
+const int DEFAULT_RATE_HZ = 25;
+
+} // namespace
+
+PreviewEncoder::PreviewEncoder(const QJsonDocument& config, Logger* log, QObject* parent)
+	: QObject(parent)
+	, _log(log)
+	, _thread(new QThread())
+	, _worker(new QObject())
+	, _quality(DEFAULT_QUALITY)
+	, _maxWidth(DEFAULT_MAX_WIDTH)
+	, _minInterval_ms(1000 / DEFAULT_RATE_HZ)
+	, _isImagePending(false)
+	, _encodedFrames(0)
+	, _coalescedFrames(0)
+	, _lastEncodeTime_us(0)
+	, _maxEncodeTime_us(0)
+	, _lastSize(0)
+{
+	qRegisterMetaType<PreviewImagePtr>("PreviewImagePtr");
+
+	handleSettingsUpdate(settings::INSTCAPTURE, config);
+	_intervalTimer.start();
+
+	_thread->setObjectName("PreviewEncoderThread");
+	_worker->moveToThread(_thread.get());
+	// The worker's context makes this a queued connection into the encoder's thread
+	connect(this, &PreviewEncoder::imagePending, _worker.get(), [this]() { encodePending(); });
+	_thread->start(QThread::LowPriority);
+}
+
+PreviewEncoder::~PreviewEncoder()
+{
+	disconnect(this, &PreviewEncoder::imagePending, nullptr, nullptr);
+	_thread->quit();
+	_thread->wait();
+}
+
+void PreviewEncoder::handleSettingsUpdate(settings::type type, const QJsonDocument& config)
+{
+	if (type == settings::INSTCAPTURE)
+	{
+		const QJsonObject obj = config.object();
+		_quality = std::clamp(obj["previewQuality"].toInt(DEFAULT_QUALITY), 1, 100);
+		_maxWidth = std::max(obj["previewMaxWidth"].toInt(DEFAULT_MAX_WIDTH), 0);
+		_minInterval_ms = 1000 / std::clamp(obj["previewRate"].toInt(DEFAULT_RATE_HZ), 1, 60);
+
+		Debug(_log, "Preview: quality %d, max. width %d, min. interval %dms", _quality.load(), _maxWidth.load(), _minInterval_ms.load());
+	}
+}
+
+void PreviewEncoder::handleImage(const Image<ColorRgb>& image)
+{
+	if (!isSignalConnected(QMetaMethod::fromSignal(&PreviewEncoder::previewImage)))
+	{
+		return;
+	}
+
+	// The instance throttles the frames itself, tolerate its jitter so that an equal rate does not drop every other frame
+	if (_intervalTimer.elapsed() < _minInterval_ms * 9 / 10)
+	{
+		return;
+	}
+	_intervalTimer.start();
+
+	bool wasPending = false;
+	{
+		QMutexLocker locker(&_pendingMutex);
+		// Implicitly shared, the pixels are not copied
+		_pendingImage = image;
+		wasPending = _isImagePending;
+		_isImagePending = true;
+	}
+
+	if (wasPending)
+	{
+		++_coalescedFrames;
+	}
+	else
+	{
+		emit imagePending();
+	}
+}
+
+void PreviewEncoder::encodePending()
+{
+	Image<ColorRgb> image;
+	{
+		QMutexLocker locker(&_pendingMutex);
+		image.swap(_pendingImage);
+		_isImagePending = false;
+	}
+
+	if (image.width() == 0 || image.height() == 0)
+	{
+		return;
+	}
+
+	QElapsedTimer encodeTimer;
+	encodeTimer.start();
+
+	// Const access only, a non-const one would detach the image shared with the instance
+	const Image<ColorRgb>& source = image;
+	QImage preview(reinterpret_cast<const uchar*>(source.memptr()), source.width(), source.height(), 3 * source.width(), QImage::Format_RGB888);
+
+	const int maxWidth = _maxWidth;
+	if (maxWidth > 0 && preview.width() > maxWidth)
+	{
+		preview = preview.scaledToWidth(maxWidth, Qt::SmoothTransformation);
+	}
+
+	QSharedPointer<PreviewImage> encoded(new PreviewImage());
+	QBuffer buffer(&encoded->jpeg);
+	buffer.open(QIODevice::WriteOnly);
+	preview.save(&buffer, "jpg", _quality);
+	buffer.close();
+
+	encoded->dataUrl = QStringLiteral("data:image/jpg;base64,") + QString::fromLatin1(encoded->jpeg.toBase64());
+	encoded->width = preview.width();
+	encoded->height = preview.height();
+
+	const int64_t encodeTime_us = encodeTimer.nsecsElapsed() / 1000;
+	_lastEncodeTime_us = encodeTime_us;
+	if (encodeTime_us > _maxEncodeTime_us)
+	{
+		_maxEncodeTime_us = encodeTime_us;
+	}
+	_lastSize = encoded->jpeg.size();
+	++_encodedFrames;
+
+	emit previewImage(encoded);
+}
+
+QJsonObject PreviewEncoder::getStatistics() const
+{
+	QJsonObject statistics;
+	statistics["encodedFrames"] = static_cast<qint64>(_encodedFrames.load());
+	statistics["coalescedFrames"] = static_cast<qint64>(_coalescedFrames.load());
+	statistics["lastEncodeTime_us"] = static_cast<qint64>(_lastEncodeTime_us.load());
+	statistics["maxEncodeTime_us"] = static_cast<qint64>(_maxEncodeTime_us.load());
+	statistics["lastSize"] = _lastSize.load();
+	return statistics;
+}
@@ -3,6 +3,7 @@
 
 // qt incl
 #include <QDateTime>
+#include <QMutexLocker>
 #include <QTimer>
 
 // Hyperion includes
@@ -30,6 +31,7 @@ PriorityMuxer::PriorityMuxer(int ledCount, QObject * parent)
 	  , _updateTimer(new QTimer(this))
 	  , _timer(new QTimer(this))
 	  , _blockTimer(new QTimer(this))
+	  , _clearAllRequests(0)
 {
 	QString subComponent = parent->property("instance").toString();
 	_log= Logger::getInstance("MUXER", subComponent);
@@ -160,7 +162,7 @@ PriorityMuxer::InputsMap PriorityMuxer::getInputInfo() const
     return _activeInputs;
 }
 
-PriorityMuxer::InputInfo PriorityMuxer::getInputInfo(int priority) const
+const PriorityMuxer::InputInfo& PriorityMuxer::getInputInfo(int priority) const
 {
 	auto elemIt = _activeInputs.constFind(priority);
 	if (elemIt == _activeInputs.end())
@@ -331,6 +333,129 @@ bool PriorityMuxer::setInputImage(int priority, const Image<ColorRgb>& image, in
 	return true;
 }
 
+bool PriorityMuxer::postInputImage(int priority, const PostedImage& frame)
+{
+	// The replaced image is released after unlocking
+	Image<ColorRgb> replaced = frame.image;
+
+	QMutexLocker locker(&_mailboxMutex);
+	Mailbox& mailbox = _mailboxes[priority];
+	const bool wasPending = mailbox.pending;
+
+	mailbox.frame.image.swap(replaced);
+	mailbox.frame.timeout_ms  = frame.timeout_ms;
+	mailbox.frame.owner       = frame.owner;
+	mailbox.frame.clearEffect = frame.clearEffect;
+	mailbox.frame.isOrderedWithClears = frame.isOrderedWithClears;
+	mailbox.pending = true;
+	const bool isHeld = isHeldBack(mailbox);
+
+	++mailbox.counters.posted;
+	if (wasPending)
+	{
+		++mailbox.counters.coalesced;
+	}
+	// A held back frame is taken, when the clear is finished
+	return !wasPending && !isHeld;
+}
+
+bool PriorityMuxer::takeInputImage(int priority, PostedImage& frame)
+{
+	QMutexLocker locker(&_mailboxMutex);
+	auto mailboxIt = _mailboxes.find(priority);
+	if (mailboxIt == _mailboxes.end() || !mailboxIt->pending || isHeldBack(*mailboxIt))
+	{
+		return false;
+	}
+
+	// Swap, so that the mailbox does not keep a reference to the grabber's image
+	frame.image.swap(mailboxIt->frame.image);
+	frame.timeout_ms  = mailboxIt->frame.timeout_ms;
+	frame.owner       = mailboxIt->frame.owner;
+	frame.clearEffect = mailboxIt->frame.clearEffect;
+	frame.isOrderedWithClears = mailboxIt->frame.isOrderedWithClears;
+	mailboxIt->pending = false;
+	return true;
+}
+
+void PriorityMuxer::dropInputImage(int priority)
+{
+	QMutexLocker locker(&_mailboxMutex);
+	auto mailboxIt = _mailboxes.find(priority);
+	if (mailboxIt != _mailboxes.end() && !isHeldBack(*mailboxIt))
+	{
+		drop(*mailboxIt);
+	}
+}
+
+void PriorityMuxer::drop(Mailbox& mailbox)
+{
+	if (mailbox.pending)
+	{
+		mailbox.frame.image = Image<ColorRgb>();
+		mailbox.pending = false;
+		++mailbox.counters.dropped;
+	}
+}
+
+void PriorityMuxer::requestClear(int priority)
+{
+	QMutexLocker locker(&_mailboxMutex);
+	if (priority < 0)
+	{
+		for (Mailbox& mailbox : _mailboxes)
+		{
+			if (mailbox.frame.isOrderedWithClears)
+			{
+				drop(mailbox);
+			}
+		}
+		++_clearAllRequests;
+	}
+	else
+	{
+		Mailbox& mailbox = _mailboxes[priority];
+		drop(mailbox);
+		++mailbox.clearRequests;
+	}
+}
+
+QList<int> PriorityMuxer::finishClear(int priority)
+{
+	QMutexLocker locker(&_mailboxMutex);
+	if (priority < 0)
+	{
+		_clearAllRequests = qMax(0, _clearAllRequests - 1);
+	}
+	else
+	{
+		Mailbox& mailbox = _mailboxes[priority];
+		mailbox.clearRequests = qMax(0, mailbox.clearRequests - 1);
+	}
+
+	QList<int> heldBackPriorities;
+	for (auto mailboxIt = _mailboxes.constBegin(); mailboxIt != _mailboxes.constEnd(); ++mailboxIt)
+	{
+		if (mailboxIt->pending && mailboxIt->frame.isOrderedWithClears && !isHeldBack(*mailboxIt))
+		{
+			heldBackPriorities.append(mailboxIt.key());
+		}
+	}
+	return heldBackPriorities;
+}
+
+PriorityMuxer::MailboxCountersMap PriorityMuxer::getMailboxCounters() const
+{
+	MailboxCountersMap counters;
+
+	QMutexLocker locker(&_mailboxMutex);
+	for (auto mailboxIt = _mailboxes.constBegin(); mailboxIt != _mailboxes.constEnd(); ++mailboxIt)
+	{
+		counters.insert(mailboxIt.key(), mailboxIt->counters);
+	}
+	return counters;
+}
+
 bool PriorityMuxer::setInputInactive(int priority)
 {
 	Image<ColorRgb> image;
@@ -342,6 +467,7 @@ bool PriorityMuxer::clearInput(int priority)
 	if (priority < PriorityMuxer::LOWEST_PRIORITY)
 	{
 		_activeInputs[priority].timeoutTime_ms = REMOVE_CLEARED_PRIO;
+		dropInputImage(priority);
 		return true;
 	}
 	return false;
@@ -352,6 +478,16 @@ void PriorityMuxer::clearAll(bool forceClearAll)
 	if (forceClearAll)
 	{
 		_previousPriority = _currentPriority;
+		{
+			QMutexLocker locker(&_mailboxMutex);
+			for (Mailbox& mailbox : _mailboxes)
+			{
+				if (!isHeldBack(mailbox))
+				{
+					drop(mailbox);
+				}
+			}
+		}
 		_activeInputs.clear();
 		_currentPriority = PriorityMuxer::LOWEST_PRIORITY;
 		_activeInputs[_currentPriority] = _lowestPriorityInfo;
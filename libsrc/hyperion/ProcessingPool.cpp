@@ -0,0 +1,87 @@
+#include <hyperion/ProcessingPool.h>
+
+// Qt includes
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QMutexLocker>
+
+namespace {
+
+///
+/// Processes a single chunk and signals its completion. Allocated on the caller's stack,
+/// which waits for all chunks before returning.
+///
+class ChunkTask : public QRunnable
+{
+public:
+	ChunkTask()
+	{
+		setAutoDelete(false);
+	}
+
+	void setup(const std::function<void(int)>* function, int chunk, QSemaphore* done)
+	{
+		_function = function;
+		_chunk = chunk;
+		_done = done;
+	}
+
+	void run() override
+	{
+		(*_function)(_chunk);
+		_done->release();
+	}
+
+private:
+	const std::function<void(int)>* _function {nullptr};
+	int _chunk {0};
+	QSemaphore* _done {nullptr};
+};
+
+} // namespace
+
+ProcessingPool& ProcessingPool::getInstance()
+{
+	static ProcessingPool instance;
+	return instance;
+}
+
+ProcessingPool::ProcessingPool()
+	: _pool()
+	, _mutex()
+{
+	// Keep the workers alive between frames
+	_pool.setExpiryTimeout(-1);
+	_pool.setMaxThreadCount(1);
+}
+
+int ProcessingPool::reserveThreads(int threadCount)
+{
+	const int chunkCount = qBound(1, qMin(threadCount, QThread::idealThreadCount()), MAX_CHUNKS);
+
+	QMutexLocker locker(&_mutex);
+	// The calling thread processes one chunk itself
+	if (chunkCount - 1 > _pool.maxThreadCount())
+	{
+		_pool.setMaxThreadCount(chunkCount - 1);
+	}
+	return chunkCount;
+}
+
+void ProcessingPool::run(int chunkCount, const std::function<void(int)>& function)
+{
+	chunkCount = qBound(1, chunkCount, MAX_CHUNKS);
+
+	QSemaphore done;
+	ChunkTask tasks[MAX_CHUNKS];
+	for (int chunk = 1; chunk < chunkCount; ++chunk)
+	{
+		tasks[chunk].setup(&function, chunk, &done);
+		_pool.start(&tasks[chunk]);
+	}
+
+	function(0);
+
+	done.acquire(chunkCount - 1);
+}
@@ -0,0 +1,442 @@
+#include <hyperion/SmoothingKernels.h>
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SMOOTHING_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define SMOOTHING_NEON
+	#include <arm_neon.h>
+#endif
+
+static_assert(std::is_same<floatT, float>::value, "The SSE2 and NEON kernels process 32-bit floats only");
+
+namespace {
+
+/// The number of bits that are used for shifting the fixed point values
+const int FPShift = (sizeof(uint64_t)*8 - (12 + 9));
+
+/// The number of bits that are reduce the shifting when converting from fixed to floating point. 8 bits = 256 values
+const int SmallShiftBis = sizeof(uint8_t)*8;
+
+/// The number of bits that are used for shifting the fixed point values plus SmallShiftBis
+const int FPShiftSmall = (sizeof(uint64_t)*8 - (12 + 9 + SmallShiftBis));
+
+/// Determines the integer-scale by converting the weight to fixed point
+inline uint64_t fixedPointScale(const floatT weight)
+{
+	return (static_cast<uint64_t>(1L)<<FPShift) * static_cast<double>(weight);
+}
+
+/// Clamps the rounded values to the byte-interval of [0, 255].
+inline long clampRounded(const floatT x)
+{
+	return std::min(255L, std::max(0L, std::lroundf(x)));
+}
+
+/// Branch-free equivalent of clampRounded(), which is expressible by SIMD instructions.
+/// The value is limited first, so that it can be truncated via int32. Rounding half away from zero
+/// is done by comparing the (exact) fraction with 0.5; negative values are clamped to zero anyway.
+inline floatT roundClamped(floatT x)
+{
+	x = (x > -1.0F) ? ((x < 256.0F) ? x : 256.0F) : -1.0F;
+	const floatT truncated = static_cast<floatT>(static_cast<int32_t>(x));
+	const floatT rounded = (x - truncated >= 0.5F) ? truncated + 1.0F : truncated;
+	return (rounded > 0.0F) ? ((rounded < 255.0F) ? rounded : 255.0F) : 0.0F;
+}
+
+#if defined(SMOOTHING_SSE2)
+inline __m128 roundClamped(const __m128 value)
+{
+	const __m128 x = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0F)), _mm_set1_ps(256.0F));
+	const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	const __m128 roundUp = _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(x, truncated), _mm_set1_ps(0.5F)), _mm_set1_ps(1.0F));
+	return _mm_min_ps(_mm_max_ps(_mm_add_ps(truncated, roundUp), _mm_setzero_ps()), _mm_set1_ps(255.0F));
+}
+#elif defined(SMOOTHING_NEON)
+inline float32x4_t roundClamped(const float32x4_t value)
+{
+	const float32x4_t x = vminq_f32(vmaxq_f32(value, vdupq_n_f32(-1.0F)), vdupq_n_f32(256.0F));
+	const float32x4_t truncated = vcvtq_f32_s32(vcvtq_s32_f32(x));
+	const uint32x4_t roundUp = vandq_u32(vcgeq_f32(vsubq_f32(x, truncated), vdupq_n_f32(0.5F)), vreinterpretq_u32_f32(vdupq_n_f32(1.0F)));
+	return vminq_f32(vmaxq_f32(vaddq_f32(truncated, vreinterpretq_f32_u32(roundUp)), vdupq_n_f32(0.0F)), vdupq_n_f32(255.0F));
+}
+#endif
+
+/// Rounds a plane of values
+void roundPlane(const floatT* values, floatT* rounded, const size_t count)
+{
+	size_t i = 0;
+#if defined(SMOOTHING_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		_mm_storeu_ps(rounded + i, roundClamped(_mm_loadu_ps(values + i)));
+	}
+#elif defined(SMOOTHING_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		vst1q_f32(rounded + i, roundClamped(vld1q_f32(values + i)));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		rounded[i] = roundClamped(values[i]);
+	}
+}
+
+/// Rounds a plane of values plus their residual errors and updates the residual errors
+void ditherPlane(const floatT* values, floatT* residuals, floatT* rounded, const size_t count)
+{
+	size_t i = 0;
+#if defined(SMOOTHING_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 value = _mm_add_ps(_mm_loadu_ps(values + i), _mm_loadu_ps(residuals + i));
+		const __m128 result = roundClamped(value);
+		_mm_storeu_ps(rounded + i, result);
+		_mm_storeu_ps(residuals + i, _mm_sub_ps(value, result));
+	}
+#elif defined(SMOOTHING_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4_t value = vaddq_f32(vld1q_f32(values + i), vld1q_f32(residuals + i));
+		const float32x4_t result = roundClamped(value);
+		vst1q_f32(rounded + i, result);
+		vst1q_f32(residuals + i, vsubq_f32(value, result));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		const floatT value = values[i] + residuals[i];
+		rounded[i] = roundClamped(value);
+		residuals[i] = value - rounded[i];
+	}
+}
+
+/// Converts a plane of the fixed point accumulator to floating point. After the shift the values fit
+/// into 32 bits (the weights of the frames are bounded by the window), which allows the conversion via int32.
+void normalizePlane(const uint64_t* accumulator, floatT* values, const floatT scale, const size_t count)
+{
+	size_t i = 0;
+#if defined(SMOOTHING_SSE2)
+	const __m128 factor = _mm_set1_ps(scale);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128i low = _mm_srli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i)), FPShiftSmall);
+		const __m128i high = _mm_srli_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulator + i + 2)), FPShiftSmall);
+		const __m128i packed = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(values + i, _mm_mul_ps(_mm_cvtepi32_ps(packed), factor));
+	}
+#elif defined(SMOOTHING_NEON)
+	for (; i + 4 <= count; i += 4)
+	{
+		const uint32x2_t low = vmovn_u64(vshrq_n_u64(vld1q_u64(accumulator + i), FPShiftSmall));
+		const uint32x2_t high = vmovn_u64(vshrq_n_u64(vld1q_u64(accumulator + i + 2), FPShiftSmall));
+		vst1q_f32(values + i, vmulq_n_f32(vcvtq_f32_u32(vcombine_u32(low, high)), scale));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		values[i] = static_cast<floatT>(static_cast<int32_t>(accumulator[i] >> FPShiftSmall)) * scale;
+	}
+}
+
+} // namespace
+
+//
+// Interleaved kernels
+//
+
+void InterleavedSmoothingKernels::resize(const size_t ledCount)
+{
+	if (_ledCount != ledCount)
+	{
+		_ledCount = ledCount;
+
+		const size_t len = 3 * ledCount;
+
+		_meanValues = std::vector<floatT>(len, 0.0F);
+		_residualErrors = std::vector<floatT>(len, 0.0F);
+		_accumulator = std::vector<uint64_t>(len, 0L);
+	}
+}
+
+void InterleavedSmoothingKernels::clear()
+{
+	_ledCount = 0;
+	_meanValues.clear();
+	_residualErrors.clear();
+	_accumulator.clear();
+	_windowSums.clear();
+}
+
+void InterleavedSmoothingKernels::resetAccumulator()
+{
+	std::fill(_accumulator.begin(), _accumulator.end(), 0L);
+}
+
+void InterleavedSmoothingKernels::aggregate(const std::vector<ColorRgb>& colors, const floatT weight)
+{
+	const uint64_t scale = fixedPointScale(weight);
+
+	const size_t N = std::min(colors.size(), _ledCount);
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		const ColorRgb &color = colors[i];
+
+		// Scale the colors and accumulate them
+		_accumulator[3 * i + 0] += scale * color.red;
+		_accumulator[3 * i + 1] += scale * color.green;
+		_accumulator[3 * i + 2] += scale * color.blue;
+	}
+}
+
+void InterleavedSmoothingKernels::normalize(const floatT inverseWeight)
+{
+	const floatT scale = inverseWeight / (1 << SmallShiftBis);
+
+	for (size_t i = 0; i < 3 * _ledCount; ++i)
+	{
+		_meanValues[i] = (_accumulator[i] >> FPShiftSmall) * scale;
+	}
+}
+
+void InterleavedSmoothingKernels::resetWindowSums(const size_t ledCount)
+{
+	_windowSums.assign(3 * ledCount, 0);
+}
+
+void InterleavedSmoothingKernels::addToWindowSums(const std::vector<ColorRgb>& colors, const uint64_t duration)
+{
+	const size_t N = std::min(colors.size(), windowSumsLedCount());
+	for (size_t i = 0; i < N; ++i)
+	{
+		_windowSums[3 * i + 0] += duration * colors[i].red;
+		_windowSums[3 * i + 1] += duration * colors[i].green;
+		_windowSums[3 * i + 2] += duration * colors[i].blue;
+	}
+}
+
+void InterleavedSmoothingKernels::subtractFromWindowSums(const std::vector<ColorRgb>& colors, const uint64_t duration)
+{
+	const size_t N = std::min(colors.size(), windowSumsLedCount());
+	for (size_t i = 0; i < N; ++i)
+	{
+		_windowSums[3 * i + 0] -= duration * colors[i].red;
+		_windowSums[3 * i + 1] -= duration * colors[i].green;
+		_windowSums[3 * i + 2] -= duration * colors[i].blue;
+	}
+}
+
+void InterleavedSmoothingKernels::averageWindow(const std::vector<ColorRgb>& oldest, const uint64_t oldestTime, const std::vector<ColorRgb>& newest, const uint64_t newestTime, const floatT inverseWindow)
+{
+	const size_t N = std::min({_ledCount, windowSumsLedCount(), oldest.size(), newest.size()});
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		const ColorRgb &o = oldest[i];
+		const ColorRgb &n = newest[i];
+
+		_meanValues[3 * i + 0] = static_cast<floatT>(_windowSums[3 * i + 0] + oldestTime * o.red   + newestTime * n.red)   * inverseWindow;
+		_meanValues[3 * i + 1] = static_cast<floatT>(_windowSums[3 * i + 1] + oldestTime * o.green + newestTime * n.green) * inverseWindow;
+		_meanValues[3 * i + 2] = static_cast<floatT>(_windowSums[3 * i + 2] + oldestTime * o.blue  + newestTime * n.blue)  * inverseWindow;
+	}
+}
+
+void InterleavedSmoothingKernels::assemble(std::vector<ColorRgb>& colors)
+{
+	const size_t N = std::min(colors.size(), _ledCount);
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		// Convert to to 8-bit value
+		ColorRgb &color = colors[i];
+		color.red = static_cast<uint8_t>(clampRounded(_meanValues[3 * i + 0]));
+		color.green = static_cast<uint8_t>(clampRounded(_meanValues[3 * i + 1]));
+		color.blue = static_cast<uint8_t>(clampRounded(_meanValues[3 * i + 2]));
+	}
+}
+
+void InterleavedSmoothingKernels::assembleAndDither(std::vector<ColorRgb>& colors)
+{
+	const size_t N = std::min(colors.size(), _ledCount);
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		// Add residuals for error diffusion (temporal dithering)
+		const floatT fr = _meanValues[3 * i + 0] + _residualErrors[3 * i + 0];
+		const floatT fg = _meanValues[3 * i + 1] + _residualErrors[3 * i + 1];
+		const floatT fb = _meanValues[3 * i + 2] + _residualErrors[3 * i + 2];
+
+		// Convert to to 8-bit value
+		const long ir = clampRounded(fr);
+		const long ig = clampRounded(fg);
+		const long ib = clampRounded(fb);
+
+		// Update the colors
+		ColorRgb &color = colors[i];
+		color.red = static_cast<uint8_t>(ir);
+		color.green = static_cast<uint8_t>(ig);
+		color.blue = static_cast<uint8_t>(ib);
+
+		// Determine the component errors
+		_residualErrors[3 * i + 0] = fr - ir;
+		_residualErrors[3 * i + 1] = fg - ig;
+		_residualErrors[3 * i + 2] = fb - ib;
+	}
+}
+
+//
+// Planar kernels
+//
+
+void PlanarSmoothingKernels::resize(const size_t ledCount)
+{
+	if (_ledCount != ledCount)
+	{
+		_ledCount = ledCount;
+
+		const size_t len = 3 * ledCount;
+
+		_meanValues = std::vector<floatT>(len, 0.0F);
+		_residualErrors = std::vector<floatT>(len, 0.0F);
+		_rounded = std::vector<floatT>(len, 0.0F);
+		_accumulator = std::vector<uint64_t>(len, 0L);
+	}
+}
+
+void PlanarSmoothingKernels::clear()
+{
+	_ledCount = 0;
+	_meanValues.clear();
+	_residualErrors.clear();
+	_rounded.clear();
+	_accumulator.clear();
+	_windowSums.clear();
+}
+
+void PlanarSmoothingKernels::resetAccumulator()
+{
+	std::fill(_accumulator.begin(), _accumulator.end(), 0L);
+}
+
+void PlanarSmoothingKernels::aggregate(const std::vector<ColorRgb>& colors, const floatT weight)
+{
+	const uint64_t scale = fixedPointScale(weight);
+
+	const size_t N = std::min(colors.size(), _ledCount);
+	uint64_t* red = _accumulator.data();
+	uint64_t* green = red + _ledCount;
+	uint64_t* blue = green + _ledCount;
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		red[i] += scale * colors[i].red;
+		green[i] += scale * colors[i].green;
+		blue[i] += scale * colors[i].blue;
+	}
+}
+
+void PlanarSmoothingKernels::normalize(const floatT inverseWeight)
+{
+	normalizePlane(_accumulator.data(), _meanValues.data(), inverseWeight / (1 << SmallShiftBis), 3 * _ledCount);
+}
+
+void PlanarSmoothingKernels::resetWindowSums(const size_t ledCount)
+{
+	_windowSums.assign(3 * ledCount, 0);
+}
+
+void PlanarSmoothingKernels::addToWindowSums(const std::vector<ColorRgb>& colors, const uint64_t duration)
+{
+	const size_t count = windowSumsLedCount();
+	const size_t N = std::min(colors.size(), count);
+	uint64_t* red = _windowSums.data();
+	uint64_t* green = red + count;
+	uint64_t* blue = green + count;
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		red[i] += duration * colors[i].red;
+		green[i] += duration * colors[i].green;
+		blue[i] += duration * colors[i].blue;
+	}
+}
+
+void PlanarSmoothingKernels::subtractFromWindowSums(const std::vector<ColorRgb>& colors, const uint64_t duration)
+{
+	const size_t count = windowSumsLedCount();
+	const size_t N = std::min(colors.size(), count);
+	uint64_t* red = _windowSums.data();
+	uint64_t* green = red + count;
+	uint64_t* blue = green + count;
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		red[i] -= duration * colors[i].red;
+		green[i] -= duration * colors[i].green;
+		blue[i] -= duration * colors[i].blue;
+	}
+}
+
+void PlanarSmoothingKernels::averageWindow(const std::vector<ColorRgb>& oldest, const uint64_t oldestTime, const std::vector<ColorRgb>& newest, const uint64_t newestTime, const floatT inverseWindow)
+{
+	const size_t count = windowSumsLedCount();
+	const size_t N = std::min({_ledCount, count, oldest.size(), newest.size()});
+	const uint64_t* sumRed = _windowSums.data();
+	const uint64_t* sumGreen = sumRed + count;
+	const uint64_t* sumBlue = sumGreen + count;
+	floatT* red = _meanValues.data();
+	floatT* green = red + _ledCount;
+	floatT* blue = green + _ledCount;
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		red[i]   = static_cast<floatT>(sumRed[i]   + oldestTime * oldest[i].red   + newestTime * newest[i].red)   * inverseWindow;
+		green[i] = static_cast<floatT>(sumGreen[i] + oldestTime * oldest[i].green + newestTime * newest[i].green) * inverseWindow;
+		blue[i]  = static_cast<floatT>(sumBlue[i]  + oldestTime * oldest[i].blue  + newestTime * newest[i].blue)  * inverseWindow;
+	}
+}
+
+void PlanarSmoothingKernels::assemble(std::vector<ColorRgb>& colors)
+{
+	const size_t N = std::min(colors.size(), _ledCount);
+	for (size_t plane = 0; plane < 3; ++plane)
+	{
+		const size_t offset = plane * _ledCount;
+		roundPlane(_meanValues.data() + offset, _rounded.data() + offset, N);
+	}
+	storeRounded(colors);
+}
+
+void PlanarSmoothingKernels::assembleAndDither(std::vector<ColorRgb>& colors)
+{
+	const size_t N = std::min(colors.size(), _ledCount);
+	for (size_t plane = 0; plane < 3; ++plane)
+	{
+		const size_t offset = plane * _ledCount;
+		ditherPlane(_meanValues.data() + offset, _residualErrors.data() + offset, _rounded.data() + offset, N);
+	}
+	storeRounded(colors);
+}
+
+void PlanarSmoothingKernels::storeRounded(std::vector<ColorRgb>& colors) const
+{
+	const size_t N = std::min(colors.size(), _ledCount);
+	const floatT* red = _rounded.data();
+	const floatT* green = red + _ledCount;
+	const floatT* blue = green + _ledCount;
+
+	for (size_t i = 0; i < N; ++i)
+	{
+		ColorRgb &color = colors[i];
+		color.red = static_cast<uint8_t>(red[i]);
+		color.green = static_cast<uint8_t>(green[i]);
+		color.blue = static_cast<uint8_t>(blue[i]);
+	}
+}
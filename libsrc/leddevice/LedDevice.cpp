@@ -17,6 +17,9 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 
 // Constants
 namespace {
@@ -34,10 +37,16 @@ namespace {
 
 	const char CONFIG_ENABLE_ATTEMPTS[] = "enableAttempts";
 	const char CONFIG_ENABLE_ATTEMPTS_INTERVALL[] = "enableAttemptsInterval";
+	const char CONFIG_SKIP_UNCHANGED_FRAMES[] = "skipUnchangedFrames";
+	const char CONFIG_CHANGE_THRESHOLD[] = "changeThreshold";
 
 	const int DEFAULT_MAX_ENABLE_ATTEMPTS{ 5 };
 	constexpr std::chrono::seconds DEFAULT_ENABLE_ATTEMPTS_INTERVAL{ 5 };
 
+	const bool DEFAULT_IS_SKIP_UNCHANGED_FRAMES{ false };
+	const int DEFAULT_CHANGE_THRESHOLD{ 0 };
+	const int MAX_CHANGE_THRESHOLD{ 32 };
+
 } //End of constants
 
 LedDevice::LedDevice(const QJsonObject& deviceConfig, QObject* parent)
@@ -58,12 +67,18 @@ LedDevice::LedDevice(const QJsonObject& deviceConfig, QObject* parent)
 	, _isDeviceInError(false)
 	, _isDeviceRecoverable(false)
 	, _lastWriteTime(QDateTime::currentDateTime())
+	, _isPartialWriteSupported(false)
+	, _changedLedsBegin(0)
+	, _changedLedsEnd(std::numeric_limits<int>::max())
 	, _enableAttemptsTimer(nullptr)
 	, _enableAttemptTimerInterval(DEFAULT_ENABLE_ATTEMPTS_INTERVAL)
 	, _enableAttempts(0)
 	, _maxEnableAttempts(DEFAULT_MAX_ENABLE_ATTEMPTS)
 	, _isRefreshEnabled(false)
 	, _isAutoStart(true)
+	, _isSkipUnchangedFrames(DEFAULT_IS_SKIP_UNCHANGED_FRAMES)
+	, _changeThreshold(DEFAULT_CHANGE_THRESHOLD)
+	, _skippedFrames(0)
 {
 	_activeDeviceType = deviceConfig["type"].toString("UNSPECIFIED").toLower();
 }
@@ -228,6 +243,8 @@ bool LedDevice::init(const QJsonObject& deviceConfig)
 	setEnableAttempts(deviceConfig[CONFIG_ENABLE_ATTEMPTS].toInt(DEFAULT_MAX_ENABLE_ATTEMPTS),
 	std::chrono::seconds(deviceConfig[CONFIG_ENABLE_ATTEMPTS_INTERVALL].toInt(DEFAULT_ENABLE_ATTEMPTS_INTERVAL.count()))
 	);
+	setChangeDetection(deviceConfig[CONFIG_SKIP_UNCHANGED_FRAMES].toBool(DEFAULT_IS_SKIP_UNCHANGED_FRAMES),
+					   deviceConfig[CONFIG_CHANGE_THRESHOLD].toInt(DEFAULT_CHANGE_THRESHOLD));
 
 	return true;
 }
@@ -304,7 +321,7 @@ void LedDevice::stopEnableAttemptsTimer()
 	}
 }
 
-int LedDevice::updateLeds(std::vector<ColorRgb> ledValues)
+int LedDevice::updateLeds(const std::vector<ColorRgb>& ledValues)
 {
 	int retval = 0;
 	if (!_isEnabled || !_isOn || !_isDeviceReady || _isDeviceInError)
@@ -317,14 +334,30 @@ int LedDevice::updateLeds(std::vector<ColorRgb> ledValues)
 		qint64 elapsedTimeMs = _lastWriteTime.msecsTo(QDateTime::currentDateTime());
 		if (_latchTime_ms == 0 || elapsedTimeMs >= _latchTime_ms)
 		{
-			retval = write(ledValues);
-			_lastWriteTime = QDateTime::currentDateTime();
-
-			// if device requires refreshing, save Led-Values and restart the timer
-			if (_isRefreshEnabled && _isEnabled)
+			if (_isSkipUnchangedFrames && !detectChangedLeds(ledValues))
+			{
+				// Skip write as nothing changed, a running refresh timer still rewrites the last values written
+				++_skippedFrames;
+			}
+			else
 			{
-				_lastLedValues = ledValues;
-				this->startRefreshTimer();
+				retval = write(ledValues);
+				_lastWriteTime = QDateTime::currentDateTime();
+
+				_changedLedsBegin = 0;
+				_changedLedsEnd = std::numeric_limits<int>::max();
+				if (retval != 0)
+				{
+					// The device's state is unknown, write the next update completely
+					_writtenLedValues.clear();
+				}
+
+				// if device requires refreshing, save Led-Values and restart the timer
+				if (_isRefreshEnabled && _isEnabled)
+				{
+					_lastLedValues = _isSkipUnchangedFrames && !_writtenLedValues.empty() ? _writtenLedValues : ledValues;
+					this->startRefreshTimer();
+				}
 			}
 		}
 		else
@@ -340,6 +373,57 @@ int LedDevice::updateLeds(std::vector<ColorRgb> ledValues)
 	return retval;
 }
 
+bool LedDevice::detectChangedLeds(const std::vector<ColorRgb>& ledValues)
+{
+	const size_t ledCount = ledValues.size();
+	if (_writtenLedValues.size() != ledCount)
+	{
+		_writtenLedValues = ledValues;
+		_changedLedsBegin = 0;
+		_changedLedsEnd = static_cast<int>(ledCount);
+		return true;
+	}
+
+	if (_changeThreshold == 0 && memcmp(_writtenLedValues.data(), ledValues.data(), ledCount * sizeof(ColorRgb)) == 0)
+	{
+		return false;
+	}
+
+	const auto isChanged = [this](uint8_t written, uint8_t value) {
+		return std::abs(static_cast<int>(written) - static_cast<int>(value)) > _changeThreshold;
+	};
+
+	size_t begin = ledCount;
+	size_t end = 0;
+	for (size_t i = 0; i < ledCount; ++i)
+	{
+		const ColorRgb& written = _writtenLedValues[i];
+		const ColorRgb& value = ledValues[i];
+		if (isChanged(written.red, value.red) || isChanged(written.green, value.green) || isChanged(written.blue, value.blue))
+		{
+			begin = std::min(begin, i);
+			end = i + 1;
+		}
+	}
+
+	if (begin >= end)
+	{
+		return false;
+	}
+
+	if (!_isPartialWriteSupported)
+	{
+		// The device writes all LEDs
+		begin = 0;
+		end = ledCount;
+	}
+
+	std::copy(ledValues.begin() + static_cast<long>(begin), ledValues.begin() + static_cast<long>(end), _writtenLedValues.begin() + static_cast<long>(begin));
+	_changedLedsBegin = static_cast<int>(begin);
+	_changedLedsEnd = static_cast<int>(end);
+	return true;
+}
+
 int LedDevice::rewriteLEDs()
 {
 	int retval = -1;
@@ -380,6 +464,9 @@ int LedDevice::writeColor(const ColorRgb& color, int numberOfWrites)
 		_lastLedValues = std::vector<ColorRgb>(static_cast<unsigned long>(_ledCount), color);
 		rc = write(_lastLedValues);
 	}
+
+	// Write the next update completely
+	_writtenLedValues.clear();
 	return rc;
 }
 
@@ -403,6 +490,8 @@ bool LedDevice::switchOn()
 				{
 					Info(_log, "Device %s is ON", QSTRING_CSTR(_activeDeviceType));
 					_isOn = true;
+					// The device's LED state is unknown, write the first update completely
+					_writtenLedValues.clear();
 					rc = true;
 				}
 				else
@@ -610,6 +699,18 @@ void LedDevice::setRewriteTime(int rewriteTime_ms)
 	}
 }
 
+void LedDevice::setChangeDetection(bool isSkipUnchangedFrames, int changeThreshold)
+{
+	_isSkipUnchangedFrames = isSkipUnchangedFrames;
+	_changeThreshold = qBound(0, changeThreshold, MAX_CHANGE_THRESHOLD);
+	_writtenLedValues.clear();
+
+	if (_isSkipUnchangedFrames)
+	{
+		Debug(_log, "Skip unchanged updates, change threshold: %d", _changeThreshold);
+	}
+}
+
 void LedDevice::setEnableAttempts(int maxEnableRetries, std::chrono::seconds enableRetryTimerInterval)
 {
 	stopEnableAttemptsTimer();
@@ -17,6 +17,7 @@
 #include <QThread>
 #include <QDir>
 #include <QEventLoop>
+#include <QMutexLocker>
 
 LedDeviceRegistry LedDeviceWrapper::_ledDeviceMap {};
 static std::once_flag initFlag;
@@ -28,6 +29,11 @@ LedDeviceWrapper::LedDeviceWrapper(Hyperion* hyperion)
 	, _ledDevice(nullptr)
 	, _isEnabled(false)
 	, _isOn(false)
+	, _acceptFrames(false)
+	, _deliveryPending(false)
+	, _publishedFrames(0)
+	, _deliveredFrames(0)
+	, _coalescedFrames(0)
 {
 	QString const subComponent = parent()->property("instance").toString();
 	_log = Logger::getInstance("LEDDEVICE", subComponent);
@@ -54,7 +60,8 @@ void LedDeviceWrapper::createLedDevice(const QJsonObject& config)
 	_ledDevice->moveToThread(_ledDeviceThread.get());
 
 	connect(_ledDeviceThread.get(), &QThread::started, _ledDevice.get(), &LedDevice::start);
-	connect(this, &LedDeviceWrapper::updateLeds, _ledDevice.get(), &LedDevice::updateLeds);
+	// The device's context makes this a queued connection into the LED-device's thread
+	connect(this, &LedDeviceWrapper::frameAvailable, _ledDevice.get(), [this]() { deliverFrame(); });
 	connect(this, &LedDeviceWrapper::switchOn, _ledDevice.get(), &LedDevice::switchOn);
 	connect(this, &LedDeviceWrapper::switchOff, _ledDevice.get(), &LedDevice::switchOff);
 	connect(this, &LedDeviceWrapper::enable, _ledDevice.get(), &LedDevice::enable);
@@ -66,6 +73,63 @@ void LedDeviceWrapper::createLedDevice(const QJsonObject& config)
 	connect(_ledDevice.get(), &LedDevice::isOnChanged, this, &LedDeviceWrapper::onIsOnChanged);
 
 	_ledDeviceThread->start();
+
+	QMutexLocker locker(&_producerMutex);
+	_acceptFrames = true;
+}
+
+int LedDeviceWrapper::updateLeds(const std::vector<ColorRgb>& ledValues)
+{
+	QMutexLocker locker(&_producerMutex);
+	if (!_acceptFrames)
+	{
+		return -1;
+	}
+
+	// Assignment reuses the capacity of the back buffer
+	_ledFrames.back() = ledValues;
+	++_publishedFrames;
+	if (_ledFrames.publish())
+	{
+		++_coalescedFrames;
+	}
+
+	// Wake the device only once until it has taken the frame; later frames just replace the pending one
+	if (!_deliveryPending.exchange(true, std::memory_order_acq_rel))
+	{
+		emit frameAvailable();
+	}
+	return 0;
+}
+
+void LedDeviceWrapper::deliverFrame()
+{
+	// Reset before taking the frame, so that a frame published afterwards wakes the device again
+	_deliveryPending.exchange(false, std::memory_order_acq_rel);
+	if (_ledFrames.consume())
+	{
+		++_deliveredFrames;
+		_ledDevice->updateLeds(_ledFrames.front());
+	}
+}
+
+QJsonObject LedDeviceWrapper::getStatistics() const
+{
+	QJsonObject statistics;
+	statistics["publishedFrames"] = static_cast<qint64>(_publishedFrames.load());
+	statistics["deliveredFrames"] = static_cast<qint64>(_deliveredFrames.load());
+	statistics["coalescedFrames"] = static_cast<qint64>(_coalescedFrames.load());
+	if (!_ledDevice.isNull())
+	{
+		statistics["skippedFrames"] = static_cast<qint64>(_ledDevice->getSkippedFrameCount());
+
+		const QJsonObject transport = _ledDevice->getTransportStatistics();
+		if (!transport.isEmpty())
+		{
+			statistics["transport"] = transport;
+		}
+	}
+	return statistics;
 }
 
 void LedDeviceWrapper::handleComponentState(hyperion::Components component, bool state)
@@ -103,7 +167,12 @@ void LedDeviceWrapper::stopDevice()
 	Debug(_log, "Stop LED-Device thread");
 
 	//Disable updates to the LedDevice
-	disconnect(this, &LedDeviceWrapper::updateLeds, _ledDevice.get(), &LedDevice::updateLeds);
+	{
+		QMutexLocker locker(&_producerMutex);
+		_acceptFrames = false;
+	}
+	disconnect(this, &LedDeviceWrapper::frameAvailable, nullptr, nullptr);
+	_deliveryPending = false;
 	disconnect(this, &LedDeviceWrapper::switchOff, _ledDevice.get(), &LedDevice::switchOff);
 	disconnect(this, &LedDeviceWrapper::disable, _ledDevice.get(), &LedDevice::disable);
 	disconnect(this, &LedDeviceWrapper::enable, _ledDevice.get(), &LedDevice::enable);
@@ -88,7 +88,6 @@ void LedDeviceUdpArtNet::prepare(unsigned this_universe, unsigned this_sequence,
 
 int LedDeviceUdpArtNet::write(const std::vector<ColorRgb> &ledValues)
 {
-	int retVal            = 0;
 	int thisUniverse	= _artnet_universe;
 	const uint8_t * rawdata = reinterpret_cast<const uint8_t *>(ledValues.data());
 
@@ -117,7 +116,8 @@ The Sequence field is set to 0x00 to disable this feature.
 		if ( (ledIdx == _ledRGBCount-1) || (dmxIdx >= DMX_MAX) )
 		{
 			prepare(thisUniverse, _artnet_seq, dmxIdx);
-			retVal &= writeBytes(18 + qMin(dmxIdx, DMX_MAX), artnet_packet.raw);
+			const unsigned packetSize = static_cast<unsigned>(18 + qMin(dmxIdx, DMX_MAX));
+			memcpy(appendDatagram(packetSize), artnet_packet.raw, packetSize);
 
 			memset(artnet_packet.raw, 0, sizeof(artnet_packet.raw));
 			thisUniverse ++;
@@ -126,5 +126,6 @@ The Sequence field is set to 0x00 to disable this feature.
 
 	}
 
-	return retVal;
+	// All universes of the frame are sent together
+	return writeDatagrams();
 }
@@ -1,5 +1,7 @@
 #include "LedDeviceUdpDdp.h"
 
+#include <cstring>
+
 #include <QtEndian>
 
 #include <utils/NetUtils.h>
@@ -85,12 +87,15 @@ bool LedDeviceUdpDdp::init(const QJsonObject &deviceConfig)
 		Debug(_log, "Hostname/IP       : %s", QSTRING_CSTR(_hostName) );
 		Debug(_log, "Port              : %d", _port );
 
-		_ddpData.resize(DDP::HEADER_LEN + DDP::CHANNELS_PER_PACKET);
+		// Header template of the packets
+		_ddpData.resize(DDP::HEADER_LEN);
 		_ddpData[0] = DDP::flags1::VER1; // flags1
 		_ddpData[1] = 0;				 // flags2
 		_ddpData[2] = 1;				 // type
 		_ddpData[3] = DDP::id::DISPLAY;	 // id
 
+		_isPartialWriteSupported = true;
+
 		isInitOK = true;
 	}
 	return isInitOK;
@@ -115,49 +120,41 @@ int LedDeviceUdpDdp::open()
 
 int LedDeviceUdpDdp::write(const std::vector<ColorRgb> &ledValues)
 {
-	int rc {0};
-
-	int channelCount = static_cast<int>(_ledCount) * 3; // 1 channel for every R,G,B value
-	int packetCount = ((channelCount-1) / DDP::CHANNELS_PER_PACKET) + 1;
-	int channel = 0;
-
-	_ddpData[0] = DDP::flags1::VER1;
+	// DDP addresses packets by channel offset, i.e. only the LEDs changed are sent
+	int ledCount = static_cast<int>(qMin(static_cast<size_t>(_ledCount), ledValues.size()));
+	int channel = qMin(_changedLedsBegin, ledCount) * 3; // 1 channel for every R,G,B value
+	int channelEnd = qMin(_changedLedsEnd, ledCount) * 3;
+	const uint8_t* rawData = reinterpret_cast<const uint8_t*>(ledValues.data());
 
-	for (int currentPacket = 0; currentPacket < packetCount; currentPacket++)
+	while (channel < channelEnd)
 	{
 		if (_packageSequenceNumber > 15)
 		{
 			_packageSequenceNumber = 0;
 		}
 
-		int packetSize = DDP::CHANNELS_PER_PACKET;
+		int packetSize = qMin(DDP::CHANNELS_PER_PACKET, channelEnd - channel);
+		char flags = DDP::flags1::VER1;
 
-		if (currentPacket == (packetCount - 1))
+		if (channel + packetSize == channelEnd)
 		{
 			// last packet, set the push flag
-			/*0*/_ddpData[0] = DDP::flags1::VER1 | DDP::flags1::PUSH;
-
-			if (channelCount % DDP::CHANNELS_PER_PACKET != 0)
-			{
-				packetSize = channelCount % DDP::CHANNELS_PER_PACKET;
-			}
+			flags = DDP::flags1::VER1 | DDP::flags1::PUSH;
 		}
 
-		/*1*/_ddpData[1] = static_cast<char>(_packageSequenceNumber++ & 0x0F);
-		/*4*/qToBigEndian<quint32>(static_cast<quint32>(channel), _ddpData.data() + 4);
-		/*8*/qToBigEndian<quint16>(static_cast<quint16>(packetSize), _ddpData.data() + 8);
+		// All packets of the frame are built in the batch and sent together
+		uint8_t* packet = appendDatagram(static_cast<unsigned>(DDP::HEADER_LEN + packetSize));
+		memcpy(packet, _ddpData.constData(), DDP::HEADER_LEN);
 
-		_ddpData.replace(DDP::HEADER_LEN, channel, reinterpret_cast<const char*>(ledValues.data())+channel, packetSize);
-		_ddpData.resize(DDP::HEADER_LEN + packetSize);
+		/*0*/packet[0] = static_cast<uint8_t>(flags);
+		/*1*/packet[1] = static_cast<uint8_t>(_packageSequenceNumber++ & 0x0F);
+		/*4*/qToBigEndian<quint32>(static_cast<quint32>(channel), packet + 4);
+		/*8*/qToBigEndian<quint16>(static_cast<quint16>(packetSize), packet + 8);
 
-		rc = writeBytes(_ddpData);
+		memcpy(packet + DDP::HEADER_LEN, rawData + channel, static_cast<size_t>(packetSize));
 
-		if (rc != 0)
-		{
-			break;
-		}
 		channel += packetSize;
 	}
-	return rc;
+	return writeDatagrams();
 }
 
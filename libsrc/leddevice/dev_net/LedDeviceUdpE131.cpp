@@ -138,7 +138,6 @@ void LedDeviceUdpE131::prepare(unsigned this_universe, unsigned this_dmxChannelC
 
 int LedDeviceUdpE131::write(const std::vector<ColorRgb> &ledValues)
 {
-	int retVal            = 0;
 	int thisChannelCount = 0;
 	int dmxChannelCount  = _ledRGBCount;
 	const uint8_t * rawdata = reinterpret_cast<const uint8_t *>(ledValues.data());
@@ -170,9 +169,11 @@ int LedDeviceUdpE131::write(const std::vector<ColorRgb> &ledValues)
 				, E131_DMP_DATA + 1 + thisChannelCount
 				);
 #endif
-			retVal &= writeBytes(E131_DMP_DATA + 1 + thisChannelCount, e131_packet.raw);
+			const unsigned packetSize = static_cast<unsigned>(E131_DMP_DATA + 1 + thisChannelCount);
+			memcpy(appendDatagram(packetSize), e131_packet.raw, packetSize);
 		}
 	}
 
-	return retVal;
+	// All universes of the frame are sent together
+	return writeDatagrams();
 }
@@ -3,12 +3,19 @@
 #include <cstdio>
 #include <iostream>
 #include <exception>
+#include <chrono>
 // Linux includes
 #include <fcntl.h>
+#if defined(__linux__)
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#endif
 
 #include <QStringList>
 #include <QUdpSocket>
 #include <QHostInfo>
+#include <QJsonObject>
 
 // mDNS discover
 #ifdef ENABLE_MDNS
@@ -19,10 +26,32 @@
 // Local Hyperion includes
 #include "ProviderUdp.h"
 
+namespace {
+#if defined(__linux__)
+/// The kernel accepts at most 64 segments and 64 kB per GSO send
+const size_t GSO_MAX_SEGMENTS = 64;
+const size_t GSO_MAX_BYTES = 65000;
+#endif
+} // namespace
+
 ProviderUdp::ProviderUdp(const QJsonObject& deviceConfig)
 	: LedDevice(deviceConfig)
 	  , _udpSocket(nullptr)
 	  , _port(-1)
+#if defined(__linux__)
+	  , _destination{}
+	  , _destinationLength(0)
+	  , _destinationPort(-1)
+	  , _isSegmentationEnabled(true)
+#endif
+	  , _framesSent(0)
+	  , _datagramsSent(0)
+	  , _sendCalls(0)
+	  , _sendErrors(0)
+	  , _lastSendTime(0)
+	  , _maxSendTime(0)
+	  , _totalSendTime(0)
+	  , _lastFrameDatagrams(0)
 {
 	_latchTime_ms = 0;
 }
@@ -111,3 +140,276 @@ int ProviderUdp::writeBytes(const QByteArray& bytes)
 	}
 	return  rc;
 }
+
+uint8_t* ProviderUdp::appendDatagram(unsigned size)
+{
+	const size_t offset = _batchBuffer.size();
+	_batchBuffer.resize(offset + size);
+	_batchDatagrams.push_back({offset, size});
+	return _batchBuffer.data() + offset;
+}
+
+int ProviderUdp::writeDatagrams()
+{
+	if (_batchDatagrams.empty())
+	{
+		return 0;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+#if defined(__linux__)
+	int rc = sendBatch();
+#else
+	int rc = sendDatagrams(0);
+#endif
+	const int64_t sendTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	++_framesSent;
+	_datagramsSent += _batchDatagrams.size();
+	_lastFrameDatagrams = static_cast<unsigned>(_batchDatagrams.size());
+	_lastSendTime = sendTime;
+	_totalSendTime += sendTime;
+	if (sendTime > _maxSendTime.load(std::memory_order_relaxed))
+	{
+		_maxSendTime.store(sendTime, std::memory_order_relaxed);
+	}
+	if (rc != 0)
+	{
+		++_sendErrors;
+	}
+
+	// Keeps the capacity for the next frame
+	_batchBuffer.clear();
+	_batchDatagrams.clear();
+	return rc;
+}
+
+int ProviderUdp::sendDatagrams(size_t first)
+{
+	int rc = 0;
+	for (size_t i = first; i < _batchDatagrams.size(); ++i)
+	{
+		++_sendCalls;
+		rc = writeBytes(_batchDatagrams[i].size, _batchBuffer.data() + _batchDatagrams[i].offset);
+		if (rc != 0)
+		{
+			break;
+		}
+	}
+	return rc;
+}
+
+#if defined(__linux__)
+int ProviderUdp::sendBatch()
+{
+	const int descriptor = static_cast<int>(_udpSocket->socketDescriptor());
+	if (descriptor < 0 || !updateDestination(descriptor))
+	{
+		return sendDatagrams(0);
+	}
+
+	const size_t count = _batchDatagrams.size();
+	size_t next = 0;
+	// Segmentation is used for this batch, until a segmented send fails
+	bool isSegmenting = _isSegmentationEnabled;
+	while (next < count)
+	{
+		if (isSegmenting)
+		{
+			const size_t segments = segmentableCount(next);
+			if (segments > 1)
+			{
+				if (sendSegmented(descriptor, next, segments))
+				{
+					next += segments;
+					continue;
+				}
+
+				isSegmenting = false;
+				const int error = errno;
+				if (error == EINVAL || error == EIO || error == ENOPROTOOPT || error == EOPNOTSUPP)
+				{
+					// Not supported by the kernel or the network device
+					Info(_log, "UDP segmentation offload not available (%s), using sendmmsg", strerror(error));
+					_isSegmentationEnabled = false;
+				}
+				else
+				{
+					// Transient error (e.g. no buffer space), retry the segments of this batch via sendmmsg
+					Debug(_log, "UDP segmentation offload failed (%s), using sendmmsg for this frame", strerror(error));
+				}
+			}
+		}
+
+		// Send the remaining datagrams, the kernel may accept less than requested
+		_messages.resize(count);
+		_ioVectors.resize(count);
+		for (size_t i = next; i < count; ++i)
+		{
+			_ioVectors[i].iov_base = _batchBuffer.data() + _batchDatagrams[i].offset;
+			_ioVectors[i].iov_len = _batchDatagrams[i].size;
+			_messages[i] = {};
+			_messages[i].msg_hdr.msg_name = &_destination;
+			_messages[i].msg_hdr.msg_namelen = _destinationLength;
+			_messages[i].msg_hdr.msg_iov = &_ioVectors[i];
+			_messages[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		++_sendCalls;
+		const int sent = sendmmsg(descriptor, &_messages[next], static_cast<unsigned>(count - next), 0);
+		if (sent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			Warning(_log, "%s", QSTRING_CSTR(QString("(%1:%2) Write Error: %3").arg(_address.toString()).arg(_port).arg(strerror(errno))));
+			return -1;
+		}
+		next += static_cast<size_t>(sent);
+	}
+	return 0;
+}
+
+size_t ProviderUdp::segmentableCount(size_t first) const
+{
+#ifdef UDP_SEGMENT
+	// All segments must have the same size, only the last one may be shorter
+	const unsigned segmentSize = _batchDatagrams[first].size;
+	size_t bytes = segmentSize;
+	size_t count = 1;
+	while (first + count < _batchDatagrams.size() && count < GSO_MAX_SEGMENTS)
+	{
+		const unsigned size = _batchDatagrams[first + count].size;
+		if (size > segmentSize || bytes + size > GSO_MAX_BYTES)
+		{
+			break;
+		}
+		bytes += size;
+		++count;
+		if (size < segmentSize)
+		{
+			break;
+		}
+	}
+	return count;
+#else
+	Q_UNUSED(first);
+	return 1;
+#endif
+}
+
+bool ProviderUdp::sendSegmented(int descriptor, size_t first, size_t count)
+{
+#ifdef UDP_SEGMENT
+	const Datagram& last = _batchDatagrams[first + count - 1];
+	iovec ioVector {};
+	ioVector.iov_base = _batchBuffer.data() + _batchDatagrams[first].offset;
+	ioVector.iov_len = last.offset + last.size - _batchDatagrams[first].offset;
+
+	alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] {};
+	msghdr message {};
+	message.msg_name = &_destination;
+	message.msg_namelen = _destinationLength;
+	message.msg_iov = &ioVector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof(control);
+
+	cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+	controlMessage->cmsg_level = IPPROTO_UDP;
+	controlMessage->cmsg_type = UDP_SEGMENT;
+	controlMessage->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+	const uint16_t segmentSize = static_cast<uint16_t>(_batchDatagrams[first].size);
+	memcpy(CMSG_DATA(controlMessage), &segmentSize, sizeof(segmentSize));
+
+	ssize_t sent;
+	do
+	{
+		++_sendCalls;
+		sent = sendmsg(descriptor, &message, 0);
+	} while (sent < 0 && errno == EINTR);
+
+	if (sent >= 0 && sent != static_cast<ssize_t>(ioVector.iov_len))
+	{
+		// Not expected for UDP, but errno is not set by a partial send
+		errno = EMSGSIZE;
+		return false;
+	}
+	return sent >= 0;
+#else
+	Q_UNUSED(descriptor);
+	Q_UNUSED(first);
+	Q_UNUSED(count);
+	return false;
+#endif
+}
+
+bool ProviderUdp::updateDestination(int descriptor)
+{
+	if (_destinationLength != 0 && _destinationAddress == _address && _destinationPort == _port)
+	{
+		return true;
+	}
+
+	_destinationLength = 0;
+	_destinationAddress = _address;
+	_destinationPort = _port;
+
+	// The socket bound to QHostAddress::Any is dual-stack, i.e. IPv4 destinations are to be given as IPv4-mapped IPv6 addresses
+	sockaddr_storage local {};
+	socklen_t localLength = sizeof(local);
+	if (getsockname(descriptor, reinterpret_cast<sockaddr*>(&local), &localLength) != 0)
+	{
+		return false;
+	}
+
+	bool isIpv4 = false;
+	const quint32 ipv4 = _address.toIPv4Address(&isIpv4);
+
+	_destination = {};
+	if (local.ss_family == AF_INET && isIpv4)
+	{
+		sockaddr_in* destination = reinterpret_cast<sockaddr_in*>(&_destination);
+		destination->sin_family = AF_INET;
+		destination->sin_port = htons(static_cast<uint16_t>(_port));
+		destination->sin_addr.s_addr = htonl(ipv4);
+		_destinationLength = sizeof(sockaddr_in);
+	}
+	else if (local.ss_family == AF_INET6 && _address.scopeId().isEmpty())
+	{
+		sockaddr_in6* destination = reinterpret_cast<sockaddr_in6*>(&_destination);
+		destination->sin6_family = AF_INET6;
+		destination->sin6_port = htons(static_cast<uint16_t>(_port));
+		if (isIpv4)
+		{
+			destination->sin6_addr.s6_addr[10] = 0xff;
+			destination->sin6_addr.s6_addr[11] = 0xff;
+			const uint32_t address = htonl(ipv4);
+			memcpy(&destination->sin6_addr.s6_addr[12], &address, sizeof(address));
+		}
+		else
+		{
+			const Q_IPV6ADDR address = _address.toIPv6Address();
+			memcpy(destination->sin6_addr.s6_addr, address.c, sizeof(address.c));
+		}
+		_destinationLength = sizeof(sockaddr_in6);
+	}
+	return _destinationLength != 0;
+}
+#endif
+
+QJsonObject ProviderUdp::getTransportStatistics() const
+{
+	const uint64_t frames = _framesSent;
+	QJsonObject statistics;
+	statistics["frames"] = static_cast<qint64>(frames);
+	statistics["datagrams"] = static_cast<qint64>(_datagramsSent.load());
+	statistics["sendCalls"] = static_cast<qint64>(_sendCalls.load());
+	statistics["sendErrors"] = static_cast<qint64>(_sendErrors.load());
+	statistics["lastFrameDatagrams"] = static_cast<qint64>(_lastFrameDatagrams.load());
+	statistics["lastSendTime_us"] = static_cast<qint64>(_lastSendTime.load());
+	statistics["maxSendTime_us"] = static_cast<qint64>(_maxSendTime.load());
+	statistics["avgSendTime_us"] = frames > 0 ? static_cast<qint64>(_totalSendTime.load() / static_cast<int64_t>(frames)) : 0;
+	return statistics;
+}
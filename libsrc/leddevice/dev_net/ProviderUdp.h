@@ -7,13 +7,27 @@
 // Hyperion includes
 #include <utils/Logger.h>
 
+// STL includes
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
 // Qt includes
 #include <QHostAddress>
 #include <QUdpSocket>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
 ///
 /// The ProviderUdp implements an abstract base-class for LedDevices using UDP packets.
 ///
+/// Devices sending several datagrams per frame collect them by appendDatagram() and send them by writeDatagrams().
+/// On Linux, the batch is submitted with a single sendmmsg() call, or with UDP segmentation offload (GSO) where the
+/// datagrams are of equal size, instead of one system call per datagram.
+///
 class ProviderUdp : public LedDevice
 {
 public:
@@ -30,6 +44,13 @@ public:
 
 	QHostAddress getAddress() const { return _address; }
 
+	///
+	/// @brief Get the send statistics, i.e. frames, datagrams, system calls and send times
+	///
+	/// @return A JSON structure holding the statistics
+	///
+	QJsonObject getTransportStatistics() const override;
+
 protected:
 
 	///
@@ -65,11 +86,102 @@ protected:
 	///
 	int writeBytes(const QByteArray& bytes);
 
+	///
+	/// @brief Appends a datagram to the batch of the current frame
+	///
+	/// The datagram is built in place in a scatter buffer, which keeps its capacity from frame to frame.
+	///
+	/// @param[in] size The length of the datagram
+	///
+	/// @return The zero-initialised datagram, valid till the next call
+	///
+	uint8_t* appendDatagram(unsigned size);
+
+	///
+	/// @brief Sends all datagrams appended since the last call and clears the batch
+	///
+	/// @return Zero on success, else negative
+	///
+	int writeDatagrams();
+
 	///
 	QUdpSocket*  _udpSocket;
 	QString      _hostName;
 	QHostAddress _address;
 	int       _port;
+
+private:
+
+	struct Datagram
+	{
+		size_t offset;
+		unsigned size;
+	};
+
+	///
+	/// @brief Sends the datagrams of the batch one by one via the Qt socket
+	///
+	/// @param[in] first The first datagram to send
+	///
+	/// @return Zero on success, else negative
+	///
+	int sendDatagrams(size_t first);
+
+#if defined(__linux__)
+	///
+	/// @brief Sends the datagrams of the batch by as few system calls as possible
+	///
+	/// @return Zero on success, else negative
+	///
+	int sendBatch();
+
+	///
+	/// @brief Sends the given datagrams as one buffer segmented by the kernel (UDP GSO)
+	///
+	/// @param[in] descriptor The socket
+	/// @param[in] first The first datagram
+	/// @param[in] count The number of datagrams
+	///
+	/// @return True on success, otherwise errno is set
+	///
+	bool sendSegmented(int descriptor, size_t first, size_t count);
+
+	///
+	/// @brief Number of consecutive datagrams starting at the given one, which can be sent as one GSO buffer
+	///
+	size_t segmentableCount(size_t first) const;
+
+	///
+	/// @brief Updates the socket address of the destination after a change of address or port
+	///
+	/// @param[in] descriptor The socket
+	///
+	/// @return True, if the destination can be addressed by the socket
+	///
+	bool updateDestination(int descriptor);
+
+	sockaddr_storage _destination;
+	socklen_t _destinationLength;
+	QHostAddress _destinationAddress;
+	int _destinationPort;
+	/// Cleared, if the kernel or the network device does not support UDP segmentation offload
+	bool _isSegmentationEnabled;
+	std::vector<mmsghdr> _messages;
+	std::vector<iovec> _ioVectors;
+#endif
+
+	/// The datagrams of the current frame, stored back to back
+	std::vector<uint8_t> _batchBuffer;
+	std::vector<Datagram> _batchDatagrams;
+
+	std::atomic<uint64_t> _framesSent;
+	std::atomic<uint64_t> _datagramsSent;
+	std::atomic<uint64_t> _sendCalls;
+	std::atomic<uint64_t> _sendErrors;
+	std::atomic<int64_t> _lastSendTime;
+	std::atomic<int64_t> _maxSendTime;
+	std::atomic<int64_t> _totalSendTime;
+	std::atomic<unsigned> _lastFrameDatagrams;
 };
 
 #endif // PROVIDERUDP_H
@@ -31,39 +31,28 @@ ProtoClientConnection::ProtoClientConnection(QTcpSocket* socket, int timeout, QO
 
 void ProtoClientConnection::readyRead()
 {
-	_receiveBuffer += _socket->readAll();
-
-	// check if we can read a message size
-	if (_receiveBuffer.size() <= 4)
+	// read complete messages straight from the socket, the message is valid till the next read
+	FramedReader::Result result;
+	while ((result = _messageReader.read(_socket)) == FramedReader::Result::MessageReady)
 	{
-		return;
-	}
-
-	// read the message size
-	uint32_t messageSize =
-			((_receiveBuffer[0]<<24) & 0xFF000000) |
-			((_receiveBuffer[1]<<16) & 0x00FF0000) |
-			((_receiveBuffer[2]<< 8) & 0x0000FF00) |
-			((_receiveBuffer[3]    ) & 0x000000FF);
+		// read a message
+		proto::HyperionRequest message;
+		if (!message.ParseFromArray(_messageReader.data(), static_cast<int>(_messageReader.size())))
+		{
+			sendErrorReply("Unable to parse message");
+			continue;
+		}
 
-	// check if we can read a complete message
-	if ((uint32_t) _receiveBuffer.size() < messageSize + 4)
-	{
-		return;
+		// handle the message
+		handleMessage(message);
 	}
 
-	// read a message
-	proto::HyperionRequest message;
-	if (!message.ParseFromArray(_receiveBuffer.data() + 4, messageSize))
+	if (result == FramedReader::Result::MessageTooLarge)
 	{
-		sendErrorReply("Unable to parse message");
+		Error(_log, "Message of %u bytes exceeds the limit - drop connection with client %s", _messageReader.size(), QSTRING_CSTR(_clientAddress));
+		sendErrorReply("Message too large");
+		forceClose();
 	}
-
-	// handle the message
-	handleMessage(message);
-
-	// remove message data from buffer
-	_receiveBuffer = _receiveBuffer.mid(messageSize + 4);
 }
 
 void ProtoClientConnection::forceClose()
@@ -11,6 +11,7 @@
 #include <utils/ColorRgb.h>
 #include <utils/ColorRgba.h>
 #include <utils/Components.h>
+#include <utils/FramedReader.h>
 
 class QTcpSocket;
 class QTimer;
@@ -159,6 +160,6 @@ private:
 	int _timeout;
 	int _priority;
 
-	/// The buffer used for reading data from the socket
-	QByteArray _receiveBuffer;
+	/// Reads the messages from the socket
+	FramedReader _messageReader;
 };
@@ -0,0 +1,146 @@
+#include <utils/FramePool.h>
+
+// STL includes
+#include <atomic>
+#include <new>
+
+namespace {
+
+// Four size classes per power of two from MIN_POOLED_SIZE (2^12) up to MAX_POOLED_SIZE (2^27)
+constexpr int MIN_POOLED_SHIFT = 12;
+constexpr int CLASSES_PER_POWER = 4;
+constexpr int CLASS_COUNT = (27 - MIN_POOLED_SHIFT + 1) * CLASSES_PER_POWER;
+
+static_assert(FramePool::MIN_POOLED_SIZE == static_cast<size_t>(1) << MIN_POOLED_SHIFT, "MIN_POOLED_SIZE does not match MIN_POOLED_SHIFT");
+
+// Constant initialized, so the pool is usable during static initialization and destruction of images
+std::atomic<void*> slots[CLASS_COUNT][FramePool::SLOTS_PER_CLASS] {};
+
+std::atomic<uint64_t> hits {0};
+std::atomic<uint64_t> misses {0};
+std::atomic<uint64_t> discards {0};
+std::atomic<uint64_t> cachedBytes {0};
+
+///
+/// @param[in] index The size class
+/// @return The size of the buffers in the class
+///
+size_t classCapacity(int index)
+{
+	// Class boundaries are (5 + i) * 2^(msb - 2), msb being the most significant bit of (size - 1)
+	const int shift = (MIN_POOLED_SHIFT - 3) + index / CLASSES_PER_POWER;
+	return static_cast<size_t>(CLASSES_PER_POWER + 1 + index % CLASSES_PER_POWER) << shift;
+}
+
+///
+/// Determines the size class of a buffer
+///
+/// @param[in] bytes The size requested
+/// @param[out] capacity The size of the buffers in this class
+/// @return The class index or -1, if the size is not pooled
+///
+int sizeClass(size_t bytes, size_t& capacity)
+{
+	capacity = bytes;
+	if (bytes < FramePool::MIN_POOLED_SIZE || bytes > FramePool::MAX_POOLED_SIZE)
+	{
+		return -1;
+	}
+
+	const size_t value = bytes - 1;
+	int msb = MIN_POOLED_SHIFT - 1;
+	while ((value >> (msb + 1)) != 0)
+	{
+		++msb;
+	}
+	const size_t quarter = value >> (msb - 2);
+
+	const int index = (msb - (MIN_POOLED_SHIFT - 1)) * CLASSES_PER_POWER + static_cast<int>(quarter) - CLASSES_PER_POWER;
+	capacity = classCapacity(index);
+	return index;
+}
+
+} // namespace
+
+void* FramePool::allocate(size_t bytes)
+{
+	size_t capacity {0};
+	const int index = sizeClass(bytes, capacity);
+	if (index >= 0)
+	{
+		for (std::atomic<void*>& slot : slots[index])
+		{
+			if (slot.load(std::memory_order_relaxed) == nullptr)
+			{
+				continue;
+			}
+
+			void* buffer = slot.exchange(nullptr, std::memory_order_acquire);
+			if (buffer != nullptr)
+			{
+				cachedBytes.fetch_sub(capacity, std::memory_order_relaxed);
+				hits.fetch_add(1, std::memory_order_relaxed);
+				return buffer;
+			}
+		}
+		misses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return ::operator new(capacity);
+}
+
+void FramePool::release(void* buffer, size_t bytes)
+{
+	if (buffer == nullptr)
+	{
+		return;
+	}
+
+	size_t capacity {0};
+	const int index = sizeClass(bytes, capacity);
+	if (index >= 0)
+	{
+		if (cachedBytes.fetch_add(capacity, std::memory_order_relaxed) + capacity <= MAX_CACHED_BYTES)
+		{
+			for (std::atomic<void*>& slot : slots[index])
+			{
+				void* expected = nullptr;
+				if (slot.load(std::memory_order_relaxed) == nullptr &&
+					slot.compare_exchange_strong(expected, buffer, std::memory_order_release, std::memory_order_relaxed))
+				{
+					return;
+				}
+			}
+		}
+		cachedBytes.fetch_sub(capacity, std::memory_order_relaxed);
+		discards.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	::operator delete(buffer);
+}
+
+void FramePool::clear()
+{
+	for (int index = 0; index < CLASS_COUNT; ++index)
+	{
+		for (std::atomic<void*>& slot : slots[index])
+		{
+			void* buffer = slot.exchange(nullptr, std::memory_order_acquire);
+			if (buffer != nullptr)
+			{
+				cachedBytes.fetch_sub(classCapacity(index), std::memory_order_relaxed);
+				::operator delete(buffer);
+			}
+		}
+	}
+}
+
+FramePool::Statistics FramePool::statistics()
+{
+	return {
+		hits.load(std::memory_order_relaxed),
+		misses.load(std::memory_order_relaxed),
+		discards.load(std::memory_order_relaxed),
+		cachedBytes.load(std::memory_order_relaxed)
+	};
+}
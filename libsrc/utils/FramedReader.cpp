@@ -0,0 +1,110 @@
+#include <utils/FramedReader.h>
+
+// STL includes
+#include <algorithm>
+
+// Qt includes
+#include <QtEndian>
+
+FramedReader::FramedReader(uint32_t maxMessageSize)
+	: _maxMessageSize(maxMessageSize)
+	, _header{}
+	, _headerBytes(0)
+	, _messageSize(0)
+	, _messageBytes(0)
+	, _recentMaxSize(0)
+	, _recentMessages(0)
+	, _isMessageComplete(false)
+	, _isMessageTooLarge(false)
+{
+}
+
+FramedReader::Result FramedReader::read(QIODevice* device)
+{
+	if (_isMessageTooLarge)
+	{
+		return Result::MessageTooLarge;
+	}
+
+	// Start the next message, the buffer of the previous one is reused
+	if (_isMessageComplete)
+	{
+		// Do not keep the memory of a single large message (e.g. a 4K image) for a stream of small ones
+		if (_recentMessages >= SHRINK_INTERVAL)
+		{
+			if (_buffer.size() > 2 * static_cast<size_t>(_recentMaxSize) && _buffer.size() > MIN_READ_SIZE)
+			{
+				releaseBuffer();
+			}
+			_recentMaxSize = 0;
+			_recentMessages = 0;
+		}
+
+		_headerBytes = 0;
+		_messageSize = 0;
+		_messageBytes = 0;
+		_isMessageComplete = false;
+	}
+
+	while (_headerBytes < HEADER_SIZE)
+	{
+		const qint64 bytesRead = device->read(reinterpret_cast<char*>(_header.data()) + _headerBytes, HEADER_SIZE - _headerBytes);
+		if (bytesRead <= 0)
+		{
+			return Result::NeedMoreData;
+		}
+		_headerBytes += static_cast<int>(bytesRead);
+
+		if (_headerBytes == HEADER_SIZE)
+		{
+			_messageSize = qFromBigEndian<quint32>(_header.data());
+			if (_messageSize > _maxMessageSize)
+			{
+				_isMessageTooLarge = true;
+				releaseBuffer();
+				return Result::MessageTooLarge;
+			}
+		}
+	}
+
+	while (_messageBytes < _messageSize)
+	{
+		// Grown by the data available only, a header alone does not commit the memory of the message announced.
+		// The size is kept between messages, so that the buffer is initialized once for the largest one.
+		const uint32_t remaining = _messageSize - _messageBytes;
+		const uint32_t available = static_cast<uint32_t>(std::min<qint64>(std::max<qint64>(device->bytesAvailable(), MIN_READ_SIZE), remaining));
+		if (_buffer.size() < static_cast<size_t>(_messageBytes) + available)
+		{
+			_buffer.resize(static_cast<size_t>(_messageBytes) + available);
+		}
+
+		const qint64 bytesRead = device->read(reinterpret_cast<char*>(_buffer.data()) + _messageBytes, available);
+		if (bytesRead <= 0)
+		{
+			return Result::NeedMoreData;
+		}
+		_messageBytes += static_cast<uint32_t>(bytesRead);
+	}
+
+	_recentMaxSize = std::max(_recentMaxSize, _messageSize);
+	++_recentMessages;
+	_isMessageComplete = true;
+	return Result::MessageReady;
+}
+
+void FramedReader::reset()
+{
+	_headerBytes = 0;
+	_messageSize = 0;
+	_messageBytes = 0;
+	_isMessageComplete = false;
+	_isMessageTooLarge = false;
+	releaseBuffer();
+}
+
+void FramedReader::releaseBuffer()
+{
+	std::vector<uint8_t>().swap(_buffer);
+	_recentMaxSize = 0;
+	_recentMessages = 0;
+}
@@ -2,6 +2,313 @@
 #include <utils/ColorSys.h>
 #include <utils/Logger.h>
 
+// STL includes
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define RESAMPLER_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define RESAMPLER_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Number of pixels converted from YUV to RGB at once
+constexpr int YUV_BATCH_SIZE = 8;
+
+///
+/// Geometry of a resampling pass (after cropping and 3D mode handling)
+///
+struct Geometry
+{
+	const uint8_t* data;
+	int width;
+	int height;
+	size_t lineLength;
+	int xSourceStart;
+	int ySourceStart;
+	int xStep;
+	int yStep;
+	int outputWidth;
+	int outputHeight;
+};
+
+///
+/// Converts a batch of YUV pixels to RGB, bit-exact to ColorSys::yuv2rgb()
+///
+void yuvToRgb(const int16_t y[YUV_BATCH_SIZE], const int16_t u[YUV_BATCH_SIZE], const int16_t v[YUV_BATCH_SIZE],
+			  uint8_t r[YUV_BATCH_SIZE], uint8_t g[YUV_BATCH_SIZE], uint8_t b[YUV_BATCH_SIZE])
+{
+#if defined(RESAMPLER_SSE2)
+	const __m128i c = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y)), _mm_set1_epi16(16));
+	const __m128i d = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(u)), _mm_set1_epi16(128));
+	const __m128i e = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(v)), _mm_set1_epi16(128));
+	const __m128i one = _mm_set1_epi16(1);
+
+	// Interleave the components to calculate the weighted sums by pairwise multiply-add in 32-bit
+	const __m128i ceLow  = _mm_unpacklo_epi16(c, e);
+	const __m128i ceHigh = _mm_unpackhi_epi16(c, e);
+	const __m128i cdLow  = _mm_unpacklo_epi16(c, d);
+	const __m128i cdHigh = _mm_unpackhi_epi16(c, d);
+	const __m128i e1Low  = _mm_unpacklo_epi16(e, one);
+	const __m128i e1High = _mm_unpackhi_epi16(e, one);
+
+	const __m128i round = _mm_set1_epi32(128);
+	const __m128i redWeights   = _mm_setr_epi16(298, 409, 298, 409, 298, 409, 298, 409);
+	const __m128i blueWeights  = _mm_setr_epi16(298, 516, 298, 516, 298, 516, 298, 516);
+	const __m128i greenWeights = _mm_setr_epi16(298, -100, 298, -100, 298, -100, 298, -100);
+	const __m128i greenWeightsE = _mm_setr_epi16(-208, 128, -208, 128, -208, 128, -208, 128);
+
+	auto pack = [](__m128i low, __m128i high) {
+		const __m128i values = _mm_packs_epi32(_mm_srai_epi32(low, 8), _mm_srai_epi32(high, 8));
+		return _mm_packus_epi16(values, values);
+	};
+
+	const __m128i red = pack(_mm_add_epi32(_mm_madd_epi16(ceLow, redWeights), round),
+							 _mm_add_epi32(_mm_madd_epi16(ceHigh, redWeights), round));
+	const __m128i green = pack(_mm_add_epi32(_mm_madd_epi16(cdLow, greenWeights), _mm_madd_epi16(e1Low, greenWeightsE)),
+							   _mm_add_epi32(_mm_madd_epi16(cdHigh, greenWeights), _mm_madd_epi16(e1High, greenWeightsE)));
+	const __m128i blue = pack(_mm_add_epi32(_mm_madd_epi16(cdLow, blueWeights), round),
+							  _mm_add_epi32(_mm_madd_epi16(cdHigh, blueWeights), round));
+
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(r), red);
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(g), green);
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(b), blue);
+#elif defined(RESAMPLER_NEON)
+	const int16x8_t c = vsubq_s16(vld1q_s16(y), vdupq_n_s16(16));
+	const int16x8_t d = vsubq_s16(vld1q_s16(u), vdupq_n_s16(128));
+	const int16x8_t e = vsubq_s16(vld1q_s16(v), vdupq_n_s16(128));
+	const int32x4_t round = vdupq_n_s32(128);
+
+	auto weighted = [&](int16x4_t c4, int16x4_t d4, int16x4_t e4, int16_t cw, int16_t dw, int16_t ew) {
+		int32x4_t sum = vmlal_n_s16(round, c4, cw);
+		sum = vmlal_n_s16(sum, d4, dw);
+		sum = vmlal_n_s16(sum, e4, ew);
+		return vshrq_n_s32(sum, 8);
+	};
+	auto convert = [&](int16_t cw, int16_t dw, int16_t ew) {
+		const int32x4_t low  = weighted(vget_low_s16(c),  vget_low_s16(d),  vget_low_s16(e),  cw, dw, ew);
+		const int32x4_t high = weighted(vget_high_s16(c), vget_high_s16(d), vget_high_s16(e), cw, dw, ew);
+		return vqmovun_s16(vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+	};
+
+	vst1_u8(r, convert(298, 0, 409));
+	vst1_u8(g, convert(298, -100, -208));
+	vst1_u8(b, convert(298, 516, 0));
+#else
+	for (int i = 0; i < YUV_BATCH_SIZE; ++i)
+	{
+		ColorSys::yuv2rgb(static_cast<uint8_t>(y[i]), static_cast<uint8_t>(u[i]), static_cast<uint8_t>(v[i]), r[i], g[i], b[i]);
+	}
+#endif
+}
+
+///
+/// Access to the pixels of a source row, specialized per pixel format
+///
+template <PixelFormat pixelFormat>
+struct SourceRow;
+
+template <>
+struct SourceRow<PixelFormat::YUYV>
+{
+	static constexpr bool isYuv = true;
+	const uint8_t* row;
+
+	SourceRow(const Geometry& geometry, int ySource) : row(geometry.data + geometry.lineLength * ySource) {}
+
+	void yuv(int x, int16_t& y, int16_t& u, int16_t& v) const
+	{
+		const uint8_t* pair = row + ((x >> 1) << 2);
+		y = pair[(x & 1) << 1];
+		u = pair[1];
+		v = pair[3];
+	}
+};
+
+template <>
+struct SourceRow<PixelFormat::UYVY>
+{
+	static constexpr bool isYuv = true;
+	const uint8_t* row;
+
+	SourceRow(const Geometry& geometry, int ySource) : row(geometry.data + geometry.lineLength * ySource) {}
+
+	void yuv(int x, int16_t& y, int16_t& u, int16_t& v) const
+	{
+		const uint8_t* pair = row + ((x >> 1) << 2);
+		y = pair[((x & 1) << 1) + 1];
+		u = pair[0];
+		v = pair[2];
+	}
+};
+
+template <>
+struct SourceRow<PixelFormat::NV12>
+{
+	static constexpr bool isYuv = true;
+	const uint8_t* row;
+	const uint8_t* uvRow;
+
+	SourceRow(const Geometry& geometry, int ySource)
+		: row(geometry.data + geometry.lineLength * ySource)
+		, uvRow(geometry.data + (geometry.height + ySource / 2) * geometry.lineLength)
+	{}
+
+	void yuv(int x, int16_t& y, int16_t& u, int16_t& v) const
+	{
+		y = row[x];
+		u = uvRow[(x >> 1) << 1];
+		v = uvRow[((x >> 1) << 1) + 1];
+	}
+};
+
+template <>
+struct SourceRow<PixelFormat::I420>
+{
+	static constexpr bool isYuv = true;
+	const uint8_t* row;
+	const uint8_t* uRow;
+	const uint8_t* vRow;
+
+	SourceRow(const Geometry& geometry, int ySource)
+		: row(geometry.data + geometry.lineLength * ySource)
+		, uRow(geometry.data + geometry.width * geometry.height + (ySource / 2) * geometry.width / 2)
+		, vRow(geometry.data + geometry.width * geometry.height + (geometry.width * geometry.height) / 4 + (ySource / 2) * geometry.width / 2)
+	{}
+
+	void yuv(int x, int16_t& y, int16_t& u, int16_t& v) const
+	{
+		y = row[x];
+		u = uRow[x >> 1];
+		v = vRow[x >> 1];
+	}
+};
+
+template <>
+struct SourceRow<PixelFormat::BGR16>
+{
+	static constexpr bool isYuv = false;
+	const uint8_t* row;
+
+	SourceRow(const Geometry& geometry, int ySource) : row(geometry.data + geometry.lineLength * ySource) {}
+
+	void rgb(int x, ColorRgb& rgb) const
+	{
+		const uint8_t* pixel = row + (x << 1);
+		rgb.blue  = static_cast<uint8_t>((pixel[0] & 0x1f) << 3);
+		rgb.green = static_cast<uint8_t>((((pixel[1] & 0x7) << 3) | (pixel[0] & 0xE0) >> 5) << 2);
+		rgb.red   = static_cast<uint8_t>(pixel[1] & 0xF8);
+	}
+};
+
+///
+/// Packed 8-bit RGB formats with the given pixel size and channel order
+///
+template <int pixelSize, bool bgr>
+struct PackedRgbRow
+{
+	static constexpr bool isYuv = false;
+	const uint8_t* row;
+
+	PackedRgbRow(const Geometry& geometry, int ySource) : row(geometry.data + geometry.lineLength * ySource) {}
+
+	void rgb(int x, ColorRgb& rgb) const
+	{
+		const uint8_t* pixel = row + x * pixelSize;
+		rgb.red   = pixel[bgr ? 2 : 0];
+		rgb.green = pixel[1];
+		rgb.blue  = pixel[bgr ? 0 : 2];
+	}
+};
+
+template <> struct SourceRow<PixelFormat::RGB24> : PackedRgbRow<3, false> { using PackedRgbRow::PackedRgbRow; };
+template <> struct SourceRow<PixelFormat::BGR24> : PackedRgbRow<3, true>  { using PackedRgbRow::PackedRgbRow; };
+template <> struct SourceRow<PixelFormat::RGB32> : PackedRgbRow<4, false> { using PackedRgbRow::PackedRgbRow; };
+template <> struct SourceRow<PixelFormat::BGR32> : PackedRgbRow<4, true>  { using PackedRgbRow::PackedRgbRow; };
+
+///
+/// Crops, decimates, flips and converts an image in a single pass
+///
+template <PixelFormat pixelFormat, FlipMode flipMode>
+void resample(const Geometry& geometry, Image<ColorRgb>& outputImage)
+{
+	// Note: a horizontal flip mirrors the rows, a vertical flip the columns (as always handled by Hyperion)
+	constexpr bool mirrorRows    = (flipMode == FlipMode::HORIZONTAL || flipMode == FlipMode::BOTH);
+	constexpr bool mirrorColumns = (flipMode == FlipMode::VERTICAL   || flipMode == FlipMode::BOTH);
+
+	const int outputWidth = geometry.outputWidth;
+	ColorRgb* const output = outputImage.memptr();
+
+	for (int yDest = 0, ySource = geometry.ySourceStart; yDest < geometry.outputHeight; ++yDest, ySource += geometry.yStep)
+	{
+		const SourceRow<pixelFormat> source(geometry, ySource);
+		ColorRgb* const destRow = output + static_cast<size_t>(mirrorRows ? geometry.outputHeight - 1 - yDest : yDest) * static_cast<size_t>(outputWidth);
+
+		int xSource = geometry.xSourceStart;
+		if constexpr (SourceRow<pixelFormat>::isYuv)
+		{
+			int16_t y[YUV_BATCH_SIZE] {};
+			int16_t u[YUV_BATCH_SIZE] {};
+			int16_t v[YUV_BATCH_SIZE] {};
+			uint8_t r[YUV_BATCH_SIZE];
+			uint8_t g[YUV_BATCH_SIZE];
+			uint8_t b[YUV_BATCH_SIZE];
+
+			for (int xDest = 0; xDest < outputWidth; xDest += YUV_BATCH_SIZE)
+			{
+				const int count = std::min(YUV_BATCH_SIZE, outputWidth - xDest);
+				for (int i = 0; i < count; ++i, xSource += geometry.xStep)
+				{
+					source.yuv(xSource, y[i], u[i], v[i]);
+				}
+
+				yuvToRgb(y, u, v, r, g, b);
+
+				for (int i = 0; i < count; ++i)
+				{
+					ColorRgb& rgb = destRow[mirrorColumns ? outputWidth - 1 - (xDest + i) : xDest + i];
+					rgb.red   = r[i];
+					rgb.green = g[i];
+					rgb.blue  = b[i];
+				}
+			}
+		}
+		else
+		{
+			for (int xDest = 0; xDest < outputWidth; ++xDest, xSource += geometry.xStep)
+			{
+				source.rgb(xSource, destRow[mirrorColumns ? outputWidth - 1 - xDest : xDest]);
+			}
+		}
+	}
+}
+
+template <PixelFormat pixelFormat>
+void resample(FlipMode flipMode, const Geometry& geometry, Image<ColorRgb>& outputImage)
+{
+	switch (flipMode)
+	{
+		case FlipMode::HORIZONTAL:
+			resample<pixelFormat, FlipMode::HORIZONTAL>(geometry, outputImage);
+			break;
+		case FlipMode::VERTICAL:
+			resample<pixelFormat, FlipMode::VERTICAL>(geometry, outputImage);
+			break;
+		case FlipMode::BOTH:
+			resample<pixelFormat, FlipMode::BOTH>(geometry, outputImage);
+			break;
+		case FlipMode::NO_CHANGE:
+		default:
+			resample<pixelFormat, FlipMode::NO_CHANGE>(geometry, outputImage);
+			break;
+	}
+}
+
+} // namespace
+
 ImageResampler::ImageResampler()
 	: _horizontalDecimation(8)
 	, _verticalDecimation(8)
@@ -50,186 +357,46 @@ void ImageResampler::processImage(const uint8_t * data, int width, int height, s
 
 	outputImage.resize(outputWidth, outputHeight);
 
-	int xDestStart {0};
-	int xDestEnd = {outputWidth-1};
-	int yDestStart = {0};
-	int yDestEnd = {outputHeight-1};
-
-	switch (_flipMode)
-	{
-		case FlipMode::NO_CHANGE:
-		//use the initalized values
-			break;
-		case FlipMode::HORIZONTAL:
-			xDestStart = 0;
-			xDestEnd = outputWidth-1;
-			yDestStart = -(outputHeight-1);
-			yDestEnd = 0;
-			break;
-		case FlipMode::VERTICAL:
-			xDestStart = -(outputWidth-1);
-			xDestEnd = 0;
-			yDestStart = 0;
-			yDestEnd = outputHeight-1;
-			break;
-		case FlipMode::BOTH:
-			xDestStart = -(outputWidth-1);
-			xDestEnd = 0;
-			yDestStart = -(outputHeight-1);
-			yDestEnd = 0;
-			break;
-	}
+	const Geometry geometry {
+		data, width, height, lineLength,
+		cropLeft + (_horizontalDecimation >> 1),
+		cropTop + (_verticalDecimation >> 1),
+		_horizontalDecimation,
+		_verticalDecimation,
+		outputWidth,
+		outputHeight
+	};
 
+	// The pixel format and flip mode are resolved once per image, not per pixel
 	switch (pixelFormat)
 	{
 		case PixelFormat::UYVY:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					uint8_t y = data[index+1];
-					uint8_t u = ((xSource&1) == 0) ? data[index  ] : data[index-2];
-					uint8_t v = ((xSource&1) == 0) ? data[index+2] : data[index  ];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-			}
+			resample<PixelFormat::UYVY>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::YUYV:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					uint8_t y = data[index];
-					uint8_t u = ((xSource&1) == 0) ? data[index+1] : data[index-1];
-					uint8_t v = ((xSource&1) == 0) ? data[index+3] : data[index+1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-			}
+			resample<PixelFormat::YUYV>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::BGR16:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1);
-					rgb.blue  = (data[index] & 0x1f) << 3;
-					rgb.green = (((data[index+1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2;
-					rgb.red   = (data[index+1] & 0xF8);
-				}
-			}
+			resample<PixelFormat::BGR16>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::RGB24:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1) + xSource;
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
-			}
+			resample<PixelFormat::RGB24>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::BGR24:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 1) + xSource;
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
-			}
+			resample<PixelFormat::BGR24>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::RGB32:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 2);
-					rgb.red   = data[index  ];
-					rgb.green = data[index+1];
-					rgb.blue  = data[index+2];
-				}
-			}
+			resample<PixelFormat::RGB32>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::BGR32:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					size_t index = lineLength * ySource + (xSource << 2);
-					rgb.blue  = data[index  ];
-					rgb.green = data[index+1];
-					rgb.red   = data[index+2];
-				}
-			}
+			resample<PixelFormat::BGR32>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::NV12:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				size_t uOffset = (height + ySource / 2) * lineLength;
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					uint8_t y = data[lineLength * ySource + xSource];
-					uint8_t u = data[uOffset + ((xSource >> 1) << 1)];
-					uint8_t v = data[uOffset + ((xSource >> 1) << 1) + 1];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-			}
+			resample<PixelFormat::NV12>(_flipMode, geometry, outputImage);
 			break;
-		}
-
 		case PixelFormat::I420:
-		{
-			for (int yDest = yDestStart, ySource = cropTop + (_verticalDecimation >> 1); yDest <= yDestEnd; ySource += _verticalDecimation, ++yDest)
-			{
-				int uOffset = width * height + (ySource/2) * width/2;
-				int vOffset = width * height * 1.25 + (ySource/2) * width/2;
-				for (int xDest = xDestStart, xSource = cropLeft + (_horizontalDecimation >> 1); xDest <= xDestEnd; xSource += _horizontalDecimation, ++xDest)
-				{
-					ColorRgb & rgb = outputImage(abs(xDest), abs(yDest));
-					int y = data[lineLength * ySource + xSource];
-					int u = data[uOffset + (xSource >> 1)];
-					int v = data[vOffset + (xSource >> 1)];
-					ColorSys::yuv2rgb(y, u, v, rgb.red, rgb.green, rgb.blue);
-				}
-			}
+			resample<PixelFormat::I420>(_flipMode, geometry, outputImage);
 			break;
-		}
 		case PixelFormat::MJPEG:
 		break;
 		case PixelFormat::NO_CHANGE:
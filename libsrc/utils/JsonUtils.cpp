@@ -127,10 +127,15 @@ QPair<bool, QStringList> validate(const QString& file, const QJsonValue& json, c
 
 QPair<bool, QStringList> validate(const QString& file, const QJsonValue& json, const QJsonObject& schema, Logger* log)
 {
-	QStringList errorList;
-
 	QJsonSchemaChecker schemaChecker;
 	schemaChecker.setSchema(schema);
+	return validate(file, json, schemaChecker, log);
+}
+
+QPair<bool, QStringList> validate(const QString& file, const QJsonValue& json, QJsonSchemaChecker& schemaChecker, Logger* log)
+{
+	QStringList errorList;
+
 	if (!schemaChecker.validate(json).first)
 	{
 		const QStringList &errors = schemaChecker.getMessages();
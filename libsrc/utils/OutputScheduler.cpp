@@ -0,0 +1,211 @@
+#include <utils/OutputScheduler.h>
+
+// STL includes
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+/// Longest single sleep, so that a stop request is recognized in time even for long periods
+const int64_t MAX_SLEEP_MICROS = 50000;
+
+/// Shortest period accepted from the tick function
+const int64_t MIN_PERIOD_MICROS = 100;
+
+int64_t monotonicMicros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Sleeps till the given absolute time of the monotonic clock
+void sleepUntil(int64_t deadlineMicros)
+{
+#if defined(__linux__)
+	// std::chrono::steady_clock is CLOCK_MONOTONIC on Linux
+	timespec deadline {};
+	deadline.tv_sec = static_cast<time_t>(deadlineMicros / 1000000);
+	deadline.tv_nsec = static_cast<long>((deadlineMicros % 1000000) * 1000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+	{
+	}
+#else
+	std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::microseconds(deadlineMicros)));
+#endif
+}
+
+} // namespace
+
+OutputScheduler::OutputScheduler(const QString& name, std::function<int64_t()> tick, QObject* parent)
+	: QThread(parent)
+	, _log(Logger::getInstance("SCHEDULER", name))
+	, _tick(std::move(tick))
+	, _stopRequested(false)
+	, _realtimePriority(0)
+	, _cpuAffinity(-1)
+	, _ticks(0)
+	, _missedDeadlines(0)
+	, _maxLateness(0)
+{
+	setObjectName(name);
+	resetStatistics();
+}
+
+OutputScheduler::~OutputScheduler()
+{
+	stop();
+}
+
+void OutputScheduler::start(int realtimePriority, int cpuAffinity)
+{
+	if (isRunning())
+	{
+		return;
+	}
+
+	_realtimePriority = realtimePriority;
+	_cpuAffinity = cpuAffinity;
+	_stopRequested = false;
+
+	QThread::start(realtimePriority > 0 ? QThread::TimeCriticalPriority : QThread::InheritPriority);
+}
+
+void OutputScheduler::stop()
+{
+	_stopRequested = true;
+	wait();
+}
+
+void OutputScheduler::run()
+{
+	applySchedulingPolicy();
+
+	int64_t deadline = monotonicMicros();
+	while (!_stopRequested)
+	{
+		const int64_t period = std::max(_tick(), MIN_PERIOD_MICROS);
+		deadline += period;
+
+		// Sleep in slices for long periods to handle stop requests; the final sleep targets the exact deadline
+		int64_t now = monotonicMicros();
+		while (!_stopRequested && deadline - now > MAX_SLEEP_MICROS)
+		{
+			sleepUntil(now + MAX_SLEEP_MICROS);
+			now = monotonicMicros();
+		}
+		if (_stopRequested)
+		{
+			break;
+		}
+		sleepUntil(deadline);
+
+		now = monotonicMicros();
+		const int64_t lateness = now - deadline;
+		recordLateness(lateness);
+
+		// The schedule is restarted instead of catching up with several ticks in a row
+		if (lateness > period)
+		{
+			++_missedDeadlines;
+			deadline = now;
+		}
+	}
+}
+
+void OutputScheduler::applySchedulingPolicy()
+{
+#if defined(__linux__)
+	if (_realtimePriority > 0)
+	{
+		sched_param parameter {};
+		parameter.sched_priority = std::min(_realtimePriority, sched_get_priority_max(SCHED_FIFO));
+		const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameter);
+		if (result != 0)
+		{
+			Warning(_log, "Cannot set real-time priority %d: %s", parameter.sched_priority, strerror(result));
+		}
+		else
+		{
+			Debug(_log, "Running with real-time priority %d", parameter.sched_priority);
+		}
+	}
+
+	if (_cpuAffinity >= 0)
+	{
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(_cpuAffinity, &cpuSet);
+		const int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+		if (result != 0)
+		{
+			Warning(_log, "Cannot bind thread to CPU %d: %s", _cpuAffinity, strerror(result));
+		}
+		else
+		{
+			Debug(_log, "Bound to CPU %d", _cpuAffinity);
+		}
+	}
+#else
+	if (_cpuAffinity >= 0)
+	{
+		Warning(_log, "Binding the thread to a CPU is not supported on this platform");
+	}
+#endif
+}
+
+void OutputScheduler::recordLateness(int64_t lateness)
+{
+	int bucket = 0;
+	if (lateness > 0)
+	{
+		while (bucket < JITTER_BUCKETS - 1 && lateness >= (int64_t(1) << bucket))
+		{
+			++bucket;
+		}
+	}
+	++_jitterHistogram[static_cast<size_t>(bucket)];
+	++_ticks;
+
+	int64_t maxLateness = _maxLateness.load(std::memory_order_relaxed);
+	if (lateness > maxLateness)
+	{
+		_maxLateness.store(lateness, std::memory_order_relaxed);
+	}
+}
+
+OutputScheduler::Statistics OutputScheduler::statistics() const
+{
+	Statistics statistics {};
+	statistics.ticks = _ticks;
+	statistics.missedDeadlines = _missedDeadlines;
+	statistics.maxLateness = _maxLateness;
+	for (size_t i = 0; i < _jitterHistogram.size(); ++i)
+	{
+		statistics.jitterHistogram[i] = _jitterHistogram[i];
+	}
+	return statistics;
+}
+
+void OutputScheduler::resetStatistics()
+{
+	_ticks = 0;
+	_missedDeadlines = 0;
+	_maxLateness = 0;
+	for (std::atomic<uint64_t>& count : _jitterHistogram)
+	{
+		count = 0;
+	}
+}
+
+int64_t OutputScheduler::bucketLimit(int bucket)
+{
+	return (bucket < JITTER_BUCKETS - 1) ? (int64_t(1) << bucket) : -1;
+}
@@ -0,0 +1,429 @@
+#include <utils/PixelSum.h>
+
+// STL includes
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define PIXELSUM_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define PIXELSUM_NEON
+	#include <arm_neon.h>
+#endif
+
+// GCC and Clang require the instruction set to be enabled per function, if not enabled for the whole build
+#if defined(PIXELSUM_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define PIXELSUM_TARGET(isa) __attribute__((target(isa)))
+#else
+	#define PIXELSUM_TARGET(isa)
+#endif
+
+namespace {
+
+using SumFunction = void (*)(const uint8_t*, int, uint64_t*);
+
+// Flush the 32-bit squared sum lanes before they can overflow (6 * 255^2 are added per lane and iteration)
+constexpr int SQUARED_FLUSH_ITERATIONS = 1024;
+
+void sumScalar(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	uint64_t red {0};
+	uint64_t green {0};
+	uint64_t blue {0};
+	for (int i = 0; i < pixelCount; ++i, rgb += 3)
+	{
+		red   += rgb[0];
+		green += rgb[1];
+		blue  += rgb[2];
+	}
+	sums[0] += red;
+	sums[1] += green;
+	sums[2] += blue;
+}
+
+void sumSquaredScalar(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	uint64_t red {0};
+	uint64_t green {0};
+	uint64_t blue {0};
+	for (int i = 0; i < pixelCount; ++i, rgb += 3)
+	{
+		red   += rgb[0] * rgb[0];
+		green += rgb[1] * rgb[1];
+		blue  += rgb[2] * rgb[2];
+	}
+	sums[0] += red;
+	sums[1] += green;
+	sums[2] += blue;
+}
+
+#ifdef PIXELSUM_X86
+
+// Byte (word) lane i of the mask loaded at offset (3 - c) % 3 is set, if i % 3 == c.
+// Loading 16 or 32 bytes of interleaved RGB data, byte i of the q-th load holds channel (q * laneCount + i) % 3.
+alignas(32) const uint8_t CHANNEL_BYTE_PATTERN[36] = {
+	0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0,
+	0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0, 0xFF,0,0
+};
+alignas(32) const uint16_t CHANNEL_WORD_PATTERN[18] = {
+	0xFFFF,0,0, 0xFFFF,0,0, 0xFFFF,0,0, 0xFFFF,0,0, 0xFFFF,0,0, 0xFFFF,0,0
+};
+
+inline int maskIndex(int channel, int laneOffset)
+{
+	return (channel - laneOffset % 3 + 3) % 3;
+}
+
+PIXELSUM_TARGET("sse2")
+void sumSse2(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i mask[3];
+	for (int c = 0; c < 3; ++c)
+	{
+		mask[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(CHANNEL_BYTE_PATTERN + (3 - c) % 3));
+	}
+
+	__m128i acc[3] = { zero, zero, zero };
+	int i = 0;
+	// 16 pixels = 3 x 16 bytes per iteration
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		const __m128i* data = reinterpret_cast<const __m128i*>(rgb + i * 3);
+		for (int q = 0; q < 3; ++q)
+		{
+			const __m128i v = _mm_loadu_si128(data + q);
+			for (int c = 0; c < 3; ++c)
+			{
+				acc[c] = _mm_add_epi64(acc[c], _mm_sad_epu8(_mm_and_si128(v, mask[maskIndex(c, q * 16)]), zero));
+			}
+		}
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		alignas(16) uint64_t lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc[c]);
+		sums[c] += lanes[0] + lanes[1];
+	}
+	sumScalar(rgb + i * 3, pixelCount - i, sums);
+}
+
+PIXELSUM_TARGET("sse2")
+void sumSquaredSse2(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i mask[3];
+	for (int c = 0; c < 3; ++c)
+	{
+		mask[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(CHANNEL_WORD_PATTERN + (3 - c) % 3));
+	}
+
+	int i = 0;
+	while (i + 16 <= pixelCount)
+	{
+		__m128i acc[3] = { zero, zero, zero };
+		// 16 pixels = 6 x 8 bytes per iteration, widened to 16-bit lanes
+		for (int n = 0; n < SQUARED_FLUSH_ITERATIONS && i + 16 <= pixelCount; ++n, i += 16)
+		{
+			const __m128i* data = reinterpret_cast<const __m128i*>(rgb + i * 3);
+			for (int q = 0; q < 3; ++q)
+			{
+				const __m128i v = _mm_loadu_si128(data + q);
+				const __m128i words[2] = { _mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero) };
+				for (int h = 0; h < 2; ++h)
+				{
+					for (int c = 0; c < 3; ++c)
+					{
+						const __m128i masked = _mm_and_si128(words[h], mask[maskIndex(c, (q * 2 + h) * 8)]);
+						acc[c] = _mm_add_epi32(acc[c], _mm_madd_epi16(masked, words[h]));
+					}
+				}
+			}
+		}
+
+		for (int c = 0; c < 3; ++c)
+		{
+			alignas(16) uint32_t lanes[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc[c]);
+			sums[c] += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+		}
+	}
+	sumSquaredScalar(rgb + i * 3, pixelCount - i, sums);
+}
+
+PIXELSUM_TARGET("avx2")
+void sumAvx2(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i mask[3];
+	for (int c = 0; c < 3; ++c)
+	{
+		mask[c] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(CHANNEL_BYTE_PATTERN + (3 - c) % 3));
+	}
+
+	__m256i acc[3] = { zero, zero, zero };
+	int i = 0;
+	// 32 pixels = 3 x 32 bytes per iteration
+	for (; i + 32 <= pixelCount; i += 32)
+	{
+		const __m256i* data = reinterpret_cast<const __m256i*>(rgb + i * 3);
+		for (int q = 0; q < 3; ++q)
+		{
+			const __m256i v = _mm256_loadu_si256(data + q);
+			for (int c = 0; c < 3; ++c)
+			{
+				acc[c] = _mm256_add_epi64(acc[c], _mm256_sad_epu8(_mm256_and_si256(v, mask[maskIndex(c, q * 32)]), zero));
+			}
+		}
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		alignas(32) uint64_t lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc[c]);
+		sums[c] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	}
+	sumSse2(rgb + i * 3, pixelCount - i, sums);
+}
+
+PIXELSUM_TARGET("avx2")
+void sumSquaredAvx2(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i mask[3];
+	for (int c = 0; c < 3; ++c)
+	{
+		mask[c] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(CHANNEL_WORD_PATTERN + (3 - c) % 3));
+	}
+
+	int i = 0;
+	while (i + 32 <= pixelCount)
+	{
+		__m256i acc[3] = { zero, zero, zero };
+		// 32 pixels = 6 x 16 bytes per iteration, widened to 16-bit lanes
+		for (int n = 0; n < SQUARED_FLUSH_ITERATIONS && i + 32 <= pixelCount; ++n, i += 32)
+		{
+			const __m128i* data = reinterpret_cast<const __m128i*>(rgb + i * 3);
+			for (int q = 0; q < 6; ++q)
+			{
+				const __m256i words = _mm256_cvtepu8_epi16(_mm_loadu_si128(data + q));
+				for (int c = 0; c < 3; ++c)
+				{
+					const __m256i masked = _mm256_and_si256(words, mask[maskIndex(c, q * 16)]);
+					acc[c] = _mm256_add_epi32(acc[c], _mm256_madd_epi16(masked, words));
+				}
+			}
+		}
+
+		for (int c = 0; c < 3; ++c)
+		{
+			alignas(32) uint32_t lanes[8];
+			_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc[c]);
+			uint64_t total {0};
+			for (const uint32_t lane : lanes)
+			{
+				total += lane;
+			}
+			sums[c] += total;
+		}
+	}
+	sumSquaredSse2(rgb + i * 3, pixelCount - i, sums);
+}
+
+bool cpuSupports(PixelSum::Kernel kernel)
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	if (kernel == PixelSum::Kernel::Sse2)
+	{
+		__cpuid(info, 1);
+		return (info[3] & (1 << 26)) != 0;
+	}
+	if (kernel == PixelSum::Kernel::Avx2 && maxLeaf >= 7)
+	{
+		// AVX2 additionally requires the OS to save the YMM registers (OSXSAVE + XCR0)
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}
+	return false;
+#else
+	__builtin_cpu_init();
+	switch (kernel)
+	{
+	case PixelSum::Kernel::Sse2:
+		return __builtin_cpu_supports("sse2") != 0;
+	case PixelSum::Kernel::Avx2:
+		return __builtin_cpu_supports("avx2") != 0;
+	default:
+		return false;
+	}
+#endif
+}
+
+#endif // PIXELSUM_X86
+
+#ifdef PIXELSUM_NEON
+
+void sumNeon(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	uint64x2_t acc[3] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+	int i = 0;
+	// 16 pixels per iteration, de-interleaved into one register per channel
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		const uint8x16x3_t v = vld3q_u8(rgb + i * 3);
+		for (int c = 0; c < 3; ++c)
+		{
+			acc[c] = vpadalq_u32(acc[c], vpaddlq_u16(vpaddlq_u8(v.val[c])));
+		}
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		sums[c] += vgetq_lane_u64(acc[c], 0) + vgetq_lane_u64(acc[c], 1);
+	}
+	sumScalar(rgb + i * 3, pixelCount - i, sums);
+}
+
+void sumSquaredNeon(const uint8_t* rgb, int pixelCount, uint64_t* sums)
+{
+	uint64x2_t acc[3] = { vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0) };
+	int i = 0;
+	for (; i + 16 <= pixelCount; i += 16)
+	{
+		const uint8x16x3_t v = vld3q_u8(rgb + i * 3);
+		for (int c = 0; c < 3; ++c)
+		{
+			const uint8x8_t low = vget_low_u8(v.val[c]);
+			const uint8x8_t high = vget_high_u8(v.val[c]);
+			uint32x4_t squares = vpaddlq_u16(vmull_u8(low, low));
+			squares = vpadalq_u16(squares, vmull_u8(high, high));
+			acc[c] = vpadalq_u32(acc[c], squares);
+		}
+	}
+
+	for (int c = 0; c < 3; ++c)
+	{
+		sums[c] += vgetq_lane_u64(acc[c], 0) + vgetq_lane_u64(acc[c], 1);
+	}
+	sumSquaredScalar(rgb + i * 3, pixelCount - i, sums);
+}
+
+#endif // PIXELSUM_NEON
+
+struct Kernels
+{
+	PixelSum::Kernel kernel;
+	SumFunction sum;
+	SumFunction sumSquared;
+};
+
+Kernels kernelsFor(PixelSum::Kernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef PIXELSUM_X86
+	case PixelSum::Kernel::Avx2:
+		return { kernel, sumAvx2, sumSquaredAvx2 };
+	case PixelSum::Kernel::Sse2:
+		return { kernel, sumSse2, sumSquaredSse2 };
+#endif
+#ifdef PIXELSUM_NEON
+	case PixelSum::Kernel::Neon:
+		return { kernel, sumNeon, sumSquaredNeon };
+#endif
+	default:
+		return { PixelSum::Kernel::Scalar, sumScalar, sumSquaredScalar };
+	}
+}
+
+Kernels& activeKernels()
+{
+	static Kernels kernels = [] {
+		for (const PixelSum::Kernel kernel : { PixelSum::Kernel::Avx2, PixelSum::Kernel::Sse2, PixelSum::Kernel::Neon })
+		{
+			if (PixelSum::isSupported(kernel))
+			{
+				return kernelsFor(kernel);
+			}
+		}
+		return kernelsFor(PixelSum::Kernel::Scalar);
+	}();
+	return kernels;
+}
+
+} // namespace
+
+PixelSum::Kernel PixelSum::kernel()
+{
+	return activeKernels().kernel;
+}
+
+const char* PixelSum::kernelName(Kernel kernel)
+{
+	switch (kernel)
+	{
+	case Kernel::Sse2:
+		return "SSE2";
+	case Kernel::Avx2:
+		return "AVX2";
+	case Kernel::Neon:
+		return "NEON";
+	default:
+		return "Scalar";
+	}
+}
+
+bool PixelSum::isSupported(Kernel kernel)
+{
+	switch (kernel)
+	{
+	case Kernel::Scalar:
+		return true;
+#ifdef PIXELSUM_X86
+	case Kernel::Sse2:
+	case Kernel::Avx2:
+		return cpuSupports(kernel);
+#endif
+#ifdef PIXELSUM_NEON
+	case Kernel::Neon:
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+bool PixelSum::setKernel(Kernel kernel)
+{
+	if (!isSupported(kernel))
+	{
+		return false;
+	}
+	activeKernels() = kernelsFor(kernel);
+	return true;
+}
+
+void PixelSum::sumRgb(const uint8_t* rgb, int pixelCount, uint64_t sums[3])
+{
+	activeKernels().sum(rgb, pixelCount, sums);
+}
+
+void PixelSum::sumRgbSquared(const uint8_t* rgb, int pixelCount, uint64_t sums[3])
+{
+	activeKernels().sumSquared(rgb, pixelCount, sums);
+}
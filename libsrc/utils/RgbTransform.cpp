@@ -107,6 +107,11 @@ void RgbTransform::setBackLightEnabled(bool enable)
 	_backLightEnabled = enable;
 }
 
+int RgbTransform::getBacklightSumThreshold() const
+{
+	return (_backLightEnabled && _sumBrightnessLow > 0) ? static_cast<int>(qCeil(_sumBrightnessLow)) : 0;
+}
+
 uint8_t RgbTransform::getBrightness() const
 {
 	return _brightness;
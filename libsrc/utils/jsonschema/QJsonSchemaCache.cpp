@@ -0,0 +1,51 @@
+// stdlib includes
+#include <memory>
+
+// Utils-Jsonschema includes
+#include <utils/jsonschema/QJsonSchemaCache.h>
+#include <utils/jsonschema/QJsonFactory.h>
+
+// Qt includes
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+QMutex schemaMutex;
+QHash<QString, QJsonObject> schemas;
+
+} // namespace
+
+QJsonObject QJsonSchemaCache::getSchema(const QString& path)
+{
+	{
+		QMutexLocker locker(&schemaMutex);
+		QHash<QString, QJsonObject>::const_iterator it = schemas.constFind(path);
+		if (it != schemas.constEnd())
+		{
+			return it.value();
+		}
+	}
+
+	// Read outside of the lock, a concurrent first read of the same schema just yields an equal result
+	const QJsonObject schema = QJsonFactory::readSchema(path);
+
+	QMutexLocker locker(&schemaMutex);
+	schemas.insert(path, schema);
+	return schema;
+}
+
+QJsonSchemaChecker& QJsonSchemaCache::getChecker(const QString& path)
+{
+	static thread_local QHash<QString, std::shared_ptr<QJsonSchemaChecker>> checkers;
+
+	std::shared_ptr<QJsonSchemaChecker>& checker = checkers[path];
+	if (checker == nullptr)
+	{
+		std::shared_ptr<QJsonSchemaChecker> newChecker = std::make_shared<QJsonSchemaChecker>();
+		newChecker->setSchema(getSchema(path));
+		checker = newChecker;
+	}
+	return *checker;
+}
@@ -79,16 +79,18 @@ QJsonValue QJsonSchemaChecker::getAutoCorrectedConfig(const QJsonValue& value, b
 
 void QJsonSchemaChecker::validate(const QJsonValue& value, const QJsonObject& schema)
 {
+	// the default value applies to all checks of the current json value
+	QJsonObject::const_iterator defaultIt = schema.find("default");
+	const QJsonValue defaultValue = (defaultIt != schema.end()) ? *defaultIt : QJsonValue(QJsonValue::Null);
+
 	// check the current json value
 	for (QJsonObject::const_iterator i = schema.begin(); i != schema.end(); ++i)
 	{
 		QString attribute = i.key();
 		const QJsonValue& attributeValue = *i;
 
-		QJsonObject::const_iterator defaultValue = schema.find("default");
-
 		if (attribute == "type")
-			checkType(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkType(value, attributeValue, defaultValue);
 		else if (attribute == "properties")
 		{
 			if (value.isObject())
@@ -132,13 +134,13 @@ void QJsonSchemaChecker::validate(const QJsonValue& value, const QJsonObject& sc
 			}
 		}
 		else if (attribute == "minimum")
-			checkMinimum(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMinimum(value, attributeValue, defaultValue);
 		else if (attribute == "maximum")
-			checkMaximum(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMaximum(value, attributeValue, defaultValue);
 		else if (attribute == "minLength")
-			checkMinLength(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMinLength(value, attributeValue, defaultValue);
 		else if (attribute == "maxLength")
-			checkMaxLength(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMaxLength(value, attributeValue, defaultValue);
 		else if (attribute == "items")
 		{
 			if (value.isArray())
@@ -151,13 +153,13 @@ void QJsonSchemaChecker::validate(const QJsonValue& value, const QJsonObject& sc
 			}
 		}
 		else if (attribute == "minItems")
-			checkMinItems(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMinItems(value, attributeValue, defaultValue);
 		else if (attribute == "maxItems")
-			checkMaxItems(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkMaxItems(value, attributeValue, defaultValue);
 		else if (attribute == "uniqueItems")
 			checkUniqueItems(value, attributeValue);
 		else if (attribute == "enum")
-			checkEnum(value, attributeValue, (defaultValue != schema.end() ? *defaultValue : QJsonValue(QJsonValue::Null)));
+			checkEnum(value, attributeValue, defaultValue);
 		else if (attribute == "required")
 			; // nothing to do. value is present so always oke
 		else if (attribute == "id")
@@ -316,7 +316,7 @@ void QtHttpClientWrapper::onReplySendHeadersRequested (void)
 			static const QByteArray & CHUNKED = QByteArrayLiteral ("chunked");
 			reply->addHeader (QtHttpHeader::TransferEncoding, CHUNKED);
 		}
-		else
+		else if (reply->getStatusCode () != QtHttpReply::NotModified) // a 304 has no body, its length would refer to the unsent one
 		{
 			reply->addHeader (QtHttpHeader::ContentLength, QByteArray::number (reply->getRawDataSize ()));
 		}
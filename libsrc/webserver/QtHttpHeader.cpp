@@ -34,6 +34,9 @@ const QByteArray & QtHttpHeader::AccessControlAllowOrigin  = QByteArrayLiteral (
 const QByteArray & QtHttpHeader::AccessControlAllowMethods = QByteArrayLiteral ("Access-Control-Allow-Methods");
 const QByteArray & QtHttpHeader::AccessControlAllowHeaders = QByteArrayLiteral ("Access-Control-Allow-Headers");
 const QByteArray & QtHttpHeader::AccessControlMaxAge       = QByteArrayLiteral ("Access-Control-Max-Age");
+const QByteArray & QtHttpHeader::ETag                      = QByteArrayLiteral ("ETag");
+const QByteArray & QtHttpHeader::IfNoneMatch               = QByteArrayLiteral ("If-None-Match");
+const QByteArray & QtHttpHeader::Vary                      = QByteArrayLiteral ("Vary");
 const QByteArray & QtHttpHeader::Upgrade                   = QByteArrayLiteral ("Upgrade");
 const QByteArray & QtHttpHeader::SecWebSocketKey           = QByteArrayLiteral ("Sec-WebSocket-Key");
 const QByteArray & QtHttpHeader::SecWebSocketProtocol      = QByteArrayLiteral ("Sec-WebSocket-Protocol");
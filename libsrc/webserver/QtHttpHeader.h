@@ -37,6 +37,9 @@ public:
 	static const QByteArray & AccessControlAllowMethods;
 	static const QByteArray & AccessControlAllowHeaders;
 	static const QByteArray & AccessControlMaxAge;
+	static const QByteArray & ETag;
+	static const QByteArray & IfNoneMatch;
+	static const QByteArray & Vary;
 	// Websocket specific headers
 	static const QByteArray & Upgrade;
 	static const QByteArray & SecWebSocketKey;
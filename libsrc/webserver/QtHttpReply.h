@@ -21,6 +21,7 @@ public:
 		Ok                 = 200,
 		NoContent          = 204,
 		SeeOther           = 303,
+		NotModified        = 304,
 		BadRequest         = 400,
 		Forbidden          = 403,
 		NotFound           = 404,
@@ -0,0 +1,239 @@
+#include "StaticFileCache.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QMimeType>
+#include <QStringBuilder>
+
+#include <array>
+
+namespace {
+
+/// Smallest file worth compressing
+const int MIN_COMPRESS_SIZE = 256;
+
+/// MIME types which are not compressed already
+bool isCompressible(const QMimeType& mime)
+{
+	return mime.inherits(QStringLiteral("text/plain"))
+		|| mime.name() == QStringLiteral("application/javascript")
+		|| mime.name() == QStringLiteral("application/json")
+		|| mime.name() == QStringLiteral("application/xml")
+		|| mime.name() == QStringLiteral("image/svg+xml")
+		|| mime.name() == QStringLiteral("image/x-icon")
+		|| mime.name() == QStringLiteral("image/vnd.microsoft.icon")
+		|| mime.name() == QStringLiteral("font/ttf")
+		|| mime.name() == QStringLiteral("application/x-font-ttf")
+		|| mime.name() == QStringLiteral("application/vnd.ms-fontobject");
+}
+
+quint32 crc32(const QByteArray& data)
+{
+	static const std::array<quint32, 256> table = []() {
+		std::array<quint32, 256> crcTable {};
+		for (quint32 i = 0; i < 256; ++i)
+		{
+			quint32 crc = i;
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				crc = (crc & 1U) ? (0xEDB88320U ^ (crc >> 1)) : (crc >> 1);
+			}
+			crcTable[i] = crc;
+		}
+		return crcTable;
+	}();
+
+	quint32 crc = 0xFFFFFFFFU;
+	for (const char byte : data)
+	{
+		crc = table[(crc ^ static_cast<quint8>(byte)) & 0xFFU] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFU;
+}
+
+void appendLittleEndian(QByteArray& data, quint32 value)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		data.append(static_cast<char>((value >> (8 * i)) & 0xFFU));
+	}
+}
+
+QByteArray strongETag(const QByteArray& data, const char* suffix = "")
+{
+	return '"' + QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex() + suffix + '"';
+}
+
+} // namespace
+
+StaticFileCache::StaticFileCache()
+	: _isResource(false)
+	, _cachedBytes(0)
+{
+}
+
+void StaticFileCache::setBaseUrl(const QString& url)
+{
+	if (url != _baseUrl)
+	{
+		clear();
+		_baseUrl = url;
+		// Files compiled into the binary cannot change while running
+		_isResource = url.startsWith(':');
+	}
+}
+
+StaticFileCache::EntryPtr StaticFileCache::find(const QString& key)
+{
+	const EntryPtr entry = _entries.value(key);
+	if (entry.isNull())
+	{
+		return entry;
+	}
+
+	if (!_isResource)
+	{
+		const QFileInfo info(_baseUrl % "/" % entry->fileName);
+		if (!info.exists() || info.size() != entry->size || info.lastModified() != entry->lastModified)
+		{
+			remove(entry);
+			return {};
+		}
+	}
+
+	return entry;
+}
+
+StaticFileCache::EntryPtr StaticFileCache::load(const QString& key, const QString& fileName, Status& status)
+{
+	QFile file(_baseUrl % "/" % fileName);
+	if (!file.exists())
+	{
+		status = Status::NotFound;
+		return {};
+	}
+
+	// Another request path may have loaded the same file already
+	EntryPtr cached = _files.value(fileName);
+	if (!cached.isNull() && (_isResource || (file.size() == cached->size && QFileInfo(file).lastModified() == cached->lastModified)))
+	{
+		if (_entries.size() < MAX_KEYS)
+		{
+			_entries.insert(key, cached);
+		}
+		status = Status::Found;
+		return cached;
+	}
+	if (!cached.isNull())
+	{
+		remove(cached);
+	}
+
+	if (!file.open(QFile::ReadOnly))
+	{
+		status = Status::Forbidden;
+		return {};
+	}
+
+	QSharedPointer<Entry> entry(new Entry());
+	entry->fileName = fileName;
+	entry->lastModified = QFileInfo(file).lastModified();
+	entry->data = file.readAll();
+	entry->size = entry->data.size();
+	file.close();
+
+	const QMimeType mime = _mimeDb.mimeTypeForFile(file.fileName());
+	// Workaround https://bugreports.qt.io/browse/QTBUG-97392
+	if (mime.name() == QStringLiteral("application/x-extension-html"))
+	{
+		entry->mimeType = QByteArrayLiteral("text/html");
+	}
+	else
+	{
+		entry->mimeType = mime.name().toLocal8Bit();
+	}
+
+	status = Status::Found;
+	entry->etag = strongETag(entry->data);
+
+	// Files too large for the cache are served as they are, without compressing them on every request
+	if (entry->size > MAX_FILE_SIZE)
+	{
+		return entry;
+	}
+
+	if (entry->size >= MIN_COMPRESS_SIZE && (isCompressible(mime) || entry->mimeType == "text/html"))
+	{
+		QByteArray gzipData = gzipCompress(entry->data);
+		// Only worth it, if it saves at least a tenth
+		if (!gzipData.isEmpty() && gzipData.size() < entry->data.size() - entry->data.size() / 10)
+		{
+			entry->gzipData = gzipData;
+			entry->gzipEtag = strongETag(entry->data, "-gzip");
+		}
+	}
+
+	const qint64 entrySize = entry->data.size() + entry->gzipData.size();
+	if (_cachedBytes + entrySize <= MAX_CACHE_SIZE && _entries.size() < MAX_KEYS)
+	{
+		_entries.insert(key, entry);
+		_files.insert(fileName, entry);
+		_cachedBytes += entrySize;
+	}
+
+	return entry;
+}
+
+QByteArray StaticFileCache::gzipCompress(const QByteArray& data)
+{
+	// qCompress creates a zlib stream (RFC 1950) prefixed by the uncompressed size as 32-bit big endian value:
+	// [4 bytes size][2 bytes zlib header][deflate data][4 bytes Adler-32]. The deflate data is reused for gzip.
+	const QByteArray zlibData = qCompress(data, 9);
+	if (zlibData.size() < 10)
+	{
+		return {};
+	}
+
+	QByteArray gzipData;
+	gzipData.reserve(zlibData.size() + 8);
+
+	// Header: magic number, deflate method, no flags, no modification time, maximum compression, unknown OS
+	static const char header[] = { '\x1f', '\x8b', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x02', '\xff' };
+	gzipData.append(header, sizeof(header));
+	gzipData.append(zlibData.constData() + 6, zlibData.size() - 10);
+
+	// Trailer: CRC-32 and size of the uncompressed data
+	appendLittleEndian(gzipData, crc32(data));
+	appendLittleEndian(gzipData, static_cast<quint32>(data.size()));
+
+	return gzipData;
+}
+
+void StaticFileCache::clear()
+{
+	_entries.clear();
+	_files.clear();
+	_cachedBytes = 0;
+}
+
+void StaticFileCache::remove(const EntryPtr& entry)
+{
+	for (auto it = _entries.begin(); it != _entries.end();)
+	{
+		if (it.value() == entry)
+		{
+			it = _entries.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	if (_files.value(entry->fileName) == entry)
+	{
+		_files.remove(entry->fileName);
+		_cachedBytes -= entry->data.size() + entry->gzipData.size();
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMimeDatabase>
+#include <QSharedPointer>
+#include <QString>
+
+///
+/// In-memory cache of the static files served by the webserver.
+///
+/// A file is read on its first request and kept with its MIME type, a strong ETag and, for compressible types,
+/// a gzip compressed body. Further requests are answered from memory without file access, MIME lookup or
+/// compression. Files of the built-in web configuration (qrc) never change; files of a custom document root are
+/// checked for modification on every request and reloaded when changed.
+///
+class StaticFileCache
+{
+public:
+	/// Largest file kept in the cache, larger files are served but not cached
+	static constexpr qint64 MAX_FILE_SIZE = 8 * 1024 * 1024;
+	/// Upper limit of the memory used by the cached bodies
+	static constexpr qint64 MAX_CACHE_SIZE = 64 * 1024 * 1024;
+	/// Upper limit of request paths kept, as different paths may refer to the same file
+	static constexpr int MAX_KEYS = 4096;
+
+	struct Entry
+	{
+		/// Path of the file, relative to the document root
+		QString fileName;
+		QByteArray mimeType;
+		/// The file's content
+		QByteArray data;
+		/// The gzip compressed content, empty if not compressible
+		QByteArray gzipData;
+		/// Strong ETags (quoted) of the plain and the compressed content
+		QByteArray etag;
+		QByteArray gzipEtag;
+		/// Validators of files on disk
+		QDateTime lastModified;
+		qint64 size = 0;
+	};
+	typedef QSharedPointer<const Entry> EntryPtr;
+
+	enum class Status
+	{
+		Found,
+		NotFound,
+		Forbidden
+	};
+
+	StaticFileCache();
+
+	///
+	/// @brief Sets the document root, clears the cache if changed
+	///
+	void setBaseUrl(const QString& url);
+
+	///
+	/// @brief Returns the cached entry of a request path, if still valid
+	/// @param[in] key The request path
+	/// @return The entry, null if not cached
+	///
+	EntryPtr find(const QString& key);
+
+	///
+	/// @brief Reads a file and caches it for the given request path
+	/// @param[in] key The request path
+	/// @param[in] fileName The file's path, relative to the document root
+	/// @param[out] status Found, or the reason why the file is not available
+	/// @return The entry, null if the file is not available
+	///
+	EntryPtr load(const QString& key, const QString& fileName, Status& status);
+
+	///
+	/// @brief Compresses data in gzip format (RFC 1952)
+	/// @param[in] data The data to compress
+	/// @return The gzip stream, empty on error
+	///
+	static QByteArray gzipCompress(const QByteArray& data);
+
+private:
+	void clear();
+
+	/// Removes a file whose content changed on disk
+	void remove(const EntryPtr& entry);
+
+	QString _baseUrl;
+	bool _isResource;
+	QMimeDatabase _mimeDb;
+	/// Entries by request path
+	QHash<QString, EntryPtr> _entries;
+	/// Entries by file, shared by the request paths referring to the same file
+	QHash<QString, EntryPtr> _files;
+
+	/// Memory used by the cached bodies
+	qint64 _cachedBytes;
+};
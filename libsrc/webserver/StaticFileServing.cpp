@@ -8,7 +8,6 @@
 #include <QUrlQuery>
 #include <QList>
 #include <QPair>
-#include <QFile>
 #include <QFileInfo>
 #include <QResource>
 
@@ -17,22 +16,21 @@
 StaticFileServing::StaticFileServing (QObject * parent)
 	:  QObject   (parent)
 	, _baseUrl ()
+	, _fileCache()
 	, _cgi(this)
 	, _log(Logger::getInstance("WEBSERVER"))
 {
 	Q_INIT_RESOURCE(WebConfig);
-
-	_mimeDb = new QMimeDatabase;
 }
 
 StaticFileServing::~StaticFileServing ()
 {
-	delete _mimeDb;
 }
 
 void StaticFileServing::setBaseUrl(const QString& url)
 {
 	_baseUrl = url;
+	_fileCache.setBaseUrl(url);
 	_cgi.setBaseUrl(url);
 }
 
@@ -51,34 +49,131 @@ void StaticFileServing::printErrorToReply (QtHttpReply * reply, QtHttpReply::Sta
 {
 	reply->setStatusCode(code);
 	reply->addHeader ("Content-Type", QByteArrayLiteral ("text/html"));
-	QFile errorPageHeader(_baseUrl %  "/errorpages/header.html" );
-	QFile errorPageFooter(_baseUrl %  "/errorpages/footer.html" );
-	QFile errorPage      (_baseUrl %  "/errorpages/" % QString::number((int)code) % ".html" );
 
-	if (errorPageHeader.open (QFile::ReadOnly))
+	StaticFileCache::Status status;
+	QString fileName;
+	const StaticFileCache::EntryPtr errorPageHeader = getFile("/errorpages/header.html", status, fileName);
+	const StaticFileCache::EntryPtr errorPageFooter = getFile("/errorpages/footer.html", status, fileName);
+	const StaticFileCache::EntryPtr errorPage       = getFile("/errorpages/" % QString::number((int)code) % ".html", status, fileName);
+
+	if (!errorPageHeader.isNull())
 	{
-		QByteArray data = errorPageHeader.readAll();
-		reply->appendRawData (data);
-		errorPageHeader.close ();
+		reply->appendRawData (errorPageHeader->data);
 	}
 
-	if (errorPage.open (QFile::ReadOnly))
+	if (!errorPage.isNull())
 	{
-		QByteArray data = errorPage.readAll();
+		QByteArray data = errorPage->data;
 		data = data.replace("{MESSAGE}", QString(errorMessage.toLocal8Bit()).toHtmlEscaped().toLocal8Bit() );
 		reply->appendRawData (data);
-		errorPage.close ();
 	}
 	else
 	{
 		reply->appendRawData (QString(QString::number(code) + " - " +errorMessage.toLocal8Bit()).toHtmlEscaped().toLocal8Bit());
 	}
 
-	if (errorPageFooter.open (QFile::ReadOnly))
+	if (!errorPageFooter.isNull())
 	{
-		QByteArray data = errorPageFooter.readAll ();
-		reply->appendRawData (data);
-		errorPageFooter.close ();
+		reply->appendRawData (errorPageFooter->data);
+	}
+}
+
+StaticFileCache::EntryPtr StaticFileServing::getFile (const QString& path, StaticFileCache::Status& status, QString& fileName)
+{
+	fileName = path;
+	StaticFileCache::EntryPtr file = _fileCache.find(path);
+	if (!file.isNull())
+	{
+		status = StaticFileCache::Status::Found;
+		return file;
+	}
+
+	QFileInfo info(_baseUrl % "/" % path);
+	if ( path == "/" || path.isEmpty()  )
+	{
+		fileName = "index.html";
+	}
+	else if (info.isDir() && path.endsWith("/") )
+	{
+		fileName += "index.html";
+	}
+	else if (info.isDir() && ! path.endsWith("/") )
+	{
+		fileName += "/index.html";
+	}
+
+	return _fileCache.load(path, fileName, status);
+}
+
+void StaticFileServing::replyFile (QtHttpRequest * request, QtHttpReply * reply, const StaticFileCache::Entry& file)
+{
+	bool acceptsGzip = false;
+	const QList<QByteArray> encodings = request->getHeader(QtHttpHeader::AcceptEncoding).split(',');
+	for (const QByteArray& encoding : encodings)
+	{
+		// e.g. "gzip", "gzip;q=0.8" or "gzip;q=0" (not acceptable)
+		const QList<QByteArray> parameters = encoding.split(';');
+		const QByteArray coding = parameters.first().trimmed().toLower();
+		if (coding == "gzip" || coding == "x-gzip" || coding == "*")
+		{
+			bool isAcceptable = true;
+			for (int i = 1; i < parameters.size(); ++i)
+			{
+				const QByteArray parameter = parameters.at(i).trimmed();
+				if (parameter.startsWith("q="))
+				{
+					isAcceptable = parameter.mid(2).toDouble() > 0.0;
+				}
+			}
+			// An explicit "gzip" overrides the wildcard
+			acceptsGzip = (coding == "*") ? (acceptsGzip || isAcceptable) : isAcceptable;
+			if (coding != "*")
+			{
+				break;
+			}
+		}
+	}
+
+	const bool isGzip = acceptsGzip && !file.gzipData.isEmpty();
+	// The ETag of the representation selected, the plain and the gzip encoded file differ
+	const QByteArray& selectedEtag = isGzip ? file.gzipEtag : file.etag;
+	reply->addHeader (QtHttpHeader::ContentType, file.mimeType);
+	reply->addHeader (QtHttpHeader::ETag, selectedEtag);
+	// The client may keep a copy, but has to revalidate it by its ETag, as the files change with updates
+	reply->addHeader (QtHttpHeader::CacheControl, QByteArrayLiteral ("no-cache"));
+	if (!file.gzipData.isEmpty())
+	{
+		reply->addHeader (QtHttpHeader::Vary, QtHttpHeader::AcceptEncoding);
+	}
+
+	const QByteArray ifNoneMatch = request->getHeader(QtHttpHeader::IfNoneMatch);
+	if (!ifNoneMatch.isEmpty())
+	{
+		const QList<QByteArray> etags = ifNoneMatch.split(',');
+		for (const QByteArray& entry : etags)
+		{
+			// Weak comparison, as specified for If-None-Match
+			QByteArray etag = entry.trimmed();
+			if (etag.startsWith("W/"))
+			{
+				etag = etag.mid(2);
+			}
+			if (etag == "*" || etag == selectedEtag)
+			{
+				reply->setStatusCode (QtHttpReply::NotModified);
+				return;
+			}
+		}
+	}
+
+	if (isGzip)
+	{
+		reply->addHeader (QtHttpHeader::ContentEncoding, QByteArrayLiteral ("gzip"));
+		reply->appendRawData (file.gzipData);
+	}
+	else
+	{
+		reply->appendRawData (file.data);
 	}
 }
 
@@ -115,48 +210,21 @@ void StaticFileServing::onRequestNeedsReply (QtHttpRequest * request, QtHttpRepl
 			}
 		}
 
-		QFileInfo info(_baseUrl % "/" % path);
-		if ( path == "/" || path.isEmpty()  )
-		{
-			path = "index.html";
-		}
-		else if (info.isDir() && path.endsWith("/") )
+		// get static files, from memory after the first request
+		StaticFileCache::Status status;
+		QString fileName;
+		const StaticFileCache::EntryPtr file = getFile(path, status, fileName);
+		if (status == StaticFileCache::Status::Found)
 		{
-			path += "index.html";
+			replyFile (request, reply, *file);
 		}
-		else if (info.isDir() && ! path.endsWith("/") )
+		else if (status == StaticFileCache::Status::Forbidden)
 		{
-			path += "/index.html";
-		}
-
-		// get static files
-		QFile file(_baseUrl % "/" % path);
-		if (file.exists())
-		{
-			QMimeType mime = _mimeDb->mimeTypeForFile (file.fileName ());
-			if (file.open (QFile::ReadOnly)) {
-				QByteArray data = file.readAll ();
-
-				// Workaround https://bugreports.qt.io/browse/QTBUG-97392
-				if (mime.name() == QStringLiteral("application/x-extension-html"))
-				{
-					reply->addHeader ("Content-Type", "text/html");
-				}
-				else
-				{
-					reply->addHeader ("Content-Type", mime.name().toLocal8Bit());
-				}
-				reply->appendRawData (data);
-				file.close ();
-			}
-			else
-			{
-				printErrorToReply (reply, QtHttpReply::Forbidden ,"Requested file: " % path);
-			}
+			printErrorToReply (reply, QtHttpReply::Forbidden ,"Requested file: " % fileName);
 		}
 		else
 		{
-			printErrorToReply (reply, QtHttpReply::NotFound, "Requested file: " % path);
+			printErrorToReply (reply, QtHttpReply::NotFound, "Requested file: " % fileName);
 		}
 	}
 	else
@@ -1,11 +1,10 @@
 #ifndef STATICFILESERVING_H
 #define STATICFILESERVING_H
 
-#include <QMimeDatabase>
-
 #include "QtHttpRequest.h"
 #include "QtHttpReply.h"
 #include "CgiHandler.h"
+#include "StaticFileCache.h"
 
 #include <utils/Logger.h>
 
@@ -32,13 +31,27 @@ public slots:
 
 private:
 	QString         _baseUrl;
-	QMimeDatabase * _mimeDb;
+	StaticFileCache _fileCache;
 	CgiHandler      _cgi;
 	Logger        * _log;
 	QByteArray      _ssdpDescription;
 
 	void printErrorToReply (QtHttpReply * reply, QtHttpReply::StatusCode code, const QString& errorMessage);
 
+	///
+	/// @brief Get a file from the cache, reading it on first access
+	/// @param path The request path, directories refer to their index.html
+	/// @param[out] status Found, or the reason why the file is not available
+	/// @param[out] fileName The path of the file served
+	/// @return The file, null if not available
+	///
+	StaticFileCache::EntryPtr getFile (const QString& path, StaticFileCache::Status& status, QString& fileName);
+
+	///
+	/// @brief Reply a file, gzip compressed if accepted by the client, or 304 if the client's copy is still valid
+	///
+	void replyFile (QtHttpRequest * request, QtHttpReply * reply, const StaticFileCache::Entry& file);
+
 };
 
 #endif // STATICFILESERVING_H
@@ -29,6 +29,10 @@ WebSocketJsonHandler::WebSocketJsonHandler(QWebSocket* websocket, QObject* paren
 	connect(_jsonAPI.get(), &JsonAPI::callbackReady, this, &WebSocketJsonHandler::sendMessage);
 	connect(_jsonAPI->getCallBack().get(), &JsonCallbacks::callbackReady, this, &WebSocketJsonHandler::sendMessage);
 
+	// LED colors and images may be streamed as binary messages
+	connect(_jsonAPI->getCallBack().get(), &JsonCallbacks::binaryCallbackReady, this, &WebSocketJsonHandler::sendBinaryMessage);
+	_jsonAPI->getCallBack()->setBinaryStreamingSupported(true);
+
 	// Init JsonAPI
 	_jsonAPI->initialize();
 }
@@ -46,7 +50,7 @@ void WebSocketJsonHandler::onBinaryMessageReceived(const QByteArray& message)
 #ifdef RECEIVE_TRACE
 	qDebug() << "[" << _peerAddress << "] WebSocket message received:" << message.toHex();
 #endif
-	Warning(_log,"Unexpected binary message received");
+	Warning(_log,"Unexpected binary message received, binary messages are supported for streaming to the client only");
 }
 
 qint64 WebSocketJsonHandler::sendMessage(QJsonObject obj)
@@ -57,6 +61,14 @@ qint64 WebSocketJsonHandler::sendMessage(QJsonObject obj)
 	return _websocket->sendTextMessage(JsonUtils::jsonValueToQString(obj));
 }
 
+qint64 WebSocketJsonHandler::sendBinaryMessage(const QByteArray& data)
+{
+#ifdef TRACE_SEND
+	qDebug() << "[" << _peerAddress << "] WebSocket send binary message: " << data.size() << "bytes";
+#endif
+	return _websocket->sendBinaryMessage(data);
+}
+
 void WebSocketJsonHandler::onDisconnected()
 {
 	Debug(_log, "WebSocket disconnected from %s initiated via: %s", QSTRING_CSTR(_peerAddress), QSTRING_CSTR(_origin));
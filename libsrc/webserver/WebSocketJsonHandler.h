@@ -20,6 +20,7 @@ private slots:
 	void onBinaryMessageReceived(const QByteArray& message);
 	void onDisconnected();
 	qint64 sendMessage(QJsonObject obj);
+	qint64 sendBinaryMessage(const QByteArray& data);
 
 private:
 	QWebSocket* _websocket;
@@ -0,0 +1,182 @@
+// STL includes
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Qt includes
+#include <QIODevice>
+
+// Hyperion includes
+#include <utils/FramedReader.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+using TestHelper::check;
+
+///
+/// Sequential device handing out the stream in chunks, like a socket receiving TCP segments
+///
+class ChunkedDevice : public QIODevice
+{
+public:
+	ChunkedDevice()
+	{
+		open(QIODevice::ReadOnly);
+	}
+
+	bool isSequential() const override { return true; }
+
+	qint64 bytesAvailable() const override
+	{
+		return static_cast<qint64>(_available.size()) + QIODevice::bytesAvailable();
+	}
+
+	/// Makes the next bytes of the stream available
+	void receive(const std::vector<uint8_t>& stream, size_t& position, size_t count)
+	{
+		count = std::min(count, stream.size() - position);
+		_available.insert(_available.end(), stream.begin() + static_cast<long>(position), stream.begin() + static_cast<long>(position + count));
+		position += count;
+	}
+
+protected:
+	qint64 readData(char* data, qint64 maxSize) override
+	{
+		const size_t count = std::min(static_cast<size_t>(maxSize), _available.size());
+		std::memcpy(data, _available.data(), count);
+		_available.erase(_available.begin(), _available.begin() + static_cast<long>(count));
+		return static_cast<qint64>(count);
+	}
+
+	qint64 writeData(const char* /*data*/, qint64 /*maxSize*/) override { return -1; }
+
+private:
+	std::vector<uint8_t> _available;
+};
+
+void appendMessage(std::vector<uint8_t>& stream, const std::vector<uint8_t>& message)
+{
+	const uint32_t size = static_cast<uint32_t>(message.size());
+	stream.push_back(static_cast<uint8_t>(size >> 24));
+	stream.push_back(static_cast<uint8_t>(size >> 16));
+	stream.push_back(static_cast<uint8_t>(size >> 8));
+	stream.push_back(static_cast<uint8_t>(size));
+	stream.insert(stream.end(), message.begin(), message.end());
+}
+
+// Messages of random sizes (including empty ones and a raw 1080p image) received in chunks of random sizes
+void testChunkedStream(std::mt19937& generator)
+{
+	std::uniform_int_distribution<int> bytes(0, 255);
+	std::uniform_int_distribution<size_t> messageSizes(0, 5000);
+
+	std::vector<std::vector<uint8_t>> messages;
+	for (int i = 0; i < 200; ++i)
+	{
+		const size_t size = (i == 100) ? 1920 * 1080 * 3 : (i % 50 == 0) ? 0 : messageSizes(generator);
+		std::vector<uint8_t> message(size);
+		for (uint8_t& byte : message)
+		{
+			byte = static_cast<uint8_t>(bytes(generator));
+		}
+		messages.push_back(message);
+	}
+
+	std::vector<uint8_t> stream;
+	for (const std::vector<uint8_t>& message : messages)
+	{
+		appendMessage(stream, message);
+	}
+
+	for (const size_t maxChunkSize : { size_t(1), size_t(3), size_t(1460), size_t(65536), stream.size() })
+	{
+		std::uniform_int_distribution<size_t> chunkSizes(1, maxChunkSize);
+		ChunkedDevice device;
+		FramedReader reader;
+		size_t position = 0;
+		size_t received = 0;
+
+		while (position < stream.size())
+		{
+			device.receive(stream, position, chunkSizes(generator));
+			while (reader.read(&device) == FramedReader::Result::MessageReady)
+			{
+				check(received < messages.size(), "more messages than sent");
+				if (received < messages.size())
+				{
+					const std::vector<uint8_t>& expected = messages[received];
+					check(reader.size() == expected.size(), "message size");
+					check(reader.size() == expected.size() && (expected.empty() || std::memcmp(reader.data(), expected.data(), expected.size()) == 0), "message content");
+				}
+				++received;
+			}
+		}
+		check(received == messages.size(), "all messages received");
+	}
+}
+
+// A header announcing a message above the limit stops the stream till reset
+void testMessageTooLarge()
+{
+	std::vector<uint8_t> stream;
+	appendMessage(stream, std::vector<uint8_t>(100, 1));
+	appendMessage(stream, std::vector<uint8_t>(2000, 2));
+	appendMessage(stream, std::vector<uint8_t>(10, 3));
+
+	ChunkedDevice device;
+	FramedReader reader(1024);
+	size_t position = 0;
+	device.receive(stream, position, stream.size());
+
+	check(reader.read(&device) == FramedReader::Result::MessageReady && reader.size() == 100, "message below the limit");
+	check(reader.read(&device) == FramedReader::Result::MessageTooLarge && reader.size() == 2000, "message above the limit");
+	check(reader.read(&device) == FramedReader::Result::MessageTooLarge, "stream stopped after a message above the limit");
+
+	// A new stream after reset, e.g. after reconnecting
+	reader.reset();
+	std::vector<uint8_t> nextStream;
+	appendMessage(nextStream, std::vector<uint8_t>(10, 4));
+	ChunkedDevice nextDevice;
+	position = 0;
+	nextDevice.receive(nextStream, position, nextStream.size());
+	check(reader.read(&nextDevice) == FramedReader::Result::MessageReady && reader.size() == 10 && reader.data()[0] == 4, "message after reset");
+	check(reader.read(&nextDevice) == FramedReader::Result::NeedMoreData, "no further message");
+}
+
+// A header announcing a large message followed by a few bytes only, then a new stream after reset
+void testPartialMessage()
+{
+	std::vector<uint8_t> stream;
+	appendMessage(stream, std::vector<uint8_t>(64 * 1024 * 1024, 5));
+
+	ChunkedDevice device;
+	FramedReader reader;
+	size_t position = 0;
+	device.receive(stream, position, 1000);
+	check(reader.read(&device) == FramedReader::Result::NeedMoreData, "large message incomplete");
+
+	reader.reset();
+	std::vector<uint8_t> nextStream;
+	appendMessage(nextStream, std::vector<uint8_t>(10, 6));
+	ChunkedDevice nextDevice;
+	position = 0;
+	nextDevice.receive(nextStream, position, nextStream.size());
+	check(reader.read(&nextDevice) == FramedReader::Result::MessageReady && reader.size() == 10 && reader.data()[9] == 6, "message after a discarded one");
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 generator(4711);
+
+	testChunkedStream(generator);
+	testMessageTooLarge();
+	testPartialMessage();
+
+	return TestHelper::result("FramedReader");
+}
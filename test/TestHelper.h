@@ -0,0 +1,74 @@
+#pragma once
+
+// STL includes
+#include <iostream>
+
+// Qt includes
+#include <QElapsedTimer>
+
+///
+/// Helpers shared by the tests and benchmarks: counting and reporting failed checks, timing repeated work
+///
+namespace TestHelper {
+
+/// Failed checks reported in detail, further ones are counted only
+constexpr int MAX_REPORTED_FAILURES = 10;
+
+/// Number of failed checks
+inline int failures = 0;
+
+///
+/// Counts a failed check and reports it. The description is streamed on failure only.
+///
+/// @param condition The condition checked
+/// @param description Parts of the message describing the check
+///
+template <typename... Description>
+void check(bool condition, const Description&... description)
+{
+	if (!condition && failures++ < MAX_REPORTED_FAILURES)
+	{
+		(std::cerr << ... << description) << '\n';
+	}
+}
+
+///
+/// Reports the result of a test
+///
+/// @param testName The name printed with the result
+/// @return The exit code of the test
+///
+inline int result(const char* testName)
+{
+	if (failures > 0)
+	{
+		std::cerr << testName << ": " << failures << " check(s) failed" << '\n';
+		return 1;
+	}
+
+	std::cout << testName << ": all checks passed" << '\n';
+	return 0;
+}
+
+///
+/// Runs the work once to warm up caches and lazily initialised state, then measures the given number of runs
+///
+/// @param runs Number of runs measured
+/// @param work The work to be measured
+/// @return Nanoseconds elapsed for all runs measured
+///
+template <typename Work>
+qint64 measure(int runs, const Work& work)
+{
+	work();
+
+	QElapsedTimer timer;
+	timer.start();
+	for (int run = 0; run < runs; ++run)
+	{
+		work();
+	}
+	return timer.nsecsElapsed();
+}
+
+} // namespace TestHelper
@@ -1,3 +1,6 @@
+// STL includes
+#include <cstdlib>
+#include <random>
 
 // Utils includes
 #include <utils/Image.h>
@@ -8,6 +11,65 @@
 #include <utils/hyperion.h>
 #include <hyperion/ImageToLedsMap.h>
 
+///
+/// Verifies the dominant color of image quadrants dominated by a single color, but disturbed by random pixels.
+/// The quantized histogram used must return the dominant color within ImageToLedsMap::DOMINANT_COLOR_TOLERANCE.
+///
+bool testDominantColor(Logger* log)
+{
+	const int size = 64;
+	const ColorRgb dominantColors[4] = { {200, 16, 99}, {3, 250, 61}, {128, 128, 128}, {0, 0, 0} };
+
+	std::vector<Led> leds;
+	Image<ColorRgb> image(size, size);
+	std::mt19937 generator(4711);
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	for (int quadrant = 0; quadrant < 4; ++quadrant)
+	{
+		const int xOffset = (quadrant % 2) * size / 2;
+		const int yOffset = (quadrant / 2) * size / 2;
+
+		Led led {};
+		led.minX_frac = (quadrant % 2) * 0.5;
+		led.maxX_frac = led.minX_frac + 0.5;
+		led.minY_frac = (quadrant / 2) * 0.5;
+		led.maxY_frac = led.minY_frac + 0.5;
+		led.colorOrder = ColorOrder::ORDER_RGB;
+		leds.push_back(led);
+
+		// Every third pixel has got the dominant color, the others are random
+		for (int y = yOffset; y < yOffset + size / 2; ++y)
+		{
+			for (int x = xOffset; x < xOffset + size / 2; ++x)
+			{
+				image(x, y) = ((x + y) % 3 == 0) ? dominantColors[quadrant]
+												 : ColorRgb(static_cast<uint8_t>(distribution(generator)),
+															static_cast<uint8_t>(distribution(generator)),
+															static_cast<uint8_t>(distribution(generator)));
+			}
+		}
+	}
+
+	const hyperion::ImageToLedsMap map(log, size, size, 0, 0, leds);
+	const std::vector<ColorRgb> ledColors = map.getDominantLedColor(image);
+
+	bool success = true;
+	for (int quadrant = 0; quadrant < 4; ++quadrant)
+	{
+		const ColorRgb& expected = dominantColors[quadrant];
+		const ColorRgb& actual = ledColors[quadrant];
+		if (std::abs(expected.red - actual.red) > hyperion::ImageToLedsMap::DOMINANT_COLOR_TOLERANCE[0] ||
+			std::abs(expected.green - actual.green) > hyperion::ImageToLedsMap::DOMINANT_COLOR_TOLERANCE[1] ||
+			std::abs(expected.blue - actual.blue) > hyperion::ImageToLedsMap::DOMINANT_COLOR_TOLERANCE[2])
+		{
+			std::cerr << "Dominant color of quadrant " << quadrant << " is " << actual << ", expected " << expected << '\n';
+			success = false;
+		}
+	}
+	return success;
+}
+
 int main()
 {
 	Logger* log = Logger::getInstance("TestImageLedsMap");
@@ -43,5 +105,10 @@ int main()
 	}
 	std::cout << "]" << '\n';
 
+	if (!testDominantColor(log))
+	{
+		return -1;
+	}
+
 	return 0;
 }
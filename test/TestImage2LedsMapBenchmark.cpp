@@ -0,0 +1,128 @@
+// STL includes
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <random>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/Logger.h>
+#include <utils/PixelSum.h>
+
+// Hyperion includes
+#include <hyperion/ImageToLedsMap.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+const int IMAGE_WIDTH = 1920;
+const int IMAGE_HEIGHT = 1080;
+const int LEDS_HORIZONTAL = 100;
+const int LEDS_VERTICAL = 60;
+const int BENCHMARK_FRAMES = 50;
+
+// Classic layout with LED areas of 1/LEDS_xxx length and 8% depth around the screen
+std::vector<Led> createClassicLayout()
+{
+	std::vector<Led> leds;
+	const double depth = 0.08;
+
+	auto addLed = [&leds](double minX, double maxX, double minY, double maxY) {
+		Led led {};
+		led.minX_frac = minX;
+		led.maxX_frac = maxX;
+		led.minY_frac = minY;
+		led.maxY_frac = maxY;
+		led.colorOrder = ColorOrder::ORDER_RGB;
+		leds.push_back(led);
+	};
+
+	for (int i = 0; i < LEDS_HORIZONTAL; ++i)
+	{
+		addLed(double(i) / LEDS_HORIZONTAL, double(i + 1) / LEDS_HORIZONTAL, 0.0, depth);
+	}
+	for (int i = 0; i < LEDS_VERTICAL; ++i)
+	{
+		addLed(1.0 - depth, 1.0, double(i) / LEDS_VERTICAL, double(i + 1) / LEDS_VERTICAL);
+	}
+	for (int i = LEDS_HORIZONTAL - 1; i >= 0; --i)
+	{
+		addLed(double(i) / LEDS_HORIZONTAL, double(i + 1) / LEDS_HORIZONTAL, 1.0 - depth, 1.0);
+	}
+	for (int i = LEDS_VERTICAL - 1; i >= 0; --i)
+	{
+		addLed(0.0, depth, double(i) / LEDS_VERTICAL, double(i + 1) / LEDS_VERTICAL);
+	}
+	return leds;
+}
+
+} // namespace
+
+int main()
+{
+	Logger* log = Logger::getInstance("TestImageLedsMapBenchmark");
+	Logger::setLogLevel(Logger::WARNING);
+
+	Image<ColorRgb> image(IMAGE_WIDTH, IMAGE_HEIGHT);
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, 255);
+	for (int idx = 0; idx < IMAGE_WIDTH * IMAGE_HEIGHT; ++idx)
+	{
+		image.memptr()[idx] = ColorRgb(static_cast<uint8_t>(distribution(generator)),
+									   static_cast<uint8_t>(distribution(generator)),
+									   static_cast<uint8_t>(distribution(generator)));
+	}
+
+	const std::vector<Led> leds = createClassicLayout();
+	std::vector<ColorRgb> ledColors(leds.size());
+
+	std::cout << "Image: " << IMAGE_WIDTH << "x" << IMAGE_HEIGHT << ", LEDs: " << leds.size() << ", frames: " << BENCHMARK_FRAMES << '\n';
+
+	for (int reducedPixelSetFactor : {0, 1})
+	{
+		const hyperion::ImageToLedsMap map(log, IMAGE_WIDTH, IMAGE_HEIGHT, 0, 0, leds, reducedPixelSetFactor, 4);
+
+		struct MappingType
+		{
+			const char* name;
+			bool usesPixelSum;
+			std::function<void()> processFrame;
+		};
+
+		const std::vector<MappingType> mappingTypes {
+			{ "multicolor_mean",            true,  [&]{ map.getMeanLedColor(image, ledColors); } },
+			{ "multicolor_mean_squared",    true,  [&]{ map.getMeanSqrtLedColor(image, ledColors); } },
+			{ "unicolor_mean",              true,  [&]{ map.getUniLedColor(image, ledColors); } },
+			{ "dominant_color",             false, [&]{ map.getDominantLedColor(image, ledColors); } },
+			{ "unicolor_dominant",          false, [&]{ map.getDominantUniLedColor(image, ledColors); } },
+			{ "dominant_color_advanced",    false, [&]{ map.getDominantAdvLedColor(image, ledColors); } },
+			{ "unicolor_dominant_advanced", false, [&]{ map.getDominantAdvUniLedColor(image, ledColors); } }
+		};
+
+		std::cout << "\nReduced pixel set factor: " << reducedPixelSetFactor << '\n';
+		bool firstKernel = true;
+		for (const PixelSum::Kernel kernel : { PixelSum::Kernel::Scalar, PixelSum::Kernel::Sse2, PixelSum::Kernel::Avx2, PixelSum::Kernel::Neon })
+		{
+			if (!PixelSum::setKernel(kernel))
+			{
+				continue;
+			}
+
+			std::cout << "Summation kernel: " << PixelSum::kernelName(kernel) << '\n';
+			for (const MappingType& mappingType : mappingTypes)
+			{
+				// Mapping types not using the summation kernels are measured once only
+				if (!firstKernel && !mappingType.usesPixelSum)
+				{
+					continue;
+				}
+				std::cout << "  " << std::left << std::setw(28) << mappingType.name
+						  << std::right << std::setw(12) << TestHelper::measure(BENCHMARK_FRAMES, mappingType.processFrame) / BENCHMARK_FRAMES << " ns/frame" << '\n';
+			}
+			firstKernel = false;
+		}
+	}
+
+	return 0;
+}
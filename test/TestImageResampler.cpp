@@ -0,0 +1,244 @@
+// STL includes
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Utils includes
+#include <utils/ColorSys.h>
+#include <utils/Image.h>
+#include <utils/ImageResampler.h>
+#include <utils/Logger.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+struct Format
+{
+	const char* name;
+	PixelFormat pixelFormat;
+	// bytes per pixel of the (luma) plane
+	int pixelSize;
+	bool isPlanar;
+};
+
+struct Settings
+{
+	const Format* format;
+	FlipMode flipMode;
+	VideoMode videoMode;
+	int horizontalDecimation;
+	int verticalDecimation;
+	int cropLeft;
+	int cropRight;
+	int cropTop;
+	int cropBottom;
+};
+
+const char* flipModeName(FlipMode flipMode)
+{
+	switch (flipMode)
+	{
+	case FlipMode::HORIZONTAL: return "horizontal";
+	case FlipMode::VERTICAL:   return "vertical";
+	case FlipMode::BOTH:       return "both";
+	default:                   return "none";
+	}
+}
+
+std::ostream& operator<<(std::ostream& stream, const Settings& settings)
+{
+	return stream << "flip: " << flipModeName(settings.flipMode)
+				  << ", 3D mode: " << static_cast<int>(settings.videoMode)
+				  << ", decimation: " << settings.horizontalDecimation << "/" << settings.verticalDecimation
+				  << ", crop: " << settings.cropLeft << "/" << settings.cropRight << "/" << settings.cropTop << "/" << settings.cropBottom;
+}
+
+///
+/// Pixel by pixel reference, as the resampler worked before the conversion was batched and specialized per format
+///
+void referenceProcessImage(const Settings& settings, const uint8_t* data, int width, int height, size_t lineLength, Image<ColorRgb>& outputImage)
+{
+	int cropLeft = settings.cropLeft;
+	int cropRight = settings.cropRight;
+	int cropTop = settings.cropTop;
+	int cropBottom = settings.cropBottom;
+
+	switch (settings.videoMode)
+	{
+	case VideoMode::VIDEO_3DSBS:
+		cropRight = (width >> 1) + (cropRight >> 1);
+		cropLeft = cropLeft >> 1;
+		break;
+	case VideoMode::VIDEO_3DTAB:
+		cropBottom = (height >> 1) + (cropBottom >> 1);
+		cropTop = cropTop >> 1;
+		break;
+	default:
+		break;
+	}
+
+	const int xDecimation = settings.horizontalDecimation;
+	const int yDecimation = settings.verticalDecimation;
+	const int outputWidth = (width - cropLeft - cropRight - (xDecimation >> 1) + xDecimation - 1) / xDecimation;
+	const int outputHeight = (height - cropTop - cropBottom - (yDecimation >> 1) + yDecimation - 1) / yDecimation;
+	outputImage.resize(outputWidth, outputHeight);
+
+	const bool mirrorRows = (settings.flipMode == FlipMode::HORIZONTAL || settings.flipMode == FlipMode::BOTH);
+	const bool mirrorColumns = (settings.flipMode == FlipMode::VERTICAL || settings.flipMode == FlipMode::BOTH);
+
+	for (int yDest = 0, ySource = cropTop + (yDecimation >> 1); yDest < outputHeight; ySource += yDecimation, ++yDest)
+	{
+		for (int xDest = 0, xSource = cropLeft + (xDecimation >> 1); xDest < outputWidth; xSource += xDecimation, ++xDest)
+		{
+			ColorRgb& rgb = outputImage(mirrorColumns ? outputWidth - 1 - xDest : xDest, mirrorRows ? outputHeight - 1 - yDest : yDest);
+			const size_t row = lineLength * static_cast<size_t>(ySource);
+
+			switch (settings.format->pixelFormat)
+			{
+			case PixelFormat::UYVY:
+			{
+				const size_t index = row + static_cast<size_t>(xSource << 1);
+				const uint8_t u = ((xSource & 1) == 0) ? data[index    ] : data[index - 2];
+				const uint8_t v = ((xSource & 1) == 0) ? data[index + 2] : data[index    ];
+				ColorSys::yuv2rgb(data[index + 1], u, v, rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			case PixelFormat::YUYV:
+			{
+				const size_t index = row + static_cast<size_t>(xSource << 1);
+				const uint8_t u = ((xSource & 1) == 0) ? data[index + 1] : data[index - 1];
+				const uint8_t v = ((xSource & 1) == 0) ? data[index + 3] : data[index + 1];
+				ColorSys::yuv2rgb(data[index], u, v, rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			case PixelFormat::BGR16:
+			{
+				const size_t index = row + static_cast<size_t>(xSource << 1);
+				rgb.blue  = static_cast<uint8_t>((data[index] & 0x1f) << 3);
+				rgb.green = static_cast<uint8_t>((((data[index + 1] & 0x7) << 3) | (data[index] & 0xE0) >> 5) << 2);
+				rgb.red   = static_cast<uint8_t>(data[index + 1] & 0xF8);
+				break;
+			}
+			case PixelFormat::RGB24:
+			case PixelFormat::RGB32:
+			{
+				const size_t index = row + static_cast<size_t>(xSource * settings.format->pixelSize);
+				rgb.red   = data[index    ];
+				rgb.green = data[index + 1];
+				rgb.blue  = data[index + 2];
+				break;
+			}
+			case PixelFormat::BGR24:
+			case PixelFormat::BGR32:
+			{
+				const size_t index = row + static_cast<size_t>(xSource * settings.format->pixelSize);
+				rgb.blue  = data[index    ];
+				rgb.green = data[index + 1];
+				rgb.red   = data[index + 2];
+				break;
+			}
+			case PixelFormat::NV12:
+			{
+				const size_t uvOffset = static_cast<size_t>(height + ySource / 2) * lineLength + static_cast<size_t>((xSource >> 1) << 1);
+				ColorSys::yuv2rgb(data[row + static_cast<size_t>(xSource)], data[uvOffset], data[uvOffset + 1], rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			case PixelFormat::I420:
+			{
+				const size_t uOffset = static_cast<size_t>(width * height + (ySource / 2) * width / 2);
+				const size_t vOffset = static_cast<size_t>(width * height + (width * height) / 4 + (ySource / 2) * width / 2);
+				ColorSys::yuv2rgb(data[row + static_cast<size_t>(xSource)], data[uOffset + static_cast<size_t>(xSource >> 1)], data[vOffset + static_cast<size_t>(xSource >> 1)], rgb.red, rgb.green, rgb.blue);
+				break;
+			}
+			default:
+				break;
+			}
+		}
+	}
+}
+
+bool equal(const Image<ColorRgb>& a, const Image<ColorRgb>& b)
+{
+	return a.width() == b.width() && a.height() == b.height()
+		&& std::memcmp(a.memptr(), b.memptr(), static_cast<size_t>(a.width()) * static_cast<size_t>(a.height()) * sizeof(ColorRgb)) == 0;
+}
+
+void compare(const Settings& settings, const std::vector<uint8_t>& data, int width, int height)
+{
+	// Planar formats are tightly packed, the others have padded rows
+	const size_t lineLength = static_cast<size_t>(width * settings.format->pixelSize + (settings.format->isPlanar ? 0 : 12));
+
+	ImageResampler resampler;
+	resampler.setHorizontalPixelDecimation(settings.horizontalDecimation);
+	resampler.setVerticalPixelDecimation(settings.verticalDecimation);
+	resampler.setCropping(settings.cropLeft, settings.cropRight, settings.cropTop, settings.cropBottom);
+	resampler.setVideoMode(settings.videoMode);
+	resampler.setFlipMode(settings.flipMode);
+
+	Image<ColorRgb> expected;
+	Image<ColorRgb> actual;
+	referenceProcessImage(settings, data.data(), width, height, lineLength, expected);
+	resampler.processImage(data.data(), width, height, lineLength, settings.format->pixelFormat, actual);
+	TestHelper::check(equal(expected, actual), "Mismatch in ", settings.format->name, " (", width, "x", height, ", ", settings, ")");
+}
+
+} // namespace
+
+int main()
+{
+	Logger::setLogLevel(Logger::WARNING);
+
+	const std::vector<Format> formats {
+		{ "YUYV",  PixelFormat::YUYV,  2, false },
+		{ "UYVY",  PixelFormat::UYVY,  2, false },
+		{ "NV12",  PixelFormat::NV12,  1, true  },
+		{ "I420",  PixelFormat::I420,  1, true  },
+		{ "BGR16", PixelFormat::BGR16, 2, false },
+		{ "RGB24", PixelFormat::RGB24, 3, false },
+		{ "BGR24", PixelFormat::BGR24, 3, false },
+		{ "RGB32", PixelFormat::RGB32, 4, false },
+		{ "BGR32", PixelFormat::BGR32, 4, false }
+	};
+
+	const std::vector<FlipMode> flipModes { FlipMode::NO_CHANGE, FlipMode::HORIZONTAL, FlipMode::VERTICAL, FlipMode::BOTH };
+	const std::vector<VideoMode> videoModes { VideoMode::VIDEO_2D, VideoMode::VIDEO_3DSBS, VideoMode::VIDEO_3DTAB };
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> bytes(0, 255);
+	std::uniform_int_distribution<int> crops(0, 9);
+
+	// Sizes with and without partial conversion batches at the row ends
+	for (const int width : { 64, 98 })
+	{
+		const int height = width / 2 + 4;
+
+		// Random content for all formats, large enough for the padded rows and the chroma planes
+		std::vector<uint8_t> data(static_cast<size_t>((width * 4 + 12) * height * 2));
+		for (uint8_t& byte : data)
+		{
+			byte = static_cast<uint8_t>(bytes(generator));
+		}
+
+		for (const Format& format : formats)
+		{
+			for (const FlipMode flipMode : flipModes)
+			{
+				for (int decimation = 1; decimation <= 8; ++decimation)
+				{
+					compare({ &format, flipMode, VideoMode::VIDEO_2D, decimation, decimation, 0, 0, 0, 0 }, data, width, height);
+					compare({ &format, flipMode, VideoMode::VIDEO_2D, decimation, 9 - decimation, 0, 0, 0, 0 }, data, width, height);
+
+					for (const VideoMode videoMode : videoModes)
+					{
+						compare({ &format, flipMode, videoMode, decimation, decimation,
+								  crops(generator), crops(generator), crops(generator), crops(generator) }, data, width, height);
+					}
+				}
+			}
+		}
+	}
+
+	return TestHelper::result("ImageResampler");
+}
@@ -0,0 +1,101 @@
+// STL includes
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <vector>
+
+// Utils includes
+#include <utils/Image.h>
+#include <utils/ImageResampler.h>
+#include <utils/Logger.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+const int BENCHMARK_FRAMES = 50;
+
+struct Resolution
+{
+	const char* name;
+	int width;
+	int height;
+};
+
+struct Format
+{
+	const char* name;
+	PixelFormat pixelFormat;
+	// bytes per pixel of the (luma) plane
+	int pixelSize;
+};
+
+qint64 measure(const ImageResampler& resampler, const std::vector<uint8_t>& data, const Resolution& resolution, const Format& format)
+{
+	Image<ColorRgb> outputImage;
+	const size_t lineLength = static_cast<size_t>(resolution.width) * static_cast<size_t>(format.pixelSize);
+
+	return TestHelper::measure(BENCHMARK_FRAMES, [&]{
+		resampler.processImage(data.data(), resolution.width, resolution.height, lineLength, format.pixelFormat, outputImage);
+	}) / BENCHMARK_FRAMES;
+}
+
+} // namespace
+
+int main()
+{
+	Logger::setLogLevel(Logger::WARNING);
+
+	const std::vector<Resolution> resolutions {
+		{ "1280x720",  1280, 720  },
+		{ "1920x1080", 1920, 1080 },
+		{ "3840x2160", 3840, 2160 }
+	};
+
+	const std::vector<Format> formats {
+		{ "YUYV",  PixelFormat::YUYV,  2 },
+		{ "UYVY",  PixelFormat::UYVY,  2 },
+		{ "NV12",  PixelFormat::NV12,  1 },
+		{ "I420",  PixelFormat::I420,  1 },
+		{ "BGR16", PixelFormat::BGR16, 2 },
+		{ "RGB24", PixelFormat::RGB24, 3 },
+		{ "BGR24", PixelFormat::BGR24, 3 },
+		{ "RGB32", PixelFormat::RGB32, 4 },
+		{ "BGR32", PixelFormat::BGR32, 4 }
+	};
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	std::cout << "Frames: " << BENCHMARK_FRAMES << '\n';
+
+	for (const Resolution& resolution : resolutions)
+	{
+		// Largest buffer needed (RGB32), filled with random data
+		std::vector<uint8_t> data(static_cast<size_t>(resolution.width) * static_cast<size_t>(resolution.height) * 4);
+		for (uint8_t& value : data)
+		{
+			value = static_cast<uint8_t>(distribution(generator));
+		}
+
+		for (int decimation : {1, 2, 8})
+		{
+			ImageResampler resampler;
+			resampler.setHorizontalPixelDecimation(decimation);
+			resampler.setVerticalPixelDecimation(decimation);
+
+			std::cout << "\nImage: " << resolution.name << ", decimation: " << decimation << '\n';
+			for (const Format& format : formats)
+			{
+				std::cout << "  " << std::left << std::setw(10) << format.name
+						  << std::right << std::setw(12) << measure(resampler, data, resolution, format) << " ns/frame" << '\n';
+			}
+
+			resampler.setFlipMode(FlipMode::BOTH);
+			std::cout << "  " << std::left << std::setw(10) << "YUYV flip"
+					  << std::right << std::setw(12) << measure(resampler, data, resolution, formats.front()) << " ns/frame" << '\n';
+		}
+	}
+
+	return 0;
+}
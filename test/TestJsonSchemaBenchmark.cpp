@@ -0,0 +1,100 @@
+// STL includes
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Qt includes
+#include <QJsonObject>
+#include <QString>
+
+// Utils includes
+#include <utils/Logger.h>
+#include <utils/JsonUtils.h>
+#include <utils/jsonschema/QJsonFactory.h>
+#include <utils/jsonschema/QJsonSchemaCache.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+const int BENCHMARK_MESSAGES = 2000;
+
+// Validation as done before caching: schemas read and resolved, checkers created for every message
+bool validateUncached(const QString& command, const QJsonObject& message, Logger* log)
+{
+	const QJsonObject schema = QJsonFactory::readSchema(":schema");
+	if (!JsonUtils::validate("benchmark", message, schema, log).first)
+	{
+		return false;
+	}
+	const QJsonObject commandSchema = QJsonFactory::readSchema(QString(":schema-%1").arg(command));
+	return JsonUtils::validate("benchmark", message, commandSchema, log).first;
+}
+
+// Validation by the cached schema checkers, as done by JsonAPI::handleMessage
+bool validateCached(const QString& command, const QJsonObject& message, Logger* log)
+{
+	if (!JsonUtils::validate("benchmark", message, QJsonSchemaCache::getChecker(":schema"), log).first)
+	{
+		return false;
+	}
+	return JsonUtils::validate("benchmark", message, QJsonSchemaCache::getChecker(QString(":schema-%1").arg(command)), log).first;
+}
+
+double measure(const std::function<bool()>& validateMessage, bool& isValid)
+{
+	isValid = validateMessage();
+
+	const double seconds = static_cast<double>(TestHelper::measure(BENCHMARK_MESSAGES, validateMessage)) / 1e9;
+	return BENCHMARK_MESSAGES / seconds;
+}
+
+QJsonObject fromJson(const char* json)
+{
+	QJsonObject message;
+	JsonUtils::parse("benchmark", json, message, Logger::getInstance("BENCHMARK"));
+	return message;
+}
+
+} // namespace
+
+int main()
+{
+	// make sure the resources are loaded (they may be left out after static linking)
+	Q_INIT_RESOURCE(JSONRPC_schemas);
+
+	Logger::setLogLevel(Logger::WARNING);
+	Logger* log = Logger::getInstance("BENCHMARK");
+
+	const std::vector<std::pair<QString, QJsonObject>> messages {
+		{ "color", fromJson(R"({"command":"color","priority":50,"color":[255,128,0],"origin":"Benchmark","tan":1})") },
+		{ "adjustment", fromJson(R"({"command":"adjustment","adjustment":{"red":[255,0,0],"green":[0,255,0],"blue":[0,0,255],"brightness":80},"tan":2})") },
+		{ "componentstate", fromJson(R"({"command":"componentstate","componentstate":{"component":"SMOOTHING","state":true},"tan":3})") },
+		{ "clear", fromJson(R"({"command":"clear","priority":50,"tan":4})") },
+		{ "effect", fromJson(R"({"command":"effect","priority":50,"effect":{"name":"Rainbow swirl"},"duration":5000,"tan":5})") },
+		{ "image", fromJson(R"({"command":"image","priority":50,"imagewidth":2,"imageheight":1,"imagedata":"/wAAAP8A","format":"auto","tan":6})") },
+		{ "serverinfo", fromJson(R"({"command":"serverinfo","subcommand":"getInfo","tan":7})") }
+	};
+
+	std::cout << "Messages: " << BENCHMARK_MESSAGES << '\n';
+	std::cout << std::left << std::setw(16) << "command" << std::right << std::setw(16) << "uncached" << std::setw(16) << "cached" << '\n';
+
+	for (const auto& entry : messages)
+	{
+		const QString& command = entry.first;
+		const QJsonObject& message = entry.second;
+
+		bool isValidUncached = false;
+		bool isValidCached = false;
+		const double uncached = measure([&]{ return validateUncached(command, message, log); }, isValidUncached);
+		const double cached = measure([&]{ return validateCached(command, message, log); }, isValidCached);
+
+		std::cout << std::left << std::setw(16) << command.toStdString() << std::right << std::fixed << std::setprecision(0)
+				  << std::setw(12) << uncached << " m/s" << std::setw(12) << cached << " m/s"
+				  << ((isValidUncached && isValidCached) ? "" : "  (invalid message)") << '\n';
+	}
+
+	return 0;
+}
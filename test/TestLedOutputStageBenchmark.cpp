@@ -0,0 +1,124 @@
+// STL includes
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <random>
+#include <utility>
+
+// Utils includes
+#include <utils/ColorRgb.h>
+#include <utils/Logger.h>
+
+// Hyperion includes
+#include <hyperion/LedString.h>
+#include <hyperion/MultiColorAdjustment.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+const int BENCHMARK_FRAMES = 200;
+
+// Output stage as performed by separate passes over the LEDs (blacklisting, adjustment, color order, copy)
+void separatePasses(MultiColorAdjustment& adjustment, const LedString& ledString, const std::vector<ColorRgb>& input, std::vector<ColorRgb>& ledBuffer)
+{
+	std::vector<ColorRgb> ledColors = input;
+	for (unsigned long const id : ledString.blacklistedLedIds())
+	{
+		if (id > ledColors.size()-1)
+		{
+			break;
+		}
+		ledColors.at(id) = ColorRgb::BLACK;
+	}
+
+	adjustment.applyAdjustment(ledColors);
+
+	for (size_t i=0; i < ledString.leds().size(); ++i)
+	{
+		ColorRgb& color = ledColors.at(i);
+		switch (ledString.leds().at(i).colorOrder)
+		{
+		case ColorOrder::ORDER_RGB:
+			break;
+		case ColorOrder::ORDER_BGR:
+			std::swap(color.red, color.blue);
+			break;
+		case ColorOrder::ORDER_RBG:
+			std::swap(color.green, color.blue);
+			break;
+		case ColorOrder::ORDER_GRB:
+			std::swap(color.red, color.green);
+			break;
+		case ColorOrder::ORDER_GBR:
+			std::swap(color.red, color.green);
+			std::swap(color.green, color.blue);
+			break;
+		case ColorOrder::ORDER_BRG:
+			std::swap(color.red, color.blue);
+			std::swap(color.green, color.blue);
+			break;
+		}
+	}
+
+	std::copy_n(ledColors.begin(), std::min(ledBuffer.size(), ledColors.size()), ledBuffer.begin());
+}
+
+double measure(int ledCount, const std::function<void()>& processFrame)
+{
+	const double seconds = static_cast<double>(TestHelper::measure(BENCHMARK_FRAMES, processFrame)) / 1e9;
+	return static_cast<double>(ledCount) * BENCHMARK_FRAMES / seconds;
+}
+
+} // namespace
+
+int main()
+{
+	Logger::setLogLevel(Logger::WARNING);
+
+	std::mt19937 generator(42);
+	std::uniform_int_distribution<int> distribution(0, 255);
+
+	std::cout << "Frames: " << BENCHMARK_FRAMES << '\n';
+
+	for (int ledCount : {100, 1000, 10000})
+	{
+		LedString ledString;
+		for (int i = 0; i < ledCount; ++i)
+		{
+			Led led {};
+			led.colorOrder = (i % 2 == 0) ? ColorOrder::ORDER_GRB : ColorOrder::ORDER_RGB;
+			led.isBlacklisted = (i % 50 == 0);
+			if (led.isBlacklisted)
+			{
+				ledString.blacklistedLedIds().push_back(i);
+			}
+			ledString.leds().push_back(led);
+		}
+
+		MultiColorAdjustment adjustment(ledCount);
+		ColorAdjustment* colorAdjustment = new ColorAdjustment();
+		colorAdjustment->_id = "default";
+		colorAdjustment->_rgbTransform = RgbTransform(1.5, 1.5, 1.5, 0, true, 100, 100, 6600);
+		adjustment.addAdjustment(colorAdjustment);
+		adjustment.setAdjustmentForLed("default", 0, ledCount - 1);
+		adjustment.setLedString(ledString);
+
+		std::vector<ColorRgb> input(static_cast<size_t>(ledCount));
+		for (ColorRgb& color : input)
+		{
+			color = ColorRgb(static_cast<uint8_t>(distribution(generator)),
+							 static_cast<uint8_t>(distribution(generator)),
+							 static_cast<uint8_t>(distribution(generator)));
+		}
+		std::vector<ColorRgb> ledBuffer(static_cast<size_t>(ledCount));
+
+		std::cout << "\nLEDs: " << ledCount << '\n';
+		std::cout << "  " << std::left << std::setw(16) << "separate passes" << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+				  << measure(ledCount, [&]{ separatePasses(adjustment, ledString, input, ledBuffer); }) << " LEDs/s" << '\n';
+		std::cout << "  " << std::left << std::setw(16) << "output stage" << std::right << std::setw(14) << std::fixed << std::setprecision(0)
+				  << measure(ledCount, [&]{ adjustment.applyOutputStage(input, true, ledBuffer); }) << " LEDs/s" << '\n';
+	}
+
+	return 0;
+}
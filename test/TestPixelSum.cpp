@@ -0,0 +1,99 @@
+// STL includes
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Hyperion includes
+#include <utils/PixelSum.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+void check(bool condition, const char* function, PixelSum::Kernel kernel, int offset, int pixelCount)
+{
+	TestHelper::check(condition, "Mismatch in ", function, " (kernel: ", PixelSum::kernelName(kernel),
+					  ", offset: ", offset, ", pixels: ", pixelCount, ")");
+}
+
+struct Sums
+{
+	uint64_t sum[3] = { 0, 0, 0 };
+	uint64_t squared[3] = { 0, 0, 0 };
+
+	bool operator==(const Sums& other) const
+	{
+		return std::memcmp(sum, other.sum, sizeof(sum)) == 0 && std::memcmp(squared, other.squared, sizeof(squared)) == 0;
+	}
+};
+
+Sums calculate(PixelSum::Kernel kernel, const uint8_t* rgb, int pixelCount)
+{
+	PixelSum::setKernel(kernel);
+	Sums sums;
+	// Non-zero start values, the kernels add to the given sums
+	sums.sum[1] = 1;
+	sums.squared[2] = 1;
+	PixelSum::sumRgb(rgb, pixelCount, sums.sum);
+	PixelSum::sumRgbSquared(rgb, pixelCount, sums.squared);
+	return sums;
+}
+
+// Random runs of all lengths around the vector widths, starting at unaligned offsets
+void testRandomRuns(std::mt19937& generator, PixelSum::Kernel kernel)
+{
+	std::uniform_int_distribution<int> bytes(0, 255);
+	std::vector<uint8_t> rgb(3 * 1024 + 64);
+	for (uint8_t& byte : rgb)
+	{
+		byte = static_cast<uint8_t>(bytes(generator));
+	}
+
+	for (int offset = 0; offset < 32; ++offset)
+	{
+		for (int pixelCount = 0; pixelCount <= 1024; pixelCount += (pixelCount < 100) ? 1 : 37)
+		{
+			const Sums expected = calculate(PixelSum::Kernel::Scalar, rgb.data() + offset, pixelCount);
+			const Sums actual = calculate(kernel, rgb.data() + offset, pixelCount);
+			check(actual == expected, "random run", kernel, offset, pixelCount);
+		}
+	}
+}
+
+// Runs of white pixels long enough to overflow 32-bit lanes, if the squared sums were not flushed in time
+void testLongRuns(PixelSum::Kernel kernel)
+{
+	for (const int pixelCount : { 16 * 1024, 32 * 1024 + 5, 3840 * 2160 })
+	{
+		const std::vector<uint8_t> rgb(static_cast<size_t>(pixelCount) * 3, 255);
+		const Sums expected = calculate(PixelSum::Kernel::Scalar, rgb.data(), pixelCount);
+		const Sums actual = calculate(kernel, rgb.data(), pixelCount);
+		check(actual == expected, "long run", kernel, 0, pixelCount);
+	}
+}
+
+} // namespace
+
+int main()
+{
+	const PixelSum::Kernel defaultKernel = PixelSum::kernel();
+	std::mt19937 generator(4711);
+
+	for (const PixelSum::Kernel kernel : { PixelSum::Kernel::Sse2, PixelSum::Kernel::Avx2, PixelSum::Kernel::Neon })
+	{
+		if (!PixelSum::isSupported(kernel))
+		{
+			std::cout << PixelSum::kernelName(kernel) << ": not supported, skipped" << '\n';
+			continue;
+		}
+
+		testRandomRuns(generator, kernel);
+		testLongRuns(kernel);
+		std::cout << PixelSum::kernelName(kernel) << ": compared with " << PixelSum::kernelName(PixelSum::Kernel::Scalar) << '\n';
+	}
+
+	PixelSum::setKernel(defaultKernel);
+
+	return TestHelper::result("PixelSum");
+}
@@ -0,0 +1,192 @@
+// STL includes
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Hyperion includes
+#include <hyperion/SmoothingKernels.h>
+
+#include "TestHelper.h"
+
+namespace {
+
+void check(bool condition, const char* kernel, size_t ledCount, int frame)
+{
+	TestHelper::check(condition, "Mismatch in ", kernel, " (LEDs: ", ledCount, ", frame: ", frame, ")");
+}
+
+bool equal(const std::vector<ColorRgb>& a, const std::vector<ColorRgb>& b)
+{
+	return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(ColorRgb)) == 0;
+}
+
+std::vector<ColorRgb> randomColors(std::mt19937& generator, size_t ledCount)
+{
+	std::uniform_int_distribution<int> distribution(0, 255);
+	std::vector<ColorRgb> colors(ledCount);
+	for (ColorRgb& color : colors)
+	{
+		color = ColorRgb(static_cast<uint8_t>(distribution(generator)),
+						 static_cast<uint8_t>(distribution(generator)),
+						 static_cast<uint8_t>(distribution(generator)));
+	}
+	return colors;
+}
+
+// Weighted decay: aggregation of frames with random weights, followed by assembling with and without dithering
+void testWeightedDecay(std::mt19937& generator, size_t ledCount)
+{
+	InterleavedSmoothingKernels interleaved;
+	PlanarSmoothingKernels planar;
+	interleaved.resize(ledCount);
+	planar.resize(ledCount);
+
+	std::uniform_real_distribution<float> weights(0.0F, 1.0F);
+	std::uniform_int_distribution<int> frameCount(1, 8);
+
+	for (int frame = 0; frame < 200; ++frame)
+	{
+		interleaved.resetAccumulator();
+		planar.resetAccumulator();
+
+		float fs = 0.0F;
+		const int frames = frameCount(generator);
+		for (int i = 0; i < frames; ++i)
+		{
+			const std::vector<ColorRgb> colors = randomColors(generator, ledCount);
+			const float weight = weights(generator) / static_cast<float>(frames);
+			fs += weight;
+			interleaved.aggregate(colors, weight);
+			planar.aggregate(colors, weight);
+		}
+
+		const float inv_fs = (fs < 1.0F) ? 1.0F : 1.0F / fs;
+		interleaved.normalize(inv_fs);
+		planar.normalize(inv_fs);
+
+		std::vector<ColorRgb> expected(ledCount);
+		std::vector<ColorRgb> actual(ledCount);
+
+		interleaved.assemble(expected);
+		planar.assemble(actual);
+		check(equal(expected, actual), "assemble (weighted decay)", ledCount, frame);
+
+		interleaved.assembleAndDither(expected);
+		planar.assembleAndDither(actual);
+		check(equal(expected, actual), "assembleAndDither (weighted decay)", ledCount, frame);
+	}
+}
+
+// Linear decay: running window sums of a sliding history, followed by dithering over consecutive frames
+void testLinearDecay(std::mt19937& generator, size_t ledCount)
+{
+	InterleavedSmoothingKernels interleaved;
+	PlanarSmoothingKernels planar;
+	interleaved.resize(ledCount);
+	planar.resize(ledCount);
+	interleaved.resetWindowSums(ledCount);
+	planar.resetWindowSums(ledCount);
+
+	const uint64_t window = 200000;
+	const float inverseWindow = 1.0F / window;
+	std::uniform_int_distribution<uint64_t> durations(0, window / 4);
+
+	std::vector<std::vector<ColorRgb>> history;
+	std::vector<uint64_t> historyDurations;
+
+	for (int frame = 0; frame < 500; ++frame)
+	{
+		// Add the previous newest frame to the sums and drop old frames from them again
+		if (history.size() > 1)
+		{
+			const uint64_t duration = durations(generator);
+			historyDurations.back() = duration;
+			interleaved.addToWindowSums(history.back(), duration);
+			planar.addToWindowSums(history.back(), duration);
+		}
+		if (history.size() > 4)
+		{
+			interleaved.subtractFromWindowSums(history[1], historyDurations[1]);
+			planar.subtractFromWindowSums(history[1], historyDurations[1]);
+			history.erase(history.begin());
+			historyDurations.erase(historyDurations.begin());
+		}
+		history.push_back(randomColors(generator, ledCount));
+		historyDurations.push_back(0);
+
+		const uint64_t oldestTime = durations(generator);
+		const uint64_t newestTime = durations(generator);
+		interleaved.averageWindow(history.front(), oldestTime, history.back(), newestTime, inverseWindow);
+		planar.averageWindow(history.front(), oldestTime, history.back(), newestTime, inverseWindow);
+
+		std::vector<ColorRgb> expected(ledCount);
+		std::vector<ColorRgb> actual(ledCount);
+
+		interleaved.assemble(expected);
+		planar.assemble(actual);
+		check(equal(expected, actual), "assemble (linear decay)", ledCount, frame);
+
+		// Several output frames per interpolation to diffuse the residual errors
+		for (int output = 0; output < 3; ++output)
+		{
+			interleaved.assembleAndDither(expected);
+			planar.assembleAndDither(actual);
+			check(equal(expected, actual), "assembleAndDither (linear decay)", ledCount, frame);
+		}
+	}
+}
+
+// Rounding of all mean values on a grid of 2^-16 (including the half-integers and their neighbours) up to out of range values
+void testRounding()
+{
+	const size_t ledCount = 256;
+	InterleavedSmoothingKernels interleaved;
+	PlanarSmoothingKernels planar;
+	interleaved.resize(ledCount);
+	planar.resize(ledCount);
+	interleaved.resetWindowSums(ledCount);
+	planar.resetWindowSums(ledCount);
+
+	// mean = (oldestTime * 1 + 1 * led) / 2^16
+	const std::vector<ColorRgb> oldest(ledCount, ColorRgb(1, 1, 1));
+	std::vector<ColorRgb> newest(ledCount);
+	for (size_t i = 0; i < ledCount; ++i)
+	{
+		newest[i] = ColorRgb(static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i), static_cast<uint8_t>(i / 2));
+	}
+	const float inverseWindow = 1.0F / 65536;
+
+	std::vector<ColorRgb> expected(ledCount);
+	std::vector<ColorRgb> actual(ledCount);
+	for (uint64_t oldestTime = 0; oldestTime < (uint64_t(260) << 16); oldestTime += ledCount)
+	{
+		interleaved.averageWindow(oldest, oldestTime, newest, 1, inverseWindow);
+		planar.averageWindow(oldest, oldestTime, newest, 1, inverseWindow);
+
+		interleaved.assemble(expected);
+		planar.assemble(actual);
+		check(equal(expected, actual), "assemble (rounding)", ledCount, static_cast<int>(oldestTime));
+
+		interleaved.assembleAndDither(expected);
+		planar.assembleAndDither(actual);
+		check(equal(expected, actual), "assembleAndDither (rounding)", ledCount, static_cast<int>(oldestTime));
+	}
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937 generator(42);
+
+	for (size_t ledCount : {1, 3, 4, 7, 16, 150, 1001})
+	{
+		testWeightedDecay(generator, ledCount);
+		testLinearDecay(generator, ledCount);
+	}
+	testRounding();
+
+	// Bit-exact results of the interleaved and planar kernels
+	return TestHelper::result("SmoothingKernels");
+}